@@ -115,6 +115,20 @@ void Error_Handler(void);
 #define LOG_UART_RX_GPIO_Port GPIOB
 
 /* USER CODE BEGIN Private defines */
+/* MAX3010x INT pin (see USE_PULSE_IRQ). Not routed on LM.MBR.1, needs a wire to PC4 */
+#define PULSE_INT_Pin LL_GPIO_PIN_4
+#define PULSE_INT_GPIO_Port GPIOC
+#define PULSE_INT_EXTI_Port LL_SYSCFG_EXTI_PORTC
+#define PULSE_INT_EXTI_SysLine LL_SYSCFG_EXTI_LINE4
+#define PULSE_INT_EXTI_Line LL_EXTI_LINE_4
+#define PULSE_INT_EXTI_IRQn EXTI4_15_IRQn
+/* MPU6050 INT pin (see USE_POS_IRQ). Not routed on LM.MBR.1, needs a wire to PC5 */
+#define POS_INT_Pin LL_GPIO_PIN_5
+#define POS_INT_GPIO_Port GPIOC
+#define POS_INT_EXTI_Port LL_SYSCFG_EXTI_PORTC
+#define POS_INT_EXTI_SysLine LL_SYSCFG_EXTI_LINE5
+#define POS_INT_EXTI_Line LL_EXTI_LINE_5
+#define POS_INT_EXTI_IRQn EXTI4_15_IRQn
 
 /* USER CODE END Private defines */
 
@@ -135,4 +135,38 @@ void EXTI4_15_IRQHandler(void)
     trx_irq_handler(&device.trx);
   }
 
+#if USE_PULSE_IRQ
+  if (LL_EXTI_IsActiveFlag_0_31(PULSE_INT_EXTI_Line) != RESET)
+  {
+    LL_EXTI_ClearFlag_0_31(PULSE_INT_EXTI_Line);
+    /** Call handler for MAX3010x INT pin */
+    app_pulse_irq_handler(&device.app);
+  }
+#endif
+
+#if USE_POS_IRQ
+  if (LL_EXTI_IsActiveFlag_0_31(POS_INT_EXTI_Line) != RESET)
+  {
+    LL_EXTI_ClearFlag_0_31(POS_INT_EXTI_Line);
+    /** Call handler for MPU6050 INT pin */
+    app_pos_irq_handler(&device.app);
+  }
+#endif
+
+}
+
+/**
+  * @brief This function handles USART1 global interrupt / USART1 wake-up interrupt through EXTI line 25.
+  */
+void USART1_IRQHandler(void)
+{
+  bsp_uart_irq_handler(USART1);
+}
+
+/**
+  * @brief This function handles USART2 global interrupt / USART2 wake-up interrupt through EXTI line 26.
+  */
+void USART2_IRQHandler(void)
+{
+  bsp_uart_irq_handler(USART2);
 }
@@ -17,6 +17,9 @@ set(PROJECT_VER_HW   1)
 set(MCU              "STM32L073RBTX")
 set(CMAKE_C_STANDARD 17)
 
+# Black box capture of accelerometer & PPG around alerts (fits in 20KB RAM)
+set(BOARD_USE_CAPTURE 1)
+
 set(BOARD_DIR "${CMAKE_CURRENT_LIST_DIR}")
 
 ####################    COMPILER    ####################
@@ -51,6 +54,7 @@ project_add_define(
     "BSP_BTN_MAIN=0"
     "BSP_I2C_RECV_TIMEOUT=100"
     "BSP_SPI_RECV_TIMEOUT=100"
+    "BSP_UART_RX_BUFFER_SIZE=256"
 
     # SX1278
     "HAS_TRX_SX1278_SUPPORT=1"
@@ -47,6 +47,52 @@ static os_heap_t heap;
 /* Private functions ======================================================== */
 error_t console_init(vfs_t * vfs);
 
+#if USE_PULSE_IRQ
+/**
+ * Configure MAX3010x INT pin (open-drain, active low) as EXTI source
+ */
+static void init_pulse_irq(void) {
+  LL_EXTI_InitTypeDef exti = {0};
+
+  LL_SYSCFG_SetEXTISource(PULSE_INT_EXTI_Port, PULSE_INT_EXTI_SysLine);
+
+  LL_GPIO_SetPinPull(PULSE_INT_GPIO_Port, PULSE_INT_Pin, LL_GPIO_PULL_UP);
+  LL_GPIO_SetPinMode(PULSE_INT_GPIO_Port, PULSE_INT_Pin, LL_GPIO_MODE_INPUT);
+
+  exti.Line_0_31   = PULSE_INT_EXTI_Line;
+  exti.LineCommand = ENABLE;
+  exti.Mode        = LL_EXTI_MODE_IT;
+  exti.Trigger     = LL_EXTI_TRIGGER_FALLING;
+  LL_EXTI_Init(&exti);
+
+  NVIC_SetPriority(PULSE_INT_EXTI_IRQn, 0);
+  NVIC_EnableIRQ(PULSE_INT_EXTI_IRQn);
+}
+#endif
+
+#if USE_POS_IRQ
+/**
+ * Configure MPU6050 INT pin (open-drain, active low, latched) as EXTI source
+ */
+static void init_pos_irq(void) {
+  LL_EXTI_InitTypeDef exti = {0};
+
+  LL_SYSCFG_SetEXTISource(POS_INT_EXTI_Port, POS_INT_EXTI_SysLine);
+
+  LL_GPIO_SetPinPull(POS_INT_GPIO_Port, POS_INT_Pin, LL_GPIO_PULL_UP);
+  LL_GPIO_SetPinMode(POS_INT_GPIO_Port, POS_INT_Pin, LL_GPIO_MODE_INPUT);
+
+  exti.Line_0_31   = POS_INT_EXTI_Line;
+  exti.LineCommand = ENABLE;
+  exti.Mode        = LL_EXTI_MODE_IT;
+  exti.Trigger     = LL_EXTI_TRIGGER_FALLING;
+  LL_EXTI_Init(&exti);
+
+  NVIC_SetPriority(POS_INT_EXTI_IRQn, 0);
+  NVIC_EnableIRQ(POS_INT_EXTI_IRQn);
+}
+#endif
+
 /* Shared functions ========================================================= */
 void bsp_init(board_t * board) {
   HAL_MspInit();
@@ -93,6 +139,16 @@ void bsp_init(board_t * board) {
   // Initialize I2C
   i2c_init(&board->i2c_accel, &(i2c_cfg_t){ .i2c_no = 2 });
 
+#if USE_PULSE_IRQ
+  // Initialize MAX3010x INT pin
+  init_pulse_irq();
+#endif
+
+#if USE_POS_IRQ
+  // Initialize MPU6050 INT pin
+  init_pos_irq();
+#endif
+
   // Initialize RTC
   LL_RTC_DisableWriteProtection(RTC);
   LL_RTC_WAKEUP_SetClock(RTC, LL_RTC_WAKEUPCLOCK_DIV_2);
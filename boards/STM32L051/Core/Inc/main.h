@@ -102,6 +102,20 @@ void Error_Handler(void);
 #define BUTTON_GPIO_Port GPIOB
 
 /* USER CODE BEGIN Private defines */
+/* MAX3010x INT pin (see USE_PULSE_IRQ). Needs a wire to PA1 */
+#define PULSE_INT_Pin LL_GPIO_PIN_1
+#define PULSE_INT_GPIO_Port GPIOA
+#define PULSE_INT_EXTI_Port LL_SYSCFG_EXTI_PORTA
+#define PULSE_INT_EXTI_SysLine LL_SYSCFG_EXTI_LINE1
+#define PULSE_INT_EXTI_Line LL_EXTI_LINE_1
+#define PULSE_INT_EXTI_IRQn EXTI0_1_IRQn
+/* MPU6050 INT pin (see USE_POS_IRQ). Needs a wire to PA12 */
+#define POS_INT_Pin LL_GPIO_PIN_12
+#define POS_INT_GPIO_Port GPIOA
+#define POS_INT_EXTI_Port LL_SYSCFG_EXTI_PORTA
+#define POS_INT_EXTI_SysLine LL_SYSCFG_EXTI_LINE12
+#define POS_INT_EXTI_Line LL_EXTI_LINE_12
+#define POS_INT_EXTI_IRQn EXTI4_15_IRQn
 
 /* USER CODE END Private defines */
 
@@ -128,6 +128,27 @@ void EXTI0_1_IRQHandler(void) {
     /** Call handler for Ra-02 DIO0 pin */
     trx_irq_handler(&device.trx);
   }
+
+#if USE_PULSE_IRQ
+  if (LL_EXTI_IsActiveFlag_0_31(PULSE_INT_EXTI_Line) != RESET) {
+    LL_EXTI_ClearFlag_0_31(PULSE_INT_EXTI_Line);
+    /** Call handler for MAX3010x INT pin */
+    app_pulse_irq_handler(&device.app);
+  }
+#endif
+}
+
+/**
+ * @brief This function handles EXTI line 4 to 15 interrupts.
+ */
+void EXTI4_15_IRQHandler(void) {
+#if USE_POS_IRQ
+  if (LL_EXTI_IsActiveFlag_0_31(POS_INT_EXTI_Line) != RESET) {
+    LL_EXTI_ClearFlag_0_31(POS_INT_EXTI_Line);
+    /** Call handler for MPU6050 INT pin */
+    app_pos_irq_handler(&device.app);
+  }
+#endif
 }
 
 /**
@@ -140,3 +161,17 @@ void ADC1_COMP_IRQHandler(void) {}
  */
 void SPI1_IRQHandler(void) { }
 
+/**
+ * @brief This function handles USART1 global interrupt / USART1 wake-up interrupt through EXTI line 25.
+ */
+void USART1_IRQHandler(void) {
+  bsp_uart_irq_handler(USART1);
+}
+
+/**
+ * @brief This function handles USART2 global interrupt / USART2 wake-up interrupt through EXTI line 26.
+ */
+void USART2_IRQHandler(void) {
+  bsp_uart_irq_handler(USART2);
+}
+
@@ -17,6 +17,10 @@ set(PROJECT_VER_HW   0)
 set(MCU              "STM32L051C8T6")
 set(CMAKE_C_STANDARD 17)
 
+# Black box capture of accelerometer & PPG around alerts. Doesn't fit in 8KB
+# RAM next to pulse context & UART buffers
+set(BOARD_USE_CAPTURE 0)
+
 set(BOARD_DIR "${CMAKE_CURRENT_LIST_DIR}")
 
 ####################    COMPILER    ####################
@@ -51,6 +55,7 @@ project_add_define(
     "BSP_BTN_MAIN=0"
     "BSP_I2C_RECV_TIMEOUT=100"
     "BSP_SPI_RECV_TIMEOUT=100"
+    "BSP_UART_RX_BUFFER_SIZE=128"
 
     # SX1278
     "HAS_TRX_SX1278_SUPPORT=1"
@@ -18,6 +18,7 @@ extern "C" {
 #include "btn/btn.h"
 #include "i2c/i2c.h"
 #include "spi/spi.h"
+#include "hal/uart/uart.h"
 
 /* Defines ================================================================== */
 /* RA-02 GPIO Defines */
@@ -107,6 +108,32 @@ error_t bsp_adc_get_vbat(uint32_t * mv);
  */
 void bsp_print_stacktrace(uint32_t * sp, uint32_t depth);
 
+/**
+ * Returns contiguous span of received, but not yet consumed UART bytes (no
+ * copy). If data wraps around the RX ring, the rest is returned by the next
+ * peek, after the span is consumed
+ *
+ * @param uart UART handle
+ * @param data Set to the start of the span
+ * @return Span size (0 if nothing was received)
+ */
+size_t bsp_uart_rx_peek(uart_t * uart, const uint8_t ** data);
+
+/**
+ * Releases size bytes (from the start of the span) back to the RX ring
+ */
+void bsp_uart_rx_consume(uart_t * uart, size_t size);
+
+/**
+ * Returns number of RX overruns (hardware overrun or full RX ring) since boot
+ */
+uint32_t bsp_uart_rx_get_overruns(uart_t * uart);
+
+/**
+ * UART IRQ handler, moves received byte into the RX ring
+ */
+void bsp_uart_irq_handler(uart_t * uart);
+
 #ifdef __cplusplus
 }
 #endif
@@ -6,6 +6,10 @@
  *
  * @brief Port implementation of SDK UART HAL API
  *
+ * Reception is interrupt driven (RXNE), received bytes are put into a per
+ * USART lock-free SPSC ring (IRQ is the producer, uart_recv/bsp_uart_rx_*
+ * is the consumer), so nothing is lost while the app loop is busy
+ *
  *  ========================================================================= */
 
 /* Includes ================================================================= */
@@ -16,16 +20,74 @@
 #include "stm32l0xx_ll_rcc.h"
 #include "usart.h"
 #include "time/sleep.h"
+#include "bsp.h"
+#include <string.h>
 
 /* Defines ================================================================== */
 #define LOG_TAG hal_uart
 
+/** RX ring size (bytes), must be a power of 2 */
+#ifndef BSP_UART_RX_BUFFER_SIZE
+#define BSP_UART_RX_BUFFER_SIZE 256
+#endif
+
+#if BSP_UART_RX_BUFFER_SIZE & (BSP_UART_RX_BUFFER_SIZE - 1)
+#error "BSP_UART_RX_BUFFER_SIZE must be a power of 2"
+#endif
+
 /* Macros =================================================================== */
 /* Exposed macros =========================================================== */
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
+/**
+ * RX ring. Head & tail are free running, so full & empty are distinguishable
+ * without a wasted slot. Head is written only by IRQ, tail only by consumer
+ */
+typedef struct {
+  uint8_t           buffer[BSP_UART_RX_BUFFER_SIZE];
+  volatile uint16_t head;
+  volatile uint16_t tail;
+  volatile uint32_t overruns;
+} uart_rx_t;
+
 /* Variables ================================================================ */
+static uart_rx_t uart_rx[2];
+
 /* Private functions ======================================================== */
+static uart_rx_t * uart_get_rx(USART_TypeDef * handle) {
+  if (handle == USART1) {
+    return &uart_rx[0];
+  } else if (handle == USART2) {
+    return &uart_rx[1];
+  }
+
+  return NULL;
+}
+
+__STATIC_INLINE IRQn_Type uart_get_irq(USART_TypeDef * handle) {
+  return handle == USART1 ? USART1_IRQn : USART2_IRQn;
+}
+
+__STATIC_INLINE uint16_t uart_rx_count(uart_rx_t * rx) {
+  return (uint16_t) (rx->head - rx->tail);
+}
+
+/**
+ * Reset RX ring & enable RXNE (& ORE) interrupt
+ */
+static void uart_start_rx(USART_TypeDef * handle) {
+  uart_rx_t * rx = uart_get_rx(handle);
+
+  rx->head = 0;
+  rx->tail = 0;
+
+  LL_USART_ClearFlag_ORE(handle);
+  LL_USART_EnableIT_RXNE(handle);
+
+  NVIC_SetPriority(uart_get_irq(handle), 0);
+  NVIC_EnableIRQ(uart_get_irq(handle));
+}
+
 /* Shared functions ========================================================= */
 error_t uart_init(uart_t ** uart, uart_cfg_t * cfg) {
   ASSERT_RETURN(uart && cfg, E_NULL);
@@ -43,12 +105,16 @@ error_t uart_init(uart_t ** uart, uart_cfg_t * cfg) {
       return E_INVAL;
   }
 
+  uart_start_rx((USART_TypeDef *) *uart);
+
   return E_OK;
 }
 
 error_t uart_deinit(uart_t * uart) {
   ASSERT_RETURN(uart, E_NULL);
   USART_TypeDef * handle = (USART_TypeDef *) uart;
+  NVIC_DisableIRQ(uart_get_irq(handle));
+  LL_USART_DisableIT_RXNE(handle);
   LL_USART_DeInit(handle);
   return E_OK;
 }
@@ -86,13 +152,15 @@ error_t uart_reset(uart_t * uart) {
     return E_INVAL;
   }
 
+  uart_start_rx(handle);
+
   return E_OK;
 }
 
 bool uart_available(uart_t * uart) {
   ASSERT_RETURN(uart, E_NULL);
-  USART_TypeDef * handle = (USART_TypeDef *) uart;
-  return LL_USART_IsActiveFlag_RXNE(handle);
+  uart_rx_t * rx = uart_get_rx((USART_TypeDef *) uart);
+  return rx && uart_rx_count(rx);
 }
 
 error_t uart_send(uart_t * uart, const uint8_t * buf, size_t size) {
@@ -118,20 +186,90 @@ error_t uart_send(uart_t * uart, const uint8_t * buf, size_t size) {
 error_t uart_recv(uart_t * uart, uint8_t * buf, size_t size, timeout_t * timeout) {
   ASSERT_RETURN(uart && buf, E_NULL);
 
-  USART_TypeDef * handle = (USART_TypeDef *) uart;
+  size_t received = 0;
 
-  for (size_t i = 0; i < size; ++i) {
-    while (!LL_USART_IsActiveFlag_RXNE(handle)) {
+  while (received < size) {
+    const uint8_t * data  = NULL;
+    size_t          chunk = bsp_uart_rx_peek(uart, &data);
+
+    if (!chunk) {
       if (timeout && timeout_is_expired(timeout)) {
         return E_TIMEOUT;
       }
+
+      continue;
     }
 
-    buf[i] = LL_USART_ReceiveData8(handle);
-  }
+    chunk = chunk < size - received ? chunk : size - received;
 
-  LL_USART_ClearFlag_ORE(handle);
-  LL_USART_ClearFlag_RTO(handle);
+    memcpy(buf + received, data, chunk);
+    bsp_uart_rx_consume(uart, chunk);
+
+    received += chunk;
+  }
 
   return E_OK;
 }
+
+size_t bsp_uart_rx_peek(uart_t * uart, const uint8_t ** data) {
+  ASSERT_RETURN(uart && data, 0);
+
+  uart_rx_t * rx = uart_get_rx((USART_TypeDef *) uart);
+
+  ASSERT_RETURN(rx, 0);
+
+  uint16_t tail  = rx->tail % BSP_UART_RX_BUFFER_SIZE;
+  uint16_t count = uart_rx_count(rx);
+
+  *data = &rx->buffer[tail];
+
+  // Span ends at the end of buffer, the rest is returned by the next peek
+  return count < BSP_UART_RX_BUFFER_SIZE - tail ? count : BSP_UART_RX_BUFFER_SIZE - tail;
+}
+
+void bsp_uart_rx_consume(uart_t * uart, size_t size) {
+  uart_rx_t * rx = uart_get_rx((USART_TypeDef *) uart);
+
+  if (!rx) {
+    return;
+  }
+
+  uint16_t count = uart_rx_count(rx);
+
+  rx->tail += size < count ? size : count;
+}
+
+uint32_t bsp_uart_rx_get_overruns(uart_t * uart) {
+  uart_rx_t * rx = uart_get_rx((USART_TypeDef *) uart);
+  return rx ? rx->overruns : 0;
+}
+
+void bsp_uart_irq_handler(uart_t * uart) {
+  USART_TypeDef * handle = (USART_TypeDef *) uart;
+  uart_rx_t *     rx     = uart_get_rx(handle);
+
+  // Hardware overrun - byte(s) were lost before IRQ got to run
+  if (LL_USART_IsActiveFlag_ORE(handle)) {
+    LL_USART_ClearFlag_ORE(handle);
+    rx->overruns++;
+  }
+
+  if (!LL_USART_IsActiveFlag_RXNE(handle)) {
+    return;
+  }
+
+  uint8_t byte = LL_USART_ReceiveData8(handle);
+
+  // Ring is full - the newest byte is dropped, so consumer sees a gap, not garbage
+  if (uart_rx_count(rx) == BSP_UART_RX_BUFFER_SIZE) {
+    rx->overruns++;
+    return;
+  }
+
+  rx->buffer[rx->head % BSP_UART_RX_BUFFER_SIZE] = byte;
+
+  // Byte must be in buffer before consumer can see it
+  __DMB();
+
+  rx->head++;
+}
@@ -15,10 +15,15 @@
 #include "error/assertion.h"
 #include "led/led.h"
 #include "log/log.h"
+#include "util/endianness.h"
 
 /* Defines ================================================================== */
 #define LOG_TAG app
 
+#if USE_CAPTURE && CAPTURE_BLOCK_SIZE - 1 != NET_CAPTURE_DELTAS
+#error "Capture block doesn't match NET_CMD_CAPTURE payload"
+#endif
+
 /* Macros =================================================================== */
 /**
  * Check if __expr is E_OK, if not - set __flag into app->flags
@@ -52,19 +57,52 @@ __STATIC_INLINE void init_pulse(app_t * app, i2c_t * i2c) {
           .max30102 = MAX30102_PULSE_WIDTH_118_ADC_16_BIT,
         },
         .sample_rate = {
-          .max30100 = MAX30100_SAMPLE_RATE_100_HZ,
-          .max30102 = MAX30102_SAMPLE_RATE_100_HZ,
+          .max30100 = PULSE_MAX30100_SAMPLE_RATE,
+          .max30102 = PULSE_MAX30102_SAMPLE_RATE,
         },
         .current = {
-          .ir  = 50,
-          .red = 50
+          .ir  = PULSE_LED_CURRENT,
+          .red = PULSE_LED_CURRENT
         },
+        // SpO2 mode is set by max3010x_ext_set_spo2_mode
         .mode = MAX3010X_MODE_HEART_RATE
       }
     ),
     APP_FLAG_PULSE_SENSOR_FAILURE
   );
 
+  ERR_CHECK_SET_FLAG(
+    max3010x_ext_init(&app->pulse.ext, i2c),
+    APP_FLAG_PULSE_SENSOR_FAILURE
+  );
+
+#if USE_PULSE_SPO2
+  ERR_CHECK_SET_FLAG(
+    max3010x_ext_set_spo2_mode(&app->pulse.ext, true),
+    APP_FLAG_PULSE_SENSOR_FAILURE
+  );
+#endif
+
+  ERR_CHECK_SET_FLAG(
+    max3010x_ext_enable_fifo_irq(&app->pulse.ext, PULSE_FIFO_IRQ_THRESHOLD),
+    APP_FLAG_PULSE_SENSOR_FAILURE
+  );
+
+  ERR_CHECK_SET_FLAG(
+    max3010x_ext_set_sample_averaging(
+      &app->pulse.ext,
+      app->pulse.ext.part == MAX3010X_EXT_PART_MAX30102
+        ? PULSE_SAMPLE_AVERAGING
+        : PULSE_MAX30100_RATE_HZ / PULSE_SAMPLE_RATE_HZ
+    ),
+    APP_FLAG_PULSE_SENSOR_FAILURE
+  );
+
+  // INT might have been asserted before EXTI was configured, so drain once
+  app->pulse.irq_pending = true;
+
+  app->pulse.sleep.backoff = PULSE_PROBE_MIN_INTERVAL;
+
   ERR_CHECK_SET_FLAG(
     pulse_init(
       &app->pulse.ctx,
@@ -73,6 +111,34 @@ __STATIC_INLINE void init_pulse(app_t * app, i2c_t * i2c) {
     ),
     APP_FLAG_PULSE_SENSOR_FAILURE
   );
+
+#if USE_PULSE_SPO2
+  ERR_CHECK_SET_FLAG(
+    spo2_init(&app->pulse.spo2, max3010x_get_min_ir_adc_voltage(&app->pulse.max3010x)),
+    APP_FLAG_PULSE_SENSOR_FAILURE
+  );
+#endif
+
+#if USE_PULSE_AGC
+  bool is_max30102 = app->pulse.ext.part == MAX3010X_EXT_PART_MAX30102;
+
+  ERR_CHECK_SET_FLAG(
+    agc_init(
+      &app->pulse.agc,
+      &(agc_cfg_t){
+        // MAX30102 samples are 18 bit (left justified, for 16 bit resolution)
+        .full_scale  = is_max30102 ? (1 << 18) : (1 << 16),
+        .ranges      = is_max30102 ? MAX3010X_EXT_ADC_RANGES : 1,
+        .range       = 0, // MAX30102_ADC_RANGE_2K_nA
+        .current     = PULSE_LED_CURRENT,
+        .levels      = max3010x_ext_get_led_levels(&app->pulse.ext),
+        .level_count = MAX3010X_EXT_LED_LEVELS,
+        .red         = USE_PULSE_SPO2,
+      }
+    ),
+    APP_FLAG_PULSE_SENSOR_FAILURE
+  );
+#endif
 }
 
 __STATIC_INLINE void init_pos(app_t * app, i2c_t * i2c) {
@@ -88,6 +154,30 @@ __STATIC_INLINE void init_pos(app_t * app, i2c_t * i2c) {
     APP_FLAG_ACCEL_SENSOR_FAILURE
   );
 
+  ERR_CHECK_SET_FLAG(
+    mpu6050_ext_init(&app->pos.ext, i2c),
+    APP_FLAG_ACCEL_SENSOR_FAILURE
+  );
+
+  ERR_CHECK_SET_FLAG(
+    mpu6050_ext_enable_fifo(&app->pos.ext, POS_SAMPLE_RATE_HZ),
+    APP_FLAG_ACCEL_SENSOR_FAILURE
+  );
+
+#if USE_POS_IRQ
+  ERR_CHECK_SET_FLAG(
+    mpu6050_ext_enable_motion_irq(&app->pos.ext, POS_MOTION_THRESHOLD, POS_MOTION_DURATION),
+    APP_FLAG_ACCEL_SENSOR_FAILURE
+  );
+
+  // FIFO is already running, so path starts awake & falls asleep after hold period
+  app->pos.is_awake = true;
+  timeout_start(&app->pos.hold_timeout, POS_MOTION_HOLD_PERIOD);
+
+  // INT might have been asserted before EXTI was configured, so poll once
+  app->pos.irq_pending = true;
+#endif
+
   ERR_CHECK_SET_FLAG(
     acceleration_monitor_init(&app->pos.monitor),
     APP_FLAG_ACCEL_SENSOR_FAILURE
@@ -95,6 +185,8 @@ __STATIC_INLINE void init_pos(app_t * app, i2c_t * i2c) {
 }
 
 __STATIC_INLINE void init_gps(app_t * app, uint8_t uart_no) {
+  gps_init(&app->gps.parser);
+
   ERR_CHECK_SET_FLAG(
     uart_init(&app->gps.uart, &(uart_cfg_t){ .uart_no = uart_no }),
     APP_FLAG_GPS_FAILURE
@@ -104,8 +196,166 @@ __STATIC_INLINE void init_gps(app_t * app, uint8_t uart_no) {
     uart_set_baudrate(app->gps.uart, 9600),
     APP_FLAG_GPS_FAILURE
   );
+
+#if USE_GPS_UBX
+  ubx_init(&app->gps.ubx);
+
+  if (!app_get_flag(app, APP_FLAG_GPS_FAILURE) && ubx_configure(app->gps.uart) == E_OK) {
+    app->gps.is_ubx = true;
+    timeout_start(&app->gps.ubx_timeout, GPS_UBX_TIMEOUT);
+  }
+#endif
 }
 
+/**
+ * Power down pulse sensor, while there is no contact. Sensor is woken up
+ * periodically to probe for contact, with exponentially growing interval
+ */
+__STATIC_INLINE void pulse_sleep(app_t * app) {
+  if (max3010x_ext_set_shutdown(&app->pulse.ext, true) != E_OK) {
+    return;
+  }
+
+  log_debug("No contact, next probe in %u ms", app->pulse.sleep.backoff);
+
+  app->pulse.sleep.is_sleeping = true;
+  timeout_start(&app->pulse.sleep.timeout, app->pulse.sleep.backoff);
+
+#if USE_PULSE_MOTION_CANCELLER
+  // Sample index stands still, while sensor is shut down
+  app->pulse.anchor.is_valid = false;
+#endif
+
+#if USE_PULSE_IRQ
+  // Probe interval isn't a drain interval
+  app->pulse.irq_stats.last = 0;
+#endif
+
+  app->pulse.sleep.backoff <<= 1;
+  if (app->pulse.sleep.backoff > PULSE_PROBE_MAX_INTERVAL) {
+    app->pulse.sleep.backoff = PULSE_PROBE_MAX_INTERVAL;
+  }
+}
+
+#if USE_PULSE_AGC
+/**
+ * Adjust LED current (and ADC range), so DC level stays in AGC target window
+ */
+__STATIC_INLINE void pulse_agc(app_t * app, size_t size) {
+  if (agc_process_block(&app->pulse.agc, app->pulse.samples, size) != E_OK) {
+    return;
+  }
+
+  max3010x_ext_set_led_current(&app->pulse.ext, app->pulse.agc.ir.current, app->pulse.agc.red.current);
+
+  if (app->pulse.agc.ranges > 1) {
+    max3010x_ext_set_adc_range(&app->pulse.ext, app->pulse.agc.range);
+  }
+
+  // DC level jumps, so downstream filters start over from the new one
+  pulse_settle(&app->pulse.ctx, PULSE_AGC_SETTLE_MS / PULSE_SAMPLE_PERIOD_MS);
+
+#if USE_PULSE_SPO2
+  spo2_window_reset(&app->pulse.spo2);
+#endif
+}
+#endif
+
+/**
+ * Wake pulse sensor up, when probe interval is over
+ *
+ * @return true if sensor is sampling
+ */
+__STATIC_INLINE bool pulse_wakeup(app_t * app) {
+  if (!app->pulse.sleep.is_sleeping) {
+    return true;
+  }
+
+  if (!timeout_is_expired(&app->pulse.sleep.timeout) ||
+      max3010x_ext_set_shutdown(&app->pulse.ext, false) != E_OK) {
+    return false;
+  }
+
+  app->pulse.sleep.is_sleeping = false;
+  app->pulse.sleep.probe       = 0;
+
+  // Samples before shut down don't tell anything about contact now
+  pulse_reset_contact(&app->pulse.ctx);
+
+  return true;
+}
+
+#if USE_PULSE_IRQ
+/**
+ * Account FIFO drain, so actual drain interval can be checked against
+ * PULSE_FIFO_IRQ_THRESHOLD from the firmware
+ */
+__STATIC_INLINE void pulse_irq_stats_update(app_t * app) {
+  milliseconds_t now = runtime_get();
+
+  app->pulse.irq_stats.drains++;
+
+  if (app->pulse.irq_stats.last != 0) {
+    milliseconds_t interval = now - app->pulse.irq_stats.last;
+
+    app->pulse.irq_stats.interval = interval;
+
+    if (app->pulse.irq_stats.interval_min == 0 || interval < app->pulse.irq_stats.interval_min) {
+      app->pulse.irq_stats.interval_min = interval;
+    }
+
+    if (interval > app->pulse.irq_stats.interval_max) {
+      app->pulse.irq_stats.interval_max = interval;
+    }
+  }
+
+  app->pulse.irq_stats.last = now;
+}
+#endif
+
+#if USE_POS_IRQ
+/**
+ * Wake accelerometer path up on motion interrupt & put it to sleep, when
+ * there was no motion for POS_MOTION_HOLD_PERIOD. FIFO is suspended, while
+ * path is asleep, so nothing is read over I2C. FIFO is reset on wake-up, so
+ * the free fall, that woke the path, is lost - fall detector is armed for
+ * impact instead. Path stays awake, while a fall is being tracked
+ *
+ * @return true if path is awake
+ */
+__STATIC_INLINE bool pos_wakeup(app_t * app) {
+  if (app->pos.irq_pending) {
+    app->pos.irq_pending = false;
+
+    bool motion = false;
+
+    // Reading interrupt status also de-asserts INT pin
+    if (mpu6050_ext_poll_motion_irq(&app->pos.ext, &motion) == E_OK && motion) {
+      if (!app->pos.is_awake && mpu6050_ext_resume_fifo(&app->pos.ext) == E_OK) {
+        acceleration_monitor_resume(&app->pos.monitor);
+
+        app->pos.is_awake = true;
+        log_debug("Motion, accel woken up");
+      }
+
+      timeout_start(&app->pos.hold_timeout, POS_MOTION_HOLD_PERIOD);
+    }
+  }
+
+  // Lying prone is watched for stillness & a fall in progress needs its still
+  // phase, so path isn't put to sleep
+  if (app->pos.is_awake &&
+      timeout_is_expired(&app->pos.hold_timeout) &&
+      acceleration_monitor_get_posture(&app->pos.monitor) != POSTURE_PRONE &&
+      !acceleration_monitor_is_busy(&app->pos.monitor) &&
+      mpu6050_ext_suspend_fifo(&app->pos.ext) == E_OK) {
+    app->pos.is_awake = false;
+  }
+
+  return app->pos.is_awake;
+}
+#endif
+
 /* Shared functions ========================================================= */
 error_t app_init(app_t * app, app_cfg_t * cfg) {
   ASSERT_RETURN(app, E_NULL);
@@ -153,7 +403,11 @@ error_t app_init(app_t * app, app_cfg_t * cfg) {
   init_pos(app, cfg->accel_i2c);
   init_gps(app, cfg->gps_uart_no);
 
-  timeout_start(&app->status_send_timeout, NET_STATUS_SEND_PERIOD);
+#if USE_CAPTURE
+  capture_init(&app->capture.ctx);
+#endif
+
+  timeout_start(&app->status_send_timeout, app_get_status_period(app));
 
   return E_OK;
 }
@@ -175,9 +429,19 @@ error_t app_clear_flag(app_t * app, app_flags_t flag) {
 }
 
 bool app_get_flag(app_t * app, app_flags_t flag) {
- ASSERT_RETURN(app, false);
+  ASSERT_RETURN(app, false);
+
+  return (app->flags & flag) != 0;
+}
+
+uint32_t app_get_status_period(app_t * app) {
+  ASSERT_RETURN(app, NET_STATUS_SEND_PERIOD);
+
+  if (acceleration_monitor_get_activity(&app->pos.monitor) == ACTIVITY_REST) {
+    return STATUS_SEND_PERIOD_REST;
+  }
 
- return app->flags & flag > 0;
+  return NET_STATUS_SEND_PERIOD;
 }
 
 bool app_is_running(app_t * app) {
@@ -264,30 +528,95 @@ error_t app_pulse_process(app_t * app) {
     return E_FAILED;
   }
 
+  if (!pulse_wakeup(app)) {
+    return E_AGAIN;
+  }
+
+#if USE_PULSE_IRQ
+  if (!app->pulse.irq_pending) {
+    return E_AGAIN;
+  }
+
+  app->pulse.irq_pending = false;
+#endif
+
+  // Reading interrupt flags also de-asserts INT pin
   max3010x_poll_irq_flags(&app->pulse.max3010x);
 
   if (max3010x_process(&app->pulse.max3010x) == MAX3010X_STATUS_SAMPLES_READY) {
     led_off(app->led.pulse);
 
+#if USE_PULSE_IRQ
+    pulse_irq_stats_update(app);
+#endif
+
     size_t size = PULSE_SAMPLE_COUNT;
 
-    if (max3010x_read_samples(&app->pulse.max3010x, app->pulse.samples, &size) == E_OK) {
-      bool beat = false;
+    // Overflow counter is reset on FIFO read, so it has to be read first
+    uint8_t lost = 0;
+    max3010x_ext_get_overflow(&app->pulse.ext, &lost);
 
+    if (max3010x_ext_read_samples(&app->pulse.ext, app->pulse.samples, &size) == E_OK &&
+        max3010x_ext_average_samples(&app->pulse.ext, app->pulse.samples, &size) == E_OK) {
+      error_t err = pulse_process_block(&app->pulse.ctx, app->pulse.samples, size, NULL);
+
+#if USE_CAPTURE
       for (size_t i = 0; i < size; ++i) {
-        beat |= pulse_process_sample(&app->pulse.ctx, (int32_t) app->pulse.samples[i].ir) == E_OK;
+        capture_add_ppg(&app->capture.ctx, (int32_t) app->pulse.samples[i].ir);
+      }
+#endif
+
+      // Lost samples were the newest ones, so they go after processed block
+      pulse_skip_samples(&app->pulse.ctx, lost);
+
+#if USE_PULSE_MOTION_CANCELLER
+      // Newest sample in FIFO is at most a sample period old, when it's read
+      app->pulse.anchor.time     = runtime_get();
+      app->pulse.anchor.index    = app->pulse.ctx.sample_index - 1;
+      app->pulse.anchor.is_valid = true;
+#endif
+
+#if USE_PULSE_SPO2
+      spo2_process_block(&app->pulse.spo2, app->pulse.samples, size);
+#endif
+
+      if (app->pulse.sleep.probe < PULSE_NO_CONTACT_SAMPLES) {
+        app->pulse.sleep.probe += size;
+      }
+
+      // Contact is decided only after a full probe window since wake up
+      if (app->pulse.sleep.probe >= PULSE_NO_CONTACT_SAMPLES) {
+        if (pulse_has_contact(&app->pulse.ctx)) {
+          app->pulse.sleep.backoff = PULSE_PROBE_MIN_INTERVAL;
+
+#if USE_PULSE_AGC
+          pulse_agc(app, size);
+#endif
+        } else {
+          pulse_sleep(app);
+        }
       }
 
-      if (beat) {
+      if (err == E_OK) {
         led_on(app->led.pulse);
 
         if (app_is_running(app)) {
-          uint32_t bpm;
-          pulse_approximate_bpm(&app->pulse.ctx, &bpm);
+          uint32_t bpm = 0;
 
-          if (bpm < PULSE_MIN_ALERT_THRESHOLD || bpm > PULSE_MAX_ALERT_THRESHOLD) {
-            app_send_alert(app, NET_ALERT_TRIGGER_PULSE_THRESHOLD);
+          if (pulse_approximate_bpm(&app->pulse.ctx, &bpm) == E_OK &&
+              (bpm < PULSE_MIN_ALERT_THRESHOLD || bpm > PULSE_MAX_ALERT_THRESHOLD)) {
+            app_send_alert(app, NET_ALERT_TRIGGER_PULSE_THRESHOLD, 0);
           }
+
+#if USE_PULSE_RHYTHM
+          bool irregular = pulse_is_rhythm_irregular(&app->pulse.ctx);
+
+          if (irregular && !app->pulse.irregular) {
+            app_send_alert(app, NET_ALERT_TRIGGER_IRREGULAR_RHYTHM, 0);
+          }
+
+          app->pulse.irregular = irregular;
+#endif
         }
       }
     }
@@ -297,6 +626,14 @@ error_t app_pulse_process(app_t * app) {
   return E_AGAIN;
 }
 
+void app_pulse_irq_handler(app_t * app) {
+  app->pulse.irq_pending = true;
+
+#if USE_PULSE_IRQ
+  app->pulse.irq_stats.wakeups++;
+#endif
+}
+
 error_t app_pos_process(app_t * app) {
   ASSERT_RETURN(app, E_NULL);
 
@@ -304,34 +641,90 @@ error_t app_pos_process(app_t * app) {
     return E_FAILED;
   }
 
-  if (mpu6050_measure(&app->pos.mpu6050, &app->pos.sample) == E_OK) {
-    led_off(app->led.error);
-
-#if 0
-    log_printf("accel {x=%d y=%d z=%d}; gyro {x=%d y=%d z=%d}\r\n",
-      app->pos.sample.accel.x, app->pos.sample.accel.y, app->pos.sample.accel.z,
-      app->pos.sample.gyro.x,  app->pos.sample.gyro.y,  app->pos.sample.gyro.z
-    );
+#if USE_POS_IRQ
+  if (!pos_wakeup(app)) {
+    return E_AGAIN;
+  }
 #endif
 
-    acceleration_pos_t sample = {
-      .x = app->pos.sample.accel.x,
-      .y = app->pos.sample.accel.y,
-      .z = app->pos.sample.accel.z
-    };
+  // FIFO buffers samples in between, so there is no need to poll it on every pass
+  if (!timeout_is_expired(&app->pos.poll_timeout)) {
+    return E_AGAIN;
+  }
+
+  bool is_rest = acceleration_monitor_get_activity(&app->pos.monitor) == ACTIVITY_REST;
+  timeout_start(&app->pos.poll_timeout, is_rest ? POS_POLL_PERIOD_REST : POS_POLL_PERIOD);
+
+  size_t size = POS_SAMPLE_COUNT;
+  error_t err = mpu6050_ext_read_fifo(&app->pos.ext, app->pos.samples, &size);
 
-    acceleration_process_result_t res = acceleration_monitor_process_sample(&app->pos.monitor, &sample);
+  if (err == E_OVERFLOW) {
+    log_debug("Accel FIFO overflow");
+  }
+
+  if (err != E_OK || !size) {
+    return E_AGAIN;
+  }
 
-    if (res == ACCELERATION_RESULT_SUDDEN_MOVEMENT_DETECTED) {
-      led_on(app->led.error);
+  app->pos.count = size;
 
-      app_send_alert(app, NET_ALERT_TRIGGER_SUDDEN_MOVEMENT);
+  led_off(app->led.error);
+
+#if USE_PULSE_MOTION_CANCELLER
+  if (app->pulse.anchor.is_valid) {
+    // Newest sample is at most a sample period old, older ones are spaced by sample rate
+    milliseconds_t now = runtime_get();
+
+    for (size_t i = 0; i < size; ++i) {
+      acceleration_pos_t * sample = &app->pos.samples[i];
+
+      int32_t  age   = (int32_t) ((size - 1 - i) * 1000 / POS_SAMPLE_RATE_HZ);
+      int32_t  dt    = (int32_t) (now - app->pulse.anchor.time) - age;
+      uint32_t index = app->pulse.anchor.index + dt / PULSE_SAMPLE_PERIOD_MS;
+
+      // Sample, that maps before the last added one (read time jitter), is dropped
+      pulse_add_motion_reference(&app->pulse.ctx, index, sample->x, sample->y, sample->z);
     }
+  }
+#endif
 
-    return E_OK;
+#if USE_CAPTURE
+  for (size_t i = 0; i < size; ++i) {
+    acceleration_pos_t * sample = &app->pos.samples[i];
+    capture_add_accel(&app->capture.ctx, acceleration_magnitude(sample->x, sample->y, sample->z));
   }
+#endif
 
-  return E_AGAIN;
+  posture_class_t posture = acceleration_monitor_get_posture(&app->pos.monitor);
+
+  acceleration_process_result_t res = acceleration_monitor_process_block(&app->pos.monitor, app->pos.samples, size);
+
+  // Posture change is reported right away, with the next status
+  if (posture != acceleration_monitor_get_posture(&app->pos.monitor)) {
+    timeout_start(&app->status_send_timeout, 0);
+  }
+
+  if (res == ACCELERATION_RESULT_FALL_DETECTED) {
+    led_on(app->led.error);
+
+    uint32_t peak = acceleration_monitor_get_fall_peak(&app->pos.monitor);
+    app_send_alert(app, NET_ALERT_TRIGGER_FALL, peak > UINT8_MAX ? UINT8_MAX : peak);
+  }
+
+  uint32_t still = 0;
+  bool prone_still = acceleration_monitor_is_prone_still(&app->pos.monitor, &still);
+
+  if (prone_still && !app->pos.prone_still) {
+    app_send_alert(app, NET_ALERT_TRIGGER_PRONE_STILL, still > UINT8_MAX ? UINT8_MAX : still);
+  }
+
+  app->pos.prone_still = prone_still;
+
+  return E_OK;
+}
+
+void app_pos_irq_handler(app_t * app) {
+  app->pos.irq_pending = true;
 }
 
 error_t app_gps_process(app_t * app) {
@@ -341,42 +734,101 @@ error_t app_gps_process(app_t * app) {
     return E_FAILED;
   }
 
-  ASSERT_RETURN(uart_available(app->gps.uart), E_AGAIN);
+  uint32_t overruns = bsp_uart_rx_get_overruns(app->gps.uart);
 
-  TIMEOUT_CREATE(t, 0);
+  if (overruns != app->gps.overruns) {
+    log_warn("GPS UART overrun (%d total)", overruns);
+    app->gps.overruns = overruns;
+  }
 
-  uint8_t byte = 0;
-  if (uart_recv(app->gps.uart, &byte, 1, &t) != E_OK) {
-    return E_AGAIN;
+#if USE_GPS_UBX
+  if (app->gps.is_ubx) {
+    // Any valid frame (fix or not) proves receiver is still in UBX mode
+    if (app->gps.ubx.frames != app->gps.ubx_frames) {
+      app->gps.ubx_frames = app->gps.ubx.frames;
+      timeout_start(&app->gps.ubx_timeout, GPS_UBX_TIMEOUT);
+    } else if (timeout_is_expired(&app->gps.ubx_timeout)) {
+      log_warn("No UBX frames (%d acks, %d naks), falling back to NMEA", app->gps.ubx.acks, app->gps.ubx.naks);
+
+      app->gps.is_ubx = false;
+      gps_init(&app->gps.parser);
+      ERROR_CHECK_RETURN(ubx_restore_nmea(app->gps.uart));
+    }
   }
+#endif
 
-  if (byte == '\r') {
+  const uint8_t * data = NULL;
+  size_t          size = 0;
+
+  // Drain everything received since the last call span by span, up to a location
+  while ((size = bsp_uart_rx_peek(app->gps.uart, &data)) != 0) {
+#if USE_GPS_UBX
+    error_t err = app->gps.is_ubx ?
+                    ubx_parse(&app->gps.ubx, data, &size, &app->gps.last_location) :
+                    gps_parse(&app->gps.parser, data, &size, &app->gps.last_location);
+#else
+    error_t err = gps_parse(&app->gps.parser, data, &size, &app->gps.last_location);
+#endif
+
+    bsp_uart_rx_consume(app->gps.uart, size);
+
+    // The rest is left in RX ring for the next call, so location is sent right away
+    if (err == E_OK) {
+      ERROR_CHECK_RETURN(app_send_location(app));
+      return E_OK;
+    }
+  }
+
+  return E_AGAIN;
+}
+
+error_t app_capture_process(app_t * app) {
+  ASSERT_RETURN(app, E_NULL);
+
+#if USE_CAPTURE
+  capture_state_t state = capture_get_state(&app->capture.ctx);
+
+  if (state == CAPTURE_STATE_RECORDING) {
     return E_AGAIN;
   }
 
-  if (byte == '\n') {
-    app->gps.buffer[app->gps.index] = '\0';
-  } else {
-    app->gps.buffer[app->gps.index++] = byte;
+  // Timeout is post-trigger deadline first, then it paces upload
+  if ((state == CAPTURE_STATE_POST_TRIGGER || app->capture.is_uploading) &&
+      !timeout_is_expired(&app->capture.timeout)) {
     return E_AGAIN;
   }
 
-#if 0
-  // log_printf("[%d]: %s\r\n", app->gps.index, app->gps.buffer);
-  for (uint8_t i = 0; i < app->gps.index; ++i) {
-    log_printf("  %d: %d '%c'\r\n", i, app->gps.buffer[i], app->gps.buffer[i]);
+  if (state == CAPTURE_STATE_POST_TRIGGER) {
+    log_debug("Capture post-trigger timeout");
+    capture_finish(&app->capture.ctx);
   }
-#endif
 
-  error_t err = gps_parse(&app->gps.last_location, app->gps.buffer, app->gps.index);
+  app->capture.is_uploading = true;
+
+  // Channels without data are skipped
+  while (app->capture.index >= capture_get_block_count(&app->capture.ctx, app->capture.channel)) {
+    app->capture.index = 0;
+
+    if (++app->capture.channel >= CAPTURE_CHANNEL_COUNT) {
+      log_debug("Capture #%d uploaded", app->capture.id);
+
+      app->capture.is_uploading = false;
+      return capture_init(&app->capture.ctx);
+    }
+  }
 
-  app->gps.index = 0;
+  error_t err = app_send_capture(app);
 
   if (err == E_OK) {
-    ERROR_CHECK_RETURN(app_send_location(app));
+    app->capture.index++;
   }
 
+  timeout_start(&app->capture.timeout, CAPTURE_SEND_PERIOD);
+
   return err;
+#else
+  return E_NOTIMPL;
+#endif
 }
 
 error_t app_send_status(app_t * app) {
@@ -394,11 +846,43 @@ error_t app_send_status(app_t * app) {
   status.payload.status.reset_reason = app->reset_reason;
   status.payload.status.reset_count  = app->reset_count;
 
-  uint32_t bpm = 80;
+  // BPM is reported as 0, until approximation stabilizes
+  uint32_t bpm = 0;
   pulse_approximate_bpm(&app->pulse.ctx, &bpm);
   status.payload.status.bpm = (uint8_t) bpm;
 
-  status.payload.status.avg_bpm = PULSE_CALCULATE_BPM_TOTAL_AVG(app->pulse.ctx.total.beats, app->pulse.ctx.total.time);
+  uint32_t avg_bpm = 0;
+  pulse_get_avg_bpm(&app->pulse.ctx, &avg_bpm);
+  status.payload.status.avg_bpm = (uint8_t) avg_bpm;
+
+  // SpO2 is reported as 0, until first measurement window is complete
+  uint8_t spo2 = 0;
+#if USE_PULSE_SPO2
+  spo2_get(&app->pulse.spo2, &spo2);
+#endif
+  status.payload.status.spo2 = spo2;
+
+  // HRV is reported as 0, until there are enough beat intervals
+#if USE_PULSE_HRV
+  hrv_metrics_t hrv = {0};
+
+  if (pulse_get_hrv(&app->pulse.ctx, &hrv) == E_OK) {
+    status.payload.status.hrv.rmssd = hrv.rmssd < UINT8_MAX ? hrv.rmssd : UINT8_MAX;
+    status.payload.status.hrv.sdnn  = hrv.sdnn < UINT8_MAX ? hrv.sdnn : UINT8_MAX;
+    status.payload.status.hrv.pnn50 = hrv.pnn50;
+  }
+#endif
+
+  // Respiratory rate is reported as 0, until there are enough breaths
+#if USE_PULSE_RESP
+  uint32_t resp_rate = 0;
+  pulse_get_resp_rate(&app->pulse.ctx, &resp_rate);
+  status.payload.status.resp_rate = (uint8_t) resp_rate;
+#endif
+
+  // Activity is reported as unknown, until first classifier window is complete
+  status.payload.status.activity = (net_activity_t) acceleration_monitor_get_activity(&app->pos.monitor);
+  status.payload.status.posture  = (net_posture_t) acceleration_monitor_get_posture(&app->pos.monitor);
 
   int32_t temp = 20;
   // bsp_adc_get_temp(&temp);
@@ -416,6 +900,15 @@ error_t app_send_status(app_t * app) {
     status.payload.status.flags |= NET_STATUS_FLAG_GPS_FAILURE;
   }
 
+  uint32_t pi = 0;
+
+  if (app->pulse.sleep.is_sleeping || app->pulse.sleep.probe < PULSE_NO_CONTACT_SAMPLES ||
+      !pulse_has_contact(&app->pulse.ctx)) {
+    status.payload.status.flags |= NET_STATUS_FLAG_PULSE_NO_CONTACT;
+  } else if (pulse_get_perfusion_index(&app->pulse.ctx, &pi) == E_OK && pi < PULSE_MIN_PERFUSION_INDEX) {
+    status.payload.status.flags |= NET_STATUS_FLAG_PULSE_LOW_SIGNAL;
+  }
+
   return net_packet_send(&app->net, &status);
 }
 
@@ -439,7 +932,7 @@ error_t app_send_location(app_t * app) {
   return net_packet_send(&app->net, &location);
 }
 
-error_t app_send_alert(app_t * app, net_alert_trigger_t trigger) {
+error_t app_send_alert(app_t * app, net_alert_trigger_t trigger, uint8_t value) {
   ASSERT_RETURN(app, E_NULL);
 
   net_packet_t alert = {0};
@@ -451,6 +944,56 @@ error_t app_send_alert(app_t * app, net_alert_trigger_t trigger) {
   }));
 
   alert.payload.alert.trigger = trigger;
+  alert.payload.alert.value   = value;
+
+#if USE_CAPTURE
+  // Only the first alert is captured, until capture is uploaded
+  if (capture_trigger(&app->capture.ctx) == E_OK) {
+    app->capture.id++;
+    app->capture.trigger = trigger;
+    app->capture.channel = CAPTURE_CHANNEL_ACCEL;
+    app->capture.index   = 0;
+
+    app->capture.is_uploading = false;
+    timeout_start(&app->capture.timeout, CAPTURE_POST_TIMEOUT);
+  }
+#endif
 
   return net_packet_send(&app->net, &alert);
 }
+
+#if USE_CAPTURE
+error_t app_send_capture(app_t * app) {
+  ASSERT_RETURN(app, E_NULL);
+
+  capture_t *             capture = &app->capture.ctx;
+  capture_channel_t       channel = app->capture.channel;
+  const capture_block_t * block   = capture_get_block(capture, channel, app->capture.index);
+
+  ASSERT_RETURN(block, E_INVAL);
+
+  net_packet_t packet = {0};
+
+  ERROR_CHECK_RETURN(net_packet_init(&app->net, &packet, &(net_packet_cfg_t){
+    .cmd          = NET_CMD_CAPTURE,
+    .transport    = NET_TRANSPORT_TYPE_UNICAST,
+    .target.value = 0,
+  }));
+
+  uint32_t trigger = capture_get_trigger_frame(capture, channel);
+
+  packet.payload.capture.id            = app->capture.id;
+  packet.payload.capture.trigger       = app->capture.trigger;
+  packet.payload.capture.channel       = (net_capture_channel_t) channel;
+  packet.payload.capture.rate          = CAPTURE_RATE_HZ;
+  packet.payload.capture.index         = (uint8_t) app->capture.index;
+  packet.payload.capture.count         = (uint8_t) capture_get_block_count(capture, channel);
+  packet.payload.capture.trigger_frame = endian_to_big_u16(trigger > UINT16_MAX ? UINT16_MAX : trigger);
+  packet.payload.capture.base          = (int16_t) endian_to_big_u16((uint16_t) block->base);
+  packet.payload.capture.shift         = block->shift;
+
+  memcpy(packet.payload.capture.delta, block->delta, sizeof(block->delta));
+
+  return net_packet_send(&app->net, &packet);
+}
+#endif
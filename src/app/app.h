@@ -18,8 +18,14 @@ extern "C" {
 #include "mpu6050/mpu6050.h"
 #include "uart/uart.h"
 #include "sensors/accel/accel.h"
+#include "sensors/accel/mpu6050_ext.h"
 #include "sensors/pulse/pulse.h"
+#include "sensors/pulse/max3010x_ext.h"
+#include "sensors/pulse/spo2.h"
+#include "sensors/pulse/agc.h"
+#include "capture/capture.h"
 #include "gps/gps.h"
+#include "gps/ubx.h"
 #include "error/error.h"
 #include "storage/storage.h"
 #include "led/led.h"
@@ -27,10 +33,106 @@ extern "C" {
 #include <stdbool.h>
 
 /* Defines ================================================================== */
-#define PULSE_SAMPLE_COUNT        16
+#define PULSE_SAMPLE_COUNT        32
+#define PULSE_LED_CURRENT         50 // Initial LED current (mA), adjusted by AGC
+#define PULSE_AGC_SETTLE_MS       100 // Beat detection blanking after AGC change
+#define PULSE_FIFO_IRQ_THRESHOLD  30 // 300ms @ 100Hz (1.2s @ 25Hz), 2 samples of headroom for draining
 #define PULSE_MIN_ALERT_THRESHOLD 40
 #define PULSE_MAX_ALERT_THRESHOLD 180
 
+#if 60000 / PULSE_MAX_BEAT_TIME_DELTA >= PULSE_MIN_ALERT_THRESHOLD
+#error "Beat intervals of PULSE_MIN_ALERT_THRESHOLD BPM are rejected as too long, so low alert can't fire"
+#endif
+
+/**
+ * Number of averaged sensor samples per processed one (1, 2, 4 or 8).
+ * MAX30102 samples at PULSE_SAMPLE_RATE_HZ times it & averages in FIFO, so
+ * there is less to read over I2C. MAX30100 has no averaging & only runs at 50
+ * or 100Hz (with 1600us pulse width), so it samples at PULSE_SAMPLE_RATE_HZ
+ * & lower rates are averaged in software
+ */
+#ifndef PULSE_SAMPLE_AVERAGING
+#define PULSE_SAMPLE_AVERAGING 1
+#endif
+
+#define PULSE_MAX30102_RATE_HZ (PULSE_SAMPLE_RATE_HZ * PULSE_SAMPLE_AVERAGING)
+#define PULSE_MAX30100_RATE_HZ (PULSE_SAMPLE_RATE_HZ < 50 ? 50 : PULSE_SAMPLE_RATE_HZ)
+
+#if PULSE_MAX30102_RATE_HZ == 50
+#define PULSE_MAX30102_SAMPLE_RATE MAX30102_SAMPLE_RATE_50_HZ
+#elif PULSE_MAX30102_RATE_HZ == 100
+#define PULSE_MAX30102_SAMPLE_RATE MAX30102_SAMPLE_RATE_100_HZ
+#elif PULSE_MAX30102_RATE_HZ == 200
+#define PULSE_MAX30102_SAMPLE_RATE MAX30102_SAMPLE_RATE_200_HZ
+#elif PULSE_MAX30102_RATE_HZ == 400
+#define PULSE_MAX30102_SAMPLE_RATE MAX30102_SAMPLE_RATE_400_HZ
+#else
+#error "PULSE_SAMPLE_RATE_HZ * PULSE_SAMPLE_AVERAGING must be 50, 100, 200 or 400"
+#endif
+
+#if PULSE_MAX30100_RATE_HZ == 50
+#define PULSE_MAX30100_SAMPLE_RATE MAX30100_SAMPLE_RATE_50_HZ
+#elif PULSE_MAX30100_RATE_HZ == 100
+#define PULSE_MAX30100_SAMPLE_RATE MAX30100_SAMPLE_RATE_100_HZ
+#else
+#error "PULSE_SAMPLE_RATE_HZ must be 25, 50 or 100 for MAX30100"
+#endif
+
+/** Pulse sensor probe interval (ms), while there is no contact */
+#define PULSE_PROBE_MIN_INTERVAL  1000
+#define PULSE_PROBE_MAX_INTERVAL  32000
+
+/** Accelerometer FIFO sample rate (Hz) & poll period (ms) */
+#define POS_SAMPLE_RATE_HZ ACCELERATION_SAMPLE_RATE_HZ
+#define POS_POLL_PERIOD    100
+
+/** Max number of accelerometer samples read per poll, rest stays in FIFO */
+#define POS_SAMPLE_COUNT   16
+
+/**
+ * Poll period (ms), while wearer is at rest. It's as long as the sample
+ * buffer allows, so FIFO is read with fewer, longer bursts
+ */
+#define POS_POLL_PERIOD_REST ((POS_SAMPLE_COUNT - 1) * 1000 / POS_SAMPLE_RATE_HZ)
+
+#if POS_SAMPLE_COUNT * 1000 / POS_SAMPLE_RATE_HZ <= POS_POLL_PERIOD
+#error "POS_SAMPLE_COUNT must hold more samples, than arrive in POS_POLL_PERIOD"
+#endif
+
+/**
+ * Status send period (ms), while wearer is at rest. Vitals change slowly at
+ * rest, so status is sent less often
+ */
+#define STATUS_SEND_PERIOD_REST (NET_STATUS_SEND_PERIOD * 4)
+
+/**
+ * Wake-on-motion threshold (mg) & duration (ms), see USE_POS_IRQ. Threshold
+ * is the drop of gravity at fall detector's free fall threshold, spread over
+ * 3 axes (times 1/sqrt(3)), so a fall wakes accelerometer path up in any
+ * orientation. Fall detection itself still runs on FIFO samples - from the
+ * impact on, as FIFO is restarted on wake-up
+ */
+#define POS_MOTION_THRESHOLD ((1000 - FALL_FREE_FALL_THRESHOLD) * 577 / 1000)
+#define POS_MOTION_DURATION  1
+
+/** Time after last motion interrupt (ms), accelerometer path stays awake for */
+#define POS_MOTION_HOLD_PERIOD 2000
+
+/**
+ * Max time (ms) post-trigger window is recorded for, a channel may get no
+ * data (no contact, sensor failure). Captured blocks are uploaded one per
+ * CAPTURE_SEND_PERIOD (ms), so statuses & alerts go first
+ */
+#define CAPTURE_POST_TIMEOUT 10000
+#define CAPTURE_SEND_PERIOD  1000
+
+/**
+ * Time (ms) without a valid UBX frame, after which receiver is switched back
+ * to NMEA, see USE_GPS_UBX. Navigation message is sent even without a fix,
+ * so silence means configuration was lost (receiver reset, not powered yet)
+ */
+#define GPS_UBX_TIMEOUT (UBX_MEAS_PERIOD * UBX_NAV_RATE * 5)
+
 /* Macros =================================================================== */
 /* Enums ==================================================================== */
 /**
@@ -79,9 +181,19 @@ typedef struct {
     /** GPS (neo6m) uart context */
     uart_t * uart;
 
-    /** GPS message buffer & index */
-    char    buffer[128];
-    uint8_t index;
+    /** NMEA parser */
+    gps_t parser;
+
+#if USE_GPS_UBX
+    /** UBX parser, used while is_ubx is set (NMEA is the fallback) */
+    ubx_t     ubx;
+    bool      is_ubx;
+    uint32_t  ubx_frames;
+    timeout_t ubx_timeout;
+#endif
+
+    /** Last seen UART RX overrun count */
+    uint32_t overruns;
 
     /** Last known location */
     gps_location_t last_location;
@@ -91,23 +203,129 @@ typedef struct {
     /** MAX30100 Pulse sensor context */
     max3010x_t max3010x;
 
+    /** MAX30100 Register level extensions (FIFO overflow counter) */
+    max3010x_ext_t ext;
+
+    /** Set by MAX30100 INT pin handler, when FIFO has to be drained */
+    volatile bool irq_pending;
+
+#if USE_PULSE_IRQ
+    /** INT pin statistics, reported by 'pulse' command */
+    struct {
+      /** Number of INT pin interrupts (MCU wake ups) */
+      volatile uint32_t wakeups;
+
+      /** Number of FIFO drains */
+      uint32_t drains;
+
+      /** Time of the last drain (0 - none since sensor was woken up) */
+      milliseconds_t last;
+
+      /** Last, shortest & longest interval between FIFO drains */
+      milliseconds_t interval;
+      milliseconds_t interval_min;
+      milliseconds_t interval_max;
+    } irq_stats;
+#endif
+
     /** Buffer for MAX30100 Samples */
     max3010x_sample_t samples[PULSE_SAMPLE_COUNT];
 
     /** Pulse detector */
     pulse_t ctx;
+
+#if USE_PULSE_SPO2
+    /** SpO2 estimator */
+    spo2_t spo2;
+#endif
+
+#if USE_PULSE_AGC
+    /** LED current AGC */
+    agc_t agc;
+#endif
+
+#if USE_PULSE_RHYTHM
+    /** Irregular rhythm was already alerted (alert is sent once per episode) */
+    bool irregular;
+#endif
+
+#if USE_PULSE_MOTION_CANCELLER
+    /**
+     * Time of the last FIFO read & index of the newest sample read, so
+     * accelerometer samples can be stamped with PPG sample index
+     */
+    struct {
+      milliseconds_t time;
+      uint32_t       index;
+      bool           is_valid;
+    } anchor;
+#endif
+
+    /** No contact power-down context */
+    struct {
+      /** Sensor is shut down, until next probe */
+      bool is_sleeping;
+
+      /**
+       * Number of samples since sensor was woken up (stops at
+       * PULSE_NO_CONTACT_SAMPLES, when contact can be decided)
+       */
+      uint32_t probe;
+
+      /** Current probe interval (ms), doubled on each failed probe */
+      uint32_t backoff;
+
+      /** Timeout until next probe */
+      timeout_t timeout;
+    } sleep;
   } pulse;
 
   struct {
     /** MPU6050 Accelerometer/Gyroscope context */
     mpu6050_t mpu6050;
 
-    /** Buffer for MPU6050 Sample */
-    mpu6050_measurement_t sample;
+    /** MPU6050 FIFO extensions */
+    mpu6050_ext_t ext;
+
+    /** Buffer for accelerometer samples, read from FIFO */
+    acceleration_pos_t samples[POS_SAMPLE_COUNT];
+    size_t count;
+
+    /** Timeout until next FIFO poll */
+    timeout_t poll_timeout;
+
+    /** Motion interrupt is pending (set from EXTI IRQ) */
+    volatile bool irq_pending;
+
+    /** FIFO is running & processed, until hold timeout expires */
+    bool is_awake;
+    timeout_t hold_timeout;
 
     /** Acceleration monitor */
     acceleration_monitor_t monitor;
+
+    /** Prone still was already alerted (alert is sent once per episode) */
+    bool prone_still;
   } pos;
+
+#if USE_CAPTURE
+  struct {
+    /** Black box capture context */
+    capture_t ctx;
+
+    /** ID & trigger of current capture */
+    uint8_t             id;
+    net_alert_trigger_t trigger;
+
+    /** Next block to upload */
+    capture_channel_t channel;
+    uint32_t          index;
+
+    /** Post-trigger deadline, then upload pacing */
+    timeout_t timeout;
+    bool      is_uploading;
+  } capture;
+#endif
 } app_t;
 
 /**
@@ -171,6 +389,14 @@ error_t app_clear_flag(app_t * app, app_flags_t flag);
  */
 bool app_get_flag(app_t * app, app_flags_t flag);
 
+/**
+ * Get status send period, scaled by wearer activity
+ *
+ * @param app Application Context
+ * @return Period (ms)
+ */
+uint32_t app_get_status_period(app_t * app);
+
 /**
  * Returns true if application is running
  *
@@ -206,6 +432,13 @@ error_t app_register(app_t * app);
  */
 error_t app_pulse_process(app_t * app);
 
+/**
+ * MAX30100 INT pin (FIFO Almost Full) handler. Called from EXTI IRQ
+ *
+ * @param app Application Context
+ */
+void app_pulse_irq_handler(app_t * app);
+
 /**
  * Process MPU6050 Position/Acceleration sensor data
  *
@@ -214,12 +447,28 @@ error_t app_pulse_process(app_t * app);
 error_t app_pos_process(app_t * app);
 
 /**
- * Process NEO6M GPS location
+ * MPU6050 INT pin (Motion Detection) handler. Called from EXTI IRQ
+ *
+ * @param app Application Context
+ */
+void app_pos_irq_handler(app_t * app);
+
+/**
+ * Process NEO6M GPS location. Drains all bytes received since the last call
  *
  * @param app Application Context
+ * @return E_OK if location was updated (& sent), E_AGAIN otherwise
  */
 error_t app_gps_process(app_t * app);
 
+/**
+ * Finish & upload black box capture after an alert (low priority, a block
+ * per call at most)
+ *
+ * @param app Application Context
+ */
+error_t app_capture_process(app_t * app);
+
 /**
  * Send status
  *
@@ -238,8 +487,19 @@ error_t app_send_location(app_t * app);
  * Send alert
  *
  * @param app Application Context
+ * @param trigger Alert trigger
+ * @param value Trigger specific value (see net_alert_payload_t)
  */
-error_t app_send_alert(app_t * app, net_alert_trigger_t trigger);
+error_t app_send_alert(app_t * app, net_alert_trigger_t trigger, uint8_t value);
+
+#if USE_CAPTURE
+/**
+ * Send next block of black box capture (see app_capture_process)
+ *
+ * @param app Application Context
+ */
+error_t app_send_capture(app_t * app);
+#endif
 
 #ifdef __cplusplus
 }
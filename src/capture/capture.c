@@ -0,0 +1,226 @@
+/** ========================================================================= *
+ *
+ * @file capture.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "capture/capture.h"
+#include "sensors/accel/units.h"
+#include "sensors/pulse/sample_rate.h"
+#include "util/isqrt.h"
+#include "error/assertion.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+/** Decimation factors */
+#define CAPTURE_ACCEL_DECIMATION (ACCELERATION_SAMPLE_RATE_HZ / CAPTURE_RATE_HZ)
+#define CAPTURE_PPG_DECIMATION   (PULSE_SAMPLE_RATE_HZ / CAPTURE_RATE_HZ)
+
+#if ACCELERATION_SAMPLE_RATE_HZ % CAPTURE_RATE_HZ || PULSE_SAMPLE_RATE_HZ % CAPTURE_RATE_HZ
+#error "Sensor sample rates must be multiples of CAPTURE_RATE_HZ"
+#endif
+
+#if CAPTURE_BLOCK_SIZE < 2
+#error "CAPTURE_BLOCK_SIZE must hold at least one delta"
+#endif
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+__STATIC_INLINE int16_t capture_clamp_i16(int32_t value) {
+  return value > INT16_MAX ? INT16_MAX : value < INT16_MIN ? INT16_MIN : value;
+}
+
+/**
+ * Delta encode staged frames into a block. Shift is the smallest one, that
+ * fits the largest delta into 8 bits. Deltas are taken from reconstructed
+ * value, so rounding errors don't add up
+ */
+static void capture_encode(capture_ring_t * ring, capture_block_t * block) {
+  int16_t * frames = ring->frames;
+  int32_t   max    = 0;
+
+  for (uint32_t i = 1; i < CAPTURE_BLOCK_SIZE; ++i) {
+    int32_t delta = frames[i] - frames[i - 1];
+    delta = delta < 0 ? -delta : delta;
+    max   = delta > max ? delta : max;
+  }
+
+  uint8_t shift = 0;
+
+  while ((max >> shift) > INT8_MAX) {
+    shift++;
+  }
+
+  int32_t value = frames[0];
+
+  block->base  = frames[0];
+  block->shift = shift;
+
+  for (uint32_t i = 1; i < CAPTURE_BLOCK_SIZE; ++i) {
+    int32_t delta = (frames[i] - value + ((1 << shift) >> 1)) >> shift;
+
+    delta = delta > INT8_MAX ? INT8_MAX : delta < INT8_MIN ? INT8_MIN : delta;
+    value += delta << shift;
+
+    block->delta[i - 1] = (int8_t) delta;
+  }
+}
+
+static void capture_push(capture_t * capture, capture_ring_t * ring, int16_t frame) {
+  if (capture->state == CAPTURE_STATE_READY) {
+    return;
+  }
+
+  if (capture->state == CAPTURE_STATE_POST_TRIGGER) {
+    if (!ring->remaining) {
+      return;
+    }
+
+    ring->remaining--;
+  }
+
+  ring->total++;
+  ring->frames[ring->staged++] = frame;
+
+  if (ring->staged < CAPTURE_BLOCK_SIZE) {
+    return;
+  }
+
+  capture_encode(ring, &ring->blocks[ring->index]);
+
+  ring->index  = (ring->index + 1) % CAPTURE_BLOCKS;
+  ring->count += ring->count < CAPTURE_BLOCKS;
+  ring->staged = 0;
+}
+
+/* Shared functions ========================================================= */
+error_t capture_init(capture_t * capture) {
+  ASSERT_RETURN(capture, E_NULL);
+
+  memset(capture, 0, sizeof(capture_t));
+
+  return E_OK;
+}
+
+void capture_add_accel(capture_t * capture, uint32_t magnitude) {
+  capture_ring_t * ring = &capture->rings[CAPTURE_CHANNEL_ACCEL];
+
+  if (ring->acc < magnitude) {
+    ring->acc = magnitude;
+  }
+
+  if (++ring->phase < CAPTURE_ACCEL_DECIMATION) {
+    return;
+  }
+
+  int32_t frame = isqrt(ring->acc) >> CAPTURE_ACCEL_SHIFT;
+
+  ring->acc   = 0;
+  ring->phase = 0;
+
+  capture_push(capture, ring, capture_clamp_i16(frame));
+}
+
+void capture_add_ppg(capture_t * capture, int32_t value) {
+  capture_ring_t * ring = &capture->rings[CAPTURE_CHANNEL_PPG];
+
+  ring->acc += (uint32_t) value;
+
+  if (++ring->phase < CAPTURE_PPG_DECIMATION) {
+    return;
+  }
+
+  int32_t frame = (int32_t) (ring->acc / CAPTURE_PPG_DECIMATION);
+
+  ring->acc   = 0;
+  ring->phase = 0;
+
+  if (!capture->is_ppg_seeded) {
+    capture->ppg_dc        = frame << CAPTURE_PPG_DC_SHIFT;
+    capture->is_ppg_seeded = true;
+  }
+
+  capture->ppg_dc += frame - (capture->ppg_dc >> CAPTURE_PPG_DC_SHIFT);
+
+  capture_push(capture, ring, capture_clamp_i16(frame - (capture->ppg_dc >> CAPTURE_PPG_DC_SHIFT)));
+}
+
+error_t capture_trigger(capture_t * capture) {
+  ASSERT_RETURN(capture, E_NULL);
+
+  if (capture->state != CAPTURE_STATE_RECORDING) {
+    return E_BUSY;
+  }
+
+  // Block with the trigger is completed, then post-trigger blocks are recorded
+  for (uint32_t i = 0; i < CAPTURE_CHANNEL_COUNT; ++i) {
+    capture_ring_t * ring = &capture->rings[i];
+
+    ring->trigger   = ring->total;
+    ring->remaining = CAPTURE_BLOCK_SIZE - ring->staged + CAPTURE_POST_BLOCKS * CAPTURE_BLOCK_SIZE;
+  }
+
+  capture->state = CAPTURE_STATE_POST_TRIGGER;
+
+  return E_OK;
+}
+
+error_t capture_finish(capture_t * capture) {
+  ASSERT_RETURN(capture, E_NULL);
+
+  capture->state = CAPTURE_STATE_READY;
+
+  return E_OK;
+}
+
+capture_state_t capture_get_state(capture_t * capture) {
+  ASSERT_RETURN(capture, CAPTURE_STATE_RECORDING);
+
+  if (capture->state == CAPTURE_STATE_POST_TRIGGER) {
+    bool is_done = true;
+
+    for (uint32_t i = 0; i < CAPTURE_CHANNEL_COUNT; ++i) {
+      is_done = is_done && !capture->rings[i].remaining;
+    }
+
+    if (is_done) {
+      capture->state = CAPTURE_STATE_READY;
+    }
+  }
+
+  return capture->state;
+}
+
+uint32_t capture_get_block_count(capture_t * capture, capture_channel_t channel) {
+  ASSERT_RETURN(capture && channel < CAPTURE_CHANNEL_COUNT, 0);
+
+  return capture->rings[channel].count;
+}
+
+const capture_block_t * capture_get_block(capture_t * capture, capture_channel_t channel, uint32_t index) {
+  ASSERT_RETURN(capture && channel < CAPTURE_CHANNEL_COUNT, NULL);
+
+  capture_ring_t * ring = &capture->rings[channel];
+
+  ASSERT_RETURN(index < ring->count, NULL);
+
+  return &ring->blocks[(ring->index + CAPTURE_BLOCKS - ring->count + index) % CAPTURE_BLOCKS];
+}
+
+uint32_t capture_get_trigger_frame(capture_t * capture, capture_channel_t channel) {
+  ASSERT_RETURN(capture && channel < CAPTURE_CHANNEL_COUNT, 0);
+
+  capture_ring_t * ring = &capture->rings[channel];
+
+  // Staged frames aren't part of any block
+  uint32_t first = ring->total - ring->staged - ring->count * CAPTURE_BLOCK_SIZE;
+
+  return ring->trigger - first;
+}
@@ -0,0 +1,213 @@
+/** ========================================================================= *
+ *
+ * @file capture.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Black box capture of sensor data around an alert. Each channel
+ *        (acceleration magnitude, PPG) is decimated to CAPTURE_RATE_HZ & kept
+ *        in a RAM ring of delta encoded blocks. Capture is frozen on alert,
+ *        then a short post-trigger window is recorded, after which capture is
+ *        ready for upload. Channels are aligned by the trigger frame only, so a
+ *        channel with no data (e.g. no contact) just has fewer frames
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "error/error.h"
+#include "util/compiler.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/** Include capture into compilation */
+#ifndef USE_CAPTURE
+#define USE_CAPTURE 1
+#endif
+
+/** Rate of captured frames (Hz), all channels are decimated to it */
+#define CAPTURE_RATE_HZ 25
+
+/**
+ * Frames in a block. Block has an absolute first frame & 8-bit deltas, so it
+ * fits into a single network packet
+ */
+#define CAPTURE_BLOCK_SIZE 32
+
+/**
+ * Number of blocks kept before & recorded after the trigger. Block with the
+ * trigger is a pre-trigger one. ~7.7s before & ~2.6-3.8s after @ 25Hz
+ */
+#ifndef CAPTURE_PRE_BLOCKS
+#define CAPTURE_PRE_BLOCKS 6
+#endif
+
+#ifndef CAPTURE_POST_BLOCKS
+#define CAPTURE_POST_BLOCKS 3
+#endif
+
+#define CAPTURE_BLOCKS (CAPTURE_PRE_BLOCKS + CAPTURE_POST_BLOCKS)
+
+/**
+ * Acceleration magnitude resolution (raw units are shifted right by it),
+ * 1/32g @ 16g range
+ */
+#define CAPTURE_ACCEL_SHIFT 6
+
+/** PPG baseline (DC) removal (EMA, alpha = 1/2^SHIFT), ~1.3s @ 25Hz */
+#define CAPTURE_PPG_DC_SHIFT 5
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/**
+ * Captured channel
+ */
+typedef enum {
+  CAPTURE_CHANNEL_ACCEL = 0,
+  CAPTURE_CHANNEL_PPG,
+  CAPTURE_CHANNEL_COUNT,
+} capture_channel_t;
+
+/**
+ * Capture state
+ */
+typedef enum {
+  CAPTURE_STATE_RECORDING = 0,
+  CAPTURE_STATE_POST_TRIGGER,
+  CAPTURE_STATE_READY,
+} capture_state_t;
+
+/* Types ==================================================================== */
+/**
+ * Delta encoded block. Frame i is base + sum(delta[0..i-1] << shift)
+ */
+typedef __PACKED_STRUCT {
+  int16_t base;
+  uint8_t shift;
+  int8_t  delta[CAPTURE_BLOCK_SIZE - 1];
+} capture_block_t;
+
+/**
+ * Channel ring & decimator
+ */
+typedef struct {
+  capture_block_t blocks[CAPTURE_BLOCKS];
+
+  /** Next block to write & number of valid blocks */
+  uint32_t index;
+  uint32_t count;
+
+  /** Frames of a block, that isn't complete yet */
+  int16_t  frames[CAPTURE_BLOCK_SIZE];
+  uint32_t staged;
+
+  /** Frames pushed into channel (since reset), frame at trigger */
+  uint32_t total;
+  uint32_t trigger;
+
+  /** Frames left to record after trigger */
+  uint32_t remaining;
+
+  /** Decimator accumulator & number of samples in it */
+  uint32_t acc;
+  uint32_t phase;
+} capture_ring_t;
+
+/**
+ * Capture context
+ */
+typedef struct {
+  capture_state_t state;
+  capture_ring_t  rings[CAPTURE_CHANNEL_COUNT];
+
+  /** PPG baseline (scaled by 2^CAPTURE_PPG_DC_SHIFT) */
+  int32_t ppg_dc;
+  bool    is_ppg_seeded;
+} capture_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize (reset) capture & start recording
+ *
+ * @param capture Capture context
+ */
+error_t capture_init(capture_t * capture);
+
+/**
+ * Add accelerometer sample (ACCELERATION_SAMPLE_RATE_HZ). Peak magnitude is
+ * kept on decimation, so impacts aren't smoothed out
+ *
+ * @param capture Capture context
+ * @param magnitude Squared vector magnitude (raw units)
+ */
+void capture_add_accel(capture_t * capture, uint32_t magnitude);
+
+/**
+ * Add PPG sample (PULSE_SAMPLE_RATE_HZ). Samples are averaged on decimation &
+ * baseline is removed
+ *
+ * @param capture Capture context
+ * @param value Raw IR ADC value
+ */
+void capture_add_ppg(capture_t * capture, int32_t value);
+
+/**
+ * Freeze pre-trigger window & start recording post-trigger one. Ignored,
+ * unless capture is recording (the first alert is kept)
+ *
+ * @param capture Capture context
+ * @return E_OK if capture was frozen, E_BUSY if it already was
+ */
+error_t capture_trigger(capture_t * capture);
+
+/**
+ * Finish post-trigger window early (e.g. a channel gets no data). Incomplete
+ * blocks are dropped
+ *
+ * @param capture Capture context
+ */
+error_t capture_finish(capture_t * capture);
+
+/**
+ * Get capture state
+ *
+ * @param capture Capture context
+ */
+capture_state_t capture_get_state(capture_t * capture);
+
+/**
+ * Get number of captured blocks of a channel
+ *
+ * @param capture Capture context
+ * @param channel Channel
+ */
+uint32_t capture_get_block_count(capture_t * capture, capture_channel_t channel);
+
+/**
+ * Get captured block of a channel, oldest first
+ *
+ * @param capture Capture context
+ * @param channel Channel
+ * @param index Block index (0 - oldest)
+ */
+const capture_block_t * capture_get_block(capture_t * capture, capture_channel_t channel, uint32_t index);
+
+/**
+ * Get index of trigger frame of a channel, counted from the first frame of
+ * the oldest block. It's past the last frame, if there was no data after the
+ * trigger
+ *
+ * @param capture Capture context
+ * @param channel Channel
+ */
+uint32_t capture_get_trigger_frame(capture_t * capture, capture_channel_t channel);
+
+#ifdef __cplusplus
+}
+#endif
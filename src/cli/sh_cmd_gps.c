@@ -15,19 +15,219 @@
 #include "tty/ansi.h"
 #include "log/log.h"
 #include "gps/gps.h"
+#include "gps/ubx.h"
+#include "util/util.h"
 #include "project.h"
+#include <string.h>
 
 /* Defines ================================================================== */
 #define LOG_TAG shell
 
+/** Number of navigation epochs (1 fix each) */
+#define BENCH_ROUNDS 100
+
 /* Macros =================================================================== */
 /* Exposed macros =========================================================== */
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
 /* Variables ================================================================ */
+#if USE_GPS_BENCH
+/** One second of NEO-6M default output (with a fix) */
+static const char * const bench_sentences[] = {
+  "$GPRMC,123519.00,A,4807.03812,N,01131.00012,E,0.004,,230394,,,A*74\r\n",
+  "$GPVTG,,T,,M,0.004,N,0.008,K,A*2F\r\n",
+  "$GPGGA,123519.00,4807.03812,N,01131.00012,E,1,08,0.9,545.4,M,46.9,M,,*69\r\n",
+  "$GPGSA,A,3,04,05,09,12,24,25,29,,,,,,1.8,0.9,1.5*37\r\n",
+  "$GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00*74\r\n",
+  "$GPGSV,3,2,11,14,25,170,00,16,57,208,39,18,67,296,40,19,40,246,00*74\r\n",
+  "$GPGSV,3,3,11,22,42,067,42,24,14,311,43,27,05,244,00*4D\r\n",
+  "$GPGLL,4807.03812,N,01131.00012,E,123519.00,A,A*66\r\n",
+};
+
+/** Contexts are static, so they don't end up on shell task stack */
+static gps_t   bench_parser;
+static ubx_t   bench_ubx;
+static char    bench_buffer[128];
+static uint8_t bench_frame[UBX_HEADER_SIZE + UBX_PAYLOAD_MAX + UBX_CRC_SIZE];
+#endif
+
 /* Private functions ======================================================== */
+#if USE_GPS_BENCH
+/**
+ * Get number of CPU cycles since start. SysTick runs from HCLK, so it's used
+ * as a cycle counter, measured interval has to be shorter than SysTick period
+ *
+ * @param start SysTick value at start
+ */
+__STATIC_INLINE uint32_t bench_cycles(uint32_t start) {
+  uint32_t end = SysTick->VAL;
+
+  // SysTick counts down & reloads from LOAD
+  return start >= end ? start - end : start + SysTick->LOAD + 1 - end;
+}
+
+/**
+ * Previous parser (line buffer, tokenize, strstr, strcpy), kept as a baseline
+ */
+static error_t bench_parse_legacy(gps_location_t * location, char * buffer, size_t size) {
+  char * tokens[20];
+  size_t count = 0;
+  char * start = buffer;
+
+  for (size_t i = 0; i < size && count < 20; ++i) {
+    if (buffer[i] == ',' || buffer[i] == '*') {
+      tokens[count++] = start;
+
+      bool is_checksum = buffer[i] == '*';
+
+      buffer[i] = '\0';
+      start     = &buffer[i + 1];
+
+      if (is_checksum) {
+        break;
+      }
+    }
+  }
+
+  if (!count || tokens[0][0] != '$') {
+    return E_INVAL;
+  }
+
+  if (strstr(tokens[0], "GLL") != NULL && count > 6) {
+    strcpy(location->latitude.value, tokens[1]);
+    location->latitude.direction = tokens[2][0];
+    strcpy(location->longitude.value, tokens[3]);
+    location->longitude.direction = tokens[4][0];
+
+    return tokens[6][0] == 'A' ? E_OK : E_INVAL;
+  }
+
+  if (strstr(tokens[0], "RMC") != NULL && count > 6) {
+    strcpy(location->latitude.value, tokens[3]);
+    location->latitude.direction = tokens[4][0];
+    strcpy(location->longitude.value, tokens[5]);
+    location->longitude.direction = tokens[6][0];
+
+    return tokens[2][0] == 'A' ? E_OK : E_INVAL;
+  }
+
+  return E_INVAL;
+}
+
+/**
+ * Build one epoch of UBX output (the same position as bench sentences)
+ *
+ * @return Frame size
+ */
+static size_t bench_build_frame(void) {
+  uint8_t payload[UBX_PAYLOAD_MAX] = {0};
+  int32_t lat                      = 481173020;
+  int32_t lon                      = 115166687;
+
+#if UBX_NAV_MSG == UBX_NAV_PVT
+  payload[20] = 3;
+  payload[21] = 1;
+  memcpy(&payload[24], &lon, sizeof(lon));
+  memcpy(&payload[28], &lat, sizeof(lat));
+#else
+  uint32_t hacc = 2500;
+
+  memcpy(&payload[4], &lon, sizeof(lon));
+  memcpy(&payload[8], &lat, sizeof(lat));
+  memcpy(&payload[20], &hacc, sizeof(hacc));
+#endif
+
+  return ubx_frame(bench_frame, UBX_NAV_MSG, payload, sizeof(payload));
+}
+
+/**
+ * Run previous NMEA, current NMEA & UBX parser on one second of receiver
+ * output per epoch & report UART bytes and CPU cycles per fix
+ *
+ * @param sh Shell
+ */
+static int8_t cmd_gps_bench(shell_t * sh) {
+  gps_location_t location = {0};
+
+  uint64_t cycles[3] = {0};
+  uint32_t fixes[3]  = {0};
+  uint32_t bytes[3]  = {0};
+
+  gps_init(&bench_parser);
+  ubx_init(&bench_ubx);
+
+  size_t frame_size = bench_build_frame();
+
+  for (uint32_t round = 0; round < BENCH_ROUNDS; ++round) {
+    for (size_t i = 0; i < UTIL_ARR_SIZE(bench_sentences); ++i) {
+      const char * sentence = bench_sentences[i];
+      size_t       size     = strlen(sentence);
+
+      bytes[0] += size;
+      bytes[1] += size;
+
+      // Previous parser got sentence byte by byte into a line buffer
+      uint32_t start = SysTick->VAL;
+      size_t   index = 0;
+
+      for (size_t j = 0; j < size; ++j) {
+        if (sentence[j] == '\r') {
+          continue;
+        }
+
+        if (sentence[j] != '\n') {
+          bench_buffer[index++] = sentence[j];
+          continue;
+        }
+
+        bench_buffer[index] = '\0';
+        fixes[0] += bench_parse_legacy(&location, bench_buffer, index) == E_OK;
+        index = 0;
+      }
+
+      cycles[0] += bench_cycles(start);
+
+      start = SysTick->VAL;
+      fixes[1] += gps_parse(&bench_parser, (const uint8_t *) sentence, &size, &location) == E_OK;
+      cycles[1] += bench_cycles(start);
+    }
+
+    // UBX receiver sends a single navigation message per epoch
+    size_t   size  = frame_size;
+    uint32_t start = SysTick->VAL;
+
+    fixes[2] += ubx_parse(&bench_ubx, bench_frame, &size, &location) == E_OK;
+    cycles[2] += bench_cycles(start);
+    bytes[2] += frame_size;
+  }
+
+  // NMEA epoch has 3 position sentences, but only one fix per epoch is used
+  log_info("legacy bytes/fix=%u cycles/fix=%u fixes=%u",
+    bytes[0] / BENCH_ROUNDS, (uint32_t) (cycles[0] / BENCH_ROUNDS), fixes[0]
+  );
+  log_info("nmea   bytes/fix=%u cycles/fix=%u fixes=%u checksum errors=%u",
+    bytes[1] / BENCH_ROUNDS, (uint32_t) (cycles[1] / BENCH_ROUNDS), fixes[1], bench_parser.checksum_errors
+  );
+  log_info("ubx    bytes/fix=%u cycles/fix=%u fixes=%u checksum errors=%u",
+    bytes[2] / BENCH_ROUNDS, (uint32_t) (cycles[2] / BENCH_ROUNDS), fixes[2], bench_ubx.checksum_errors
+  );
+
+  return SHELL_OK;
+}
+#endif
+
 /* Shared functions ========================================================= */
 static int8_t cmd_gps(shell_t * sh, uint8_t argc, const char ** argv) {
+#if USE_GPS_BENCH
+  if (argc > 1 && !strcmp(argv[1], "bench")) {
+    return cmd_gps_bench(sh);
+  }
+#endif
+
+#if USE_GPS_UBX
+  log_info("Receiver is in %s mode", device.app.gps.is_ubx ? "UBX" : "NMEA");
+#endif
+
   log_info("Sniffing NEO6M uart traffic. Press any key to stop...");
 
   while (1) {
@@ -43,10 +43,13 @@ static int8_t cmd_pos(shell_t * sh, uint8_t argc, const char ** argv) {
 
     error_t err = app_pos_process(&device.app);
 
-    if (err == E_OK || err == E_EMPTY) {
-      log_printf("accel {x=%d y=%d z=%d}; gyro {x=%d y=%d z=%d}\r\n",
-        device.app.pos.sample.accel.x, device.app.pos.sample.accel.y, device.app.pos.sample.accel.z,
-        device.app.pos.sample.gyro.x,  device.app.pos.sample.gyro.y,  device.app.pos.sample.gyro.z
+    if (err == E_OK) {
+      acceleration_pos_t * sample = &device.app.pos.samples[device.app.pos.count - 1];
+
+      log_printf("accel {x=%d y=%d z=%d}; %u samples; %s, %s\r\n",
+        sample->x, sample->y, sample->z, (unsigned) device.app.pos.count,
+        activity_to_str(acceleration_monitor_get_activity(&device.app.pos.monitor)),
+        posture_to_str(acceleration_monitor_get_posture(&device.app.pos.monitor))
       );
     }
 
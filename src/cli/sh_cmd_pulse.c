@@ -13,9 +13,13 @@
 #include "shell/shell_util.h"
 #include "shell/shell.h"
 #include "sensors/pulse/pulse.h"
+#include "sensors/pulse/pulse_engine.h"
+#include "sensors/pulse/spo2.h"
 #include "tty/ansi.h"
 #include "log/log.h"
+#include "util/util.h"
 #include "project.h"
+#include <string.h>
 
 /* Defines ================================================================== */
 #define LOG_TAG shell
@@ -23,14 +27,368 @@
 #define SAMPLES_COUNT 16
 #define CURRENT       50
 
+/** LED pulse width (us), as configured in init_pulse */
+#define MAX30100_PULSE_WIDTH_US 1600
+#define MAX30102_PULSE_WIDTH_US 118
+
+/** Number of engines, that are compared by 'pulse bench' */
+#define BENCH_ENGINES 2
+
+/**
+ * Filter bench ('pulse bench filters') input size & number of passes over it.
+ * Samples are timed in blocks, so measured interval is shorter than SysTick
+ * period (even for slowest filters)
+ */
+#define BENCH_FILTER_INPUT  64
+#define BENCH_FILTER_ROUNDS 64
+#define BENCH_FILTER_BLOCK  8
+
+/** Previous (O(N) per sample) Weighted Moving Average window */
+#define BENCH_WMA_LEGACY_SIZE 32
+
+/** Previous (modulo indexed) Gauss filter window, it only worked with 5 taps */
+#define BENCH_GAUSS_LEGACY_SIZE 5
+
+/** Largest Gauss kernel preset */
+#define BENCH_GAUSS_MAX_SIZE 9
+
+/** Gravity (raw, 16G range) for Motion Canceller bench reference */
+#define BENCH_MC_GRAVITY 2048
+
+/** Synthetic raw IR & red DC levels for SpO2 bench */
+#define BENCH_SPO2_IR_DC  30000
+#define BENCH_SPO2_RED_DC 20000
+
 /* Macros =================================================================== */
 /* Exposed macros =========================================================== */
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
+#if USE_PULSE_BENCH
+/**
+ * Filter, that is timed by 'pulse bench filters'
+ */
+typedef struct {
+  const char * name;
+
+  /**
+   * Process single sample
+   *
+   * @param pulse Pulse Detector Context (used by current implementations)
+   * @param value Filter input
+   */
+  int32_t (*process)(pulse_t * pulse, int32_t value);
+} bench_filter_t;
+#endif
+
 /* Variables ================================================================ */
+#if USE_PULSE_BENCH
+/** Engines, that are compared on the same samples */
+static const pulse_engine_t * const bench_engines[BENCH_ENGINES] = {
+  &pulse_engine_peak,
+  &pulse_engine_acf,
+};
+
+/** Contexts are static, so they don't end up on shell task stack */
+static pulse_t bench_ctx[BENCH_ENGINES];
+
+/** Synthetic filter bench input (DC filtered PPG range) */
+static int16_t bench_input[BENCH_FILTER_INPUT];
+
+/** Previous Weighted Moving Average (weights are recomputed for every sample) */
+static struct {
+  int32_t  buffer[BENCH_WMA_LEGACY_SIZE];
+  uint32_t index;
+  int32_t  weights[BENCH_WMA_LEGACY_SIZE];
+  int32_t  weights_sum;
+} bench_wma_legacy;
+
+/** Previous Gauss filter */
+static struct {
+  int32_t buffer[BENCH_GAUSS_LEGACY_SIZE];
+  int32_t index;
+} bench_gauss_legacy;
+
+/** Gauss filter (window is stored twice), shared by all presets */
+static struct {
+  int32_t  buffer[BENCH_GAUSS_MAX_SIZE * 2];
+  uint32_t index;
+} bench_gauss;
+
+static const int32_t bench_gauss5_kernel[5] = PULSE_GAUSS_5_COEFFICIENTS;
+static const int32_t bench_gauss7_kernel[7] = PULSE_GAUSS_7_COEFFICIENTS;
+static const int32_t bench_gauss9_kernel[9] = PULSE_GAUSS_9_COEFFICIENTS;
+
+#if USE_PULSE_SPO2
+static spo2_t bench_spo2;
+#endif
+#endif
+
 /* Private functions ======================================================== */
+#if USE_PULSE_BENCH
+/**
+ * Get number of CPU cycles since start. SysTick runs from HCLK, so it's used
+ * as a cycle counter, measured interval has to be shorter than SysTick period
+ *
+ * @param start SysTick value at start
+ */
+__STATIC_INLINE uint32_t bench_cycles(uint32_t start) {
+  uint32_t end = SysTick->VAL;
+
+  // SysTick counts down & reloads from LOAD
+  return start >= end ? start - end : start + SysTick->LOAD + 1 - end;
+}
+
+/**
+ * Previous Weighted Moving Average, kept as a baseline
+ */
+static int32_t bench_wma_legacy_process(pulse_t * pulse, int32_t value) {
+  bench_wma_legacy.buffer[bench_wma_legacy.index] = value;
+  bench_wma_legacy.index = (bench_wma_legacy.index + 1) % BENCH_WMA_LEGACY_SIZE;
+
+  int32_t wma = 0;
+  int32_t wma_index = bench_wma_legacy.index;
+
+  for (uint32_t i = 0; i < BENCH_WMA_LEGACY_SIZE; ++i) {
+    wma += bench_wma_legacy.buffer[wma_index] * bench_wma_legacy.weights[i];
+    wma_index = (wma_index + 1) % BENCH_WMA_LEGACY_SIZE;
+  }
+
+  return wma / bench_wma_legacy.weights_sum;
+}
+
+/**
+ * Previous Gauss filter (5 taps), kept as a baseline
+ */
+static int32_t bench_gauss_legacy_process(pulse_t * pulse, int32_t value) {
+  static const int32_t kernel[BENCH_GAUSS_LEGACY_SIZE] = PULSE_GAUSS_5_COEFFICIENTS;
+
+  int32_t acc = 0;
+  int32_t idx = 0;
+
+  bench_gauss_legacy.buffer[bench_gauss_legacy.index] = value;
+
+  for (int32_t i = -2; i <= 2; ++i) {
+    uint32_t buf_idx = (bench_gauss_legacy.index + i + BENCH_GAUSS_LEGACY_SIZE) % BENCH_GAUSS_LEGACY_SIZE;
+    acc += bench_gauss_legacy.buffer[buf_idx] * kernel[idx++];
+  }
+
+  bench_gauss_legacy.index = (bench_gauss_legacy.index + 1) % BENCH_GAUSS_LEGACY_SIZE;
+
+  return acc / PULSE_GAUSS_5_FACTOR;
+}
+
+/**
+ * Gauss filter, as implemented by peak engine. Size & factor are constant
+ * at every call site, so it's specialized the same way as in the engine
+ */
+__STATIC_INLINE int32_t bench_gauss_process(const int32_t * kernel, uint32_t size, uint32_t factor, int32_t value) {
+  const int32_t * window = pulse_fir_push(bench_gauss.buffer, &bench_gauss.index, size, value);
+
+  return pulse_fir_symmetric(kernel, window, size) >> __builtin_ctz(factor);
+}
+
+static int32_t bench_gauss5_process(pulse_t * pulse, int32_t value) {
+  return bench_gauss_process(bench_gauss5_kernel, 5, PULSE_GAUSS_5_FACTOR, value);
+}
+
+static int32_t bench_gauss7_process(pulse_t * pulse, int32_t value) {
+  return bench_gauss_process(bench_gauss7_kernel, 7, PULSE_GAUSS_7_FACTOR, value);
+}
+
+static int32_t bench_gauss9_process(pulse_t * pulse, int32_t value) {
+  return bench_gauss_process(bench_gauss9_kernel, 9, PULSE_GAUSS_9_FACTOR, value);
+}
+
+#if USE_PULSE_MOTION_CANCELLER
+/**
+ * Motion Canceller with reference at half of PPG rate (50Hz accelerometer).
+ * Adding reference is timed too, it's done once per accelerometer sample.
+ * Reference follows input, so weights are adapted on every sample
+ */
+static int32_t bench_mc_process(pulse_t * pulse, int32_t value) {
+  if (!(pulse->sample_index & 1)) {
+    pulse_add_motion_reference(pulse, pulse->sample_index, (int16_t) value, 0, BENCH_MC_GRAVITY);
+  }
+
+  int32_t res = pulse_bench_motion_canceller(pulse, value);
+  pulse->sample_index++;
+
+  return res;
+}
+#endif
+
+#if USE_PULSE_SPO2
+/**
+ * SpO2 estimator, sample by sample (red AC is half of IR AC). Cost of
+ * window completion (64 bit division) is spread over the window
+ */
+static int32_t bench_spo2_process(pulse_t * pulse, int32_t value) {
+  max3010x_sample_t sample = {
+    .ir  = (uint32_t) (BENCH_SPO2_IR_DC + value),
+    .red = (uint32_t) (BENCH_SPO2_RED_DC + value / 2),
+  };
+
+  spo2_process_block(&bench_spo2, &sample, 1);
+
+  return bench_spo2.value;
+}
+#endif
+
+/** Filters, that are timed on the same input */
+static const bench_filter_t bench_filters[] = {
+  { .name = "wma-legacy",   .process = bench_wma_legacy_process   },
+  { .name = "wma",          .process = pulse_peak_bench_wma       },
+  { .name = "gauss-legacy", .process = bench_gauss_legacy_process },
+  { .name = "gauss5",       .process = bench_gauss5_process       },
+  { .name = "gauss7",       .process = bench_gauss7_process       },
+  { .name = "gauss9",       .process = bench_gauss9_process       },
+#if USE_PULSE_MOTION_CANCELLER
+  { .name = "mc",           .process = bench_mc_process           },
+#endif
+#if USE_PULSE_SPO2
+  { .name = "spo2",         .process = bench_spo2_process         },
+#endif
+};
+
+/**
+ * Time filters on synthetic input & report cycles per sample. Unlike engine
+ * bench, it doesn't need the sensor
+ *
+ * @param sh Shell
+ */
+static int8_t cmd_pulse_bench_filters(shell_t * sh) {
+  uint32_t seed = 1;
+
+  for (size_t i = 0; i < BENCH_FILTER_INPUT; ++i) {
+    seed = seed * 1103515245 + 12345;
+    bench_input[i] = (int16_t) ((seed >> 16) % 1024) - 512;
+  }
+
+  memset(&bench_wma_legacy, 0, sizeof(bench_wma_legacy));
+
+  for (int32_t w = 0; w < BENCH_WMA_LEGACY_SIZE; ++w) {
+    bench_wma_legacy.weights[BENCH_WMA_LEGACY_SIZE - w - 1] = w;
+    bench_wma_legacy.weights_sum += w;
+  }
+
+  for (size_t f = 0; f < UTIL_ARR_SIZE(bench_filters); ++f) {
+    pulse_init(&bench_ctx[0], 0, 0);
+    memset(&bench_gauss_legacy, 0, sizeof(bench_gauss_legacy));
+    memset(&bench_gauss, 0, sizeof(bench_gauss));
+#if USE_PULSE_SPO2
+    spo2_init(&bench_spo2, 0);
+#endif
+
+    uint64_t cycles = 0;
+    int32_t  check  = 0;
+
+    for (uint32_t round = 0; round < BENCH_FILTER_ROUNDS; ++round) {
+      for (size_t i = 0; i < BENCH_FILTER_INPUT; i += BENCH_FILTER_BLOCK) {
+        uint32_t start = SysTick->VAL;
+
+        for (size_t j = i; j < i + BENCH_FILTER_BLOCK; ++j) {
+          check += bench_filters[f].process(&bench_ctx[0], bench_input[j]);
+        }
+
+        cycles += bench_cycles(start);
+      }
+    }
+
+    // Checksum of outputs, so it's visible if implementations disagree
+    log_info("%-12s cycles/sample=%u check=%d",
+      bench_filters[f].name, (uint32_t) (cycles / (BENCH_FILTER_INPUT * BENCH_FILTER_ROUNDS)), check
+    );
+  }
+
+  return SHELL_OK;
+}
+
+/**
+ * Run all engines on the same sensor samples & report cycles per sample and
+ * BPM (error, if reference BPM is given)
+ *
+ * @param sh Shell
+ * @param ref Reference BPM (0 - if unknown)
+ */
+static int8_t cmd_pulse_bench(shell_t * sh, uint32_t ref) {
+  max3010x_sample_t samples[PULSE_SAMPLE_COUNT];
+
+  uint64_t cycles[BENCH_ENGINES] = {0};
+  uint32_t error[BENCH_ENGINES]  = {0};
+  uint32_t valid[BENCH_ENGINES]  = {0};
+  uint32_t total = 0;
+
+  for (size_t i = 0; i < BENCH_ENGINES; ++i) {
+    pulse_init(&bench_ctx[i], max3010x_get_min_ir_adc_voltage(&device.app.pulse.max3010x), 500);
+    pulse_set_engine(&bench_ctx[i], bench_engines[i]);
+  }
+
+  while (1) {
+    char c = '\0';
+
+    if (tty_get_char_async(&sh->tty, &c) == E_OK && c != '\0') {
+      log_printf("\r\n");
+      log_info("Stopping...");
+      break;
+    }
+
+    max3010x_poll_irq_flags(&device.app.pulse.max3010x);
+
+    if (max3010x_process(&device.app.pulse.max3010x) != MAX3010X_STATUS_SAMPLES_READY) {
+      continue;
+    }
+
+    size_t size = PULSE_SAMPLE_COUNT;
+
+    if (max3010x_ext_read_samples(&device.app.pulse.ext, samples, &size) != E_OK ||
+        max3010x_ext_average_samples(&device.app.pulse.ext, samples, &size) != E_OK || !size) {
+      continue;
+    }
+
+    total += size;
+
+    for (size_t i = 0; i < BENCH_ENGINES; ++i) {
+      uint32_t start = SysTick->VAL;
+      pulse_process_block(&bench_ctx[i], samples, size, NULL);
+      cycles[i] += bench_cycles(start);
+
+      uint32_t bpm = 0;
+
+      if (pulse_approximate_bpm(&bench_ctx[i], &bpm) == E_OK) {
+        error[i] += bpm > ref ? bpm - ref : ref - bpm;
+        valid[i]++;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < BENCH_ENGINES; ++i) {
+    uint32_t per_sample = total ? (uint32_t) (cycles[i] / total) : 0;
+
+    log_info("%-5s cycles/sample=%u bpm=%u",
+      bench_engines[i]->name, per_sample, bench_ctx[i].approx.bpm
+    );
+
+    if (ref && valid[i]) {
+      log_info("%-5s ref=%u mae=%u (%u blocks)", bench_engines[i]->name, ref, error[i] / valid[i], valid[i]);
+    }
+  }
+
+  return SHELL_OK;
+}
+#endif
+
 /* Shared functions ========================================================= */
 static int8_t cmd_pulse(shell_t * sh, uint8_t argc, const char ** argv) {
+#if USE_PULSE_BENCH
+  if (argc > 1 && !strcmp(argv[1], "bench")) {
+    if (argc > 2 && !strcmp(argv[2], "filters")) {
+      return cmd_pulse_bench_filters(sh);
+    }
+
+    return cmd_pulse_bench(sh, argc > 2 ? shell_parse_int(argv[2]) : 0);
+  }
+#endif
+
   while (1) {
     char c = '\0';
 
@@ -44,10 +402,75 @@ static int8_t cmd_pulse(shell_t * sh, uint8_t argc, const char ** argv) {
     pulse_report_bpm(&device.app.pulse.ctx);
   }
 
+  uint32_t avg_bpm = 0;
+  pulse_get_avg_bpm(&device.app.pulse.ctx, &avg_bpm);
+
+  uint32_t pi = 0;
+  pulse_get_perfusion_index(&device.app.pulse.ctx, &pi);
+
+#if USE_PULSE_AGC
+  uint32_t ir  = device.app.pulse.agc.ir.current;
+  uint32_t red = device.app.pulse.agc.red.current;
+#else
+  uint32_t ir  = PULSE_LED_CURRENT;
+  uint32_t red = USE_PULSE_SPO2 ? PULSE_LED_CURRENT : 0;
+#endif
+
+  // LEDs are on only for a pulse width per sample (before averaging), so average current is much lower
+  bool is_max30102 = device.app.pulse.ext.part == MAX3010X_EXT_PART_MAX30102;
+
+  uint32_t pulse_width = is_max30102 ? MAX30102_PULSE_WIDTH_US : MAX30100_PULSE_WIDTH_US;
+  uint32_t rate        = is_max30102 ? PULSE_MAX30102_RATE_HZ : PULSE_MAX30100_RATE_HZ;
+
+  uint32_t led_avg = (ir + red) * pulse_width * rate / 1000;
+
   log_info("beats:    %u", device.app.pulse.ctx.total.beats);
   log_info("time(ms): %u", device.app.pulse.ctx.total.time);
   log_info("bpm(%d):  %u", PULSE_BEAT_APPROX_SAMPLES, device.app.pulse.ctx.approx.bpm);
-  log_info("bpm(abs): %u", PULSE_CALCULATE_BPM_TOTAL_AVG(device.app.pulse.ctx.total.beats, device.app.pulse.ctx.total.time));
+  log_info("bpm(avg): %u", avg_bpm);
+  log_info("contact:  %s", pulse_has_contact(&device.app.pulse.ctx) ? "yes" : "no");
+
+#if USE_PULSE_HRV
+  hrv_metrics_t hrv = {0};
+
+  if (pulse_get_hrv(&device.app.pulse.ctx, &hrv) == E_OK) {
+    log_info("hrv:      rmssd=%u ms sdnn=%u ms pnn50=%u%%", hrv.rmssd, hrv.sdnn, hrv.pnn50);
+  } else {
+    log_info("hrv:      --");
+  }
+#endif
+#if USE_PULSE_RHYTHM
+  uint32_t score = 0;
+
+  if (pulse_get_rhythm_score(&device.app.pulse.ctx, &score) == E_OK) {
+    log_info("rhythm:   score=%u%% %s", score,
+      pulse_is_rhythm_irregular(&device.app.pulse.ctx) ? "irregular" : "regular");
+  } else {
+    log_info("rhythm:   --");
+  }
+#endif
+#if USE_PULSE_RESP
+  uint32_t resp_rate = 0;
+
+  if (pulse_get_resp_rate(&device.app.pulse.ctx, &resp_rate) == E_OK) {
+    log_info("resp:     %u /min", resp_rate);
+  } else {
+    log_info("resp:     --");
+  }
+#endif
+  log_info("pi(%%):    %u.%02u", pi / 100, pi % 100);
+#if USE_PULSE_AGC
+  log_info("led(mA):  ir=%u red=%u range=%u", ir, red, device.app.pulse.agc.range);
+#else
+  log_info("led(mA):  ir=%u red=%u", ir, red);
+#endif
+  log_info("led(uA):  %u avg", led_avg);
+#if USE_PULSE_IRQ
+  log_info("irq:      wakeups=%u drains=%u", device.app.pulse.irq_stats.wakeups, device.app.pulse.irq_stats.drains);
+  log_info("fifo(ms):  last=%u min=%u max=%u",
+    device.app.pulse.irq_stats.interval, device.app.pulse.irq_stats.interval_min, device.app.pulse.irq_stats.interval_max
+  );
+#endif
 
   return SHELL_OK;
 }
@@ -11,7 +11,9 @@
 /* Includes ================================================================= */
 #include "gps/gps.h"
 #include "error/assertion.h"
+#include "util/util.h"
 #include <stdbool.h>
+#include <string.h>
 
 #include "log/log.h"
 
@@ -23,136 +25,274 @@
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
 /**
- * NMEA sentence parser context
+ * Position sentence description. Direction is the field right after the value
  */
 typedef struct {
-  /**
-   * Since NMEA sentences are basically CSV data - store tokens as pointers
-   * to start of each value, with comma replaced with NULL
-   */
-  struct {
-    char * buffer[20];
-    size_t size;
-  } tokens;
-
-  /** Checksum comes at the end of sentece after '*' */
-  char * checksum;
-} gps_parser_t;
+  /** Sentence type (after talker) */
+  char type[3];
+
+  /** Field indices (header is field 0) */
+  uint8_t latitude;
+  uint8_t longitude;
+  uint8_t status;
+
+  /** Status values, that mean valid position */
+  const char * valid;
+} gps_sentence_t;
 
 /* Variables ================================================================ */
+/**
+ * 3 sentences contain position:
+ * GLL (Geographic Position - Latitude/Longitude)
+ * RMC (Recommended Minimum Specific GNSS Data)
+ * GGA (Global Positioning System Fix Data), status is fix quality
+ */
+static const gps_sentence_t gps_sentences[] = {
+  { .type = "GLL", .latitude = 1, .longitude = 3, .status = 6, .valid = "A"    },
+  { .type = "RMC", .latitude = 3, .longitude = 5, .status = 2, .valid = "A"    },
+  { .type = "GGA", .latitude = 2, .longitude = 4, .status = 6, .valid = "1245" },
+};
+
 /* Private functions ======================================================== */
 /**
- * Split raw sentence into tokens
+ * Convert hex digit to value
  *
- * @param ctx Parser context. Will contain pointers to start of each token
- * @param buffer NMEA sentence buffer
- * @param size NMEA sentence size
+ * @return Digit value, or -1 if it's not a hex digit
  */
-static error_t gps_tokenize(gps_parser_t * ctx, char * buffer, size_t size) {
-  ASSERT_RETURN(ctx && buffer, E_NULL);
-  ASSERT_RETURN(size, E_EMPTY);
-
-  size_t i = 0;
-  char * start = buffer;
+__STATIC_INLINE int8_t gps_hex(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
 
-  while (i < size) {
-    char c = buffer[i];
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
 
-    if (c == ',' || c == '*') {
-      // Store 'start' into token buffer
-      ctx->tokens.buffer[ctx->tokens.size++] = start;
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
 
-      // Terminate token with NULL instead of a comma
-      buffer[i] = '\0';
+  return -1;
+}
 
-      // Store new start
-      start = &buffer[i+1];
+/**
+ * Match header against position sentences, talker is ignored
+ *
+ * @return Sentence index, or UTIL_ARR_SIZE(gps_sentences) if it's not wanted
+ */
+static uint8_t gps_match(const char * header) {
+  uint8_t i = 0;
 
-      // If checksum - terminate
-      if (c == '*') {
-        // TODO: Check CRC
-        break;
-      }
+  for (; i < UTIL_ARR_SIZE(gps_sentences); ++i) {
+    if (!memcmp(&header[2], gps_sentences[i].type, sizeof(gps_sentences[i].type))) {
+      break;
     }
-
-    i++;
   }
 
-  // Last 'token' is checksum
-  ctx->checksum = start;
+  return i;
+}
 
-  return E_OK;
+/**
+ * Select where the current field is stored. Values keep a NULL terminator,
+ * single char fields don't need one
+ */
+static void gps_select_field(gps_t * gps) {
+  const gps_sentence_t * sentence = &gps_sentences[gps->sentence];
+  uint8_t                field    = gps->field;
+
+  gps->length   = 0;
+  gps->target   = NULL;
+  gps->capacity = 0;
+
+  if (field == sentence->latitude) {
+    gps->target   = gps->pending.latitude.value;
+    gps->capacity = sizeof(gps->pending.latitude.value) - 1;
+  } else if (field == sentence->latitude + 1) {
+    gps->target   = &gps->pending.latitude.direction;
+    gps->capacity = 1;
+  } else if (field == sentence->longitude) {
+    gps->target   = gps->pending.longitude.value;
+    gps->capacity = sizeof(gps->pending.longitude.value) - 1;
+  } else if (field == sentence->longitude + 1) {
+    gps->target   = &gps->pending.longitude.direction;
+    gps->capacity = 1;
+  } else if (field == sentence->status) {
+    gps->target   = &gps->status;
+    gps->capacity = 1;
+  }
 }
 
-/* Shared functions ========================================================= */
-error_t gps_parse(gps_location_t * location, char * buffer, size_t size) {
-  ASSERT_RETURN(location && buffer, E_NULL);
-  ASSERT_RETURN(size, E_EMPTY);
+/**
+ * Check sentence, once checksum is received
+ */
+static bool gps_is_valid(gps_t * gps) {
+  if (gps->checksum != gps->expected) {
+    gps->checksum_errors++;
+    return false;
+  }
 
-#if 0
-  log_printf("%.*s\r\n", size, buffer);
-#endif
+  const gps_location_t * pending = &gps->pending;
 
-  gps_parser_t ctx = {0};
+  return gps->status && strchr(gps_sentences[gps->sentence].valid, gps->status) &&
+         pending->latitude.value[0] && pending->longitude.value[0] &&
+         (pending->latitude.direction == 'N' || pending->latitude.direction == 'S') &&
+         (pending->longitude.direction == 'E' || pending->longitude.direction == 'W');
+}
 
-  // Tokenize sentence
-  ERROR_CHECK_RETURN(gps_tokenize(&ctx, buffer, size));
+/**
+ * Parser step, inlined into span parsing loop
+ */
+__STATIC_INLINE error_t gps_step(gps_t * gps, char byte, gps_location_t * location) {
+  // Start of sentence resynchronizes parser from any state
+  if (byte == '$') {
+    gps->state    = GPS_STATE_HEADER;
+    gps->size     = 1;
+    gps->length   = 0;
+    gps->checksum = 0;
+    return E_AGAIN;
+  }
 
-#if 0
-  log_printf("Tokens (sz=%d crc='%s'): ", ctx.tokens.size, ctx.checksum);
+  if (gps->state == GPS_STATE_SYNC) {
+    return E_AGAIN;
+  }
 
-  for (size_t i = 0; i < ctx.tokens.size; ++i) {
-    log_printf("'%s' ", ctx.tokens.buffer[i]);
+  if (++gps->size > GPS_NMEA_MAX_SIZE) {
+    gps->state = GPS_STATE_SYNC;
+    return E_AGAIN;
   }
 
-  log_printf("\r\n");
-#endif
+  switch (gps->state) {
+    case GPS_STATE_HEADER:
+      gps->checksum ^= byte;
+
+      if (gps->length < GPS_NMEA_HEADER_SIZE) {
+        gps->header[gps->length++] = byte;
+
+        // Unwanted sentence is dropped as soon as its type is known
+        if (gps->length == GPS_NMEA_HEADER_SIZE) {
+          gps->sentence = gps_match(gps->header);
+
+          if (gps->sentence >= UTIL_ARR_SIZE(gps_sentences)) {
+            gps->state = GPS_STATE_SYNC;
+          }
+        }
+        break;
+      }
+
+      if (byte != ',') {
+        gps->state = GPS_STATE_SYNC;
+        break;
+      }
 
-  // Check if any tokens got parsed
-  ASSERT_RETURN(ctx.tokens.size, E_EMPTY);
+      memset(&gps->pending, 0, sizeof(gps_location_t));
+      gps->status = '\0';
+      gps->field  = 1;
+      gps->state  = GPS_STATE_FIELDS;
+      gps_select_field(gps);
+      break;
+
+    case GPS_STATE_FIELDS:
+      if (byte == '*') {
+        gps->expected = 0;
+        gps->length   = 0;
+        gps->state    = GPS_STATE_CHECKSUM;
+        break;
+      }
 
-  const char * header = ctx.tokens.buffer[0];
+      gps->checksum ^= byte;
 
-  // Check if header starts '$' - which is a NMEA format requirement
-  ASSERT_RETURN(header[0] == '$', E_INVAL);
+      if (byte == ',') {
+        gps->field++;
+        gps_select_field(gps);
+        break;
+      }
 
-  /* Don't bother parsing talker (GPS satellite system name), skip it and
-   * go for message type, since we're only interested in actual coordinates
-   *
-   * 2 messages contain position:
-   * GLL (Geographic Position - Latitude/Longitude)
-   * RMC (Recommended Minimum Specific GNSS Data)
-   */
-  if (strstr(header, "GLL") != NULL) {
-    ASSERT_RETURN(ctx.tokens.size > 4, E_UNDERFLOW);
+      if (!gps->target) {
+        break;
+      }
 
-    strcpy(location->latitude.value, ctx.tokens.buffer[1]);
-    location->latitude.direction = ctx.tokens.buffer[2][0];
+      // Field doesn't fit - sentence is malformed
+      if (gps->length >= gps->capacity) {
+        gps->state = GPS_STATE_SYNC;
+        break;
+      }
 
-    strcpy(location->longitude.value, ctx.tokens.buffer[3]);
-    location->longitude.direction = ctx.tokens.buffer[4][0];
+      gps->target[gps->length++] = byte;
+      break;
 
-    // Check Status field, where A = valid data, V = invalid data
-    ASSERT_RETURN(ctx.tokens.buffer[6][0] == 'A', E_INVAL);
-  } else if (strstr(header, "RMC") != NULL) {
-    ASSERT_RETURN(ctx.tokens.size > 6, E_UNDERFLOW);
+    case GPS_STATE_CHECKSUM: {
+      int8_t digit = gps_hex(byte);
 
-    strcpy(location->latitude.value, ctx.tokens.buffer[3]);
-    location->latitude.direction = ctx.tokens.buffer[4][0];
+      if (digit < 0) {
+        gps->state = GPS_STATE_SYNC;
+        break;
+      }
 
-    strcpy(location->longitude.value, ctx.tokens.buffer[5]);
-    location->longitude.direction = ctx.tokens.buffer[6][0];
+      gps->expected = (gps->expected << 4) | digit;
 
-    // Check Status field, where A = valid data, V = invalid data
-    ASSERT_RETURN(ctx.tokens.buffer[2][0] == 'A', E_INVAL);
-  } else {
-    return E_INVAL;
-  }
+      if (++gps->length < 2) {
+        break;
+      }
+
+      gps->state = GPS_STATE_SYNC;
+
+      if (!gps_is_valid(gps)) {
+        break;
+      }
+
+      memcpy(location, &gps->pending, sizeof(gps_location_t));
 
 #if 0
-  log_printf("Latitude:  %c %s\r\n", location->latitude.direction, location->latitude.value);
-  log_printf("Longitude: %c %s\r\n", location->longitude.direction, location->longitude.value);
+      log_printf("Latitude:  %c %s\r\n", location->latitude.direction, location->latitude.value);
+      log_printf("Longitude: %c %s\r\n", location->longitude.direction, location->longitude.value);
 #endif
 
+      return E_OK;
+    }
+
+    default:
+      gps->state = GPS_STATE_SYNC;
+      break;
+  }
+
+  return E_AGAIN;
+}
+
+/* Shared functions ========================================================= */
+error_t gps_init(gps_t * gps) {
+  ASSERT_RETURN(gps, E_NULL);
+
+  memset(gps, 0, sizeof(gps_t));
+
   return E_OK;
 }
+
+error_t gps_parse_byte(gps_t * gps, char byte, gps_location_t * location) {
+  ASSERT_RETURN(gps && location, E_NULL);
+
+  return gps_step(gps, byte, location);
+}
+
+error_t gps_parse(gps_t * gps, const uint8_t * data, size_t * size, gps_location_t * location) {
+  ASSERT_RETURN(gps && data && size && location, E_NULL);
+
+  for (size_t i = 0; i < *size; ++i) {
+    // Unwanted sentence - skip straight to the next one
+    if (gps->state == GPS_STATE_SYNC) {
+      const uint8_t * next = memchr(&data[i], '$', *size - i);
+
+      if (!next) {
+        break;
+      }
+
+      i = next - data;
+    }
+
+    if (gps_step(gps, (char) data[i], location) == E_OK) {
+      *size = i + 1;
+      return E_OK;
+    }
+  }
+
+  return E_AGAIN;
+}
@@ -6,6 +6,12 @@
  *
  * @brief GPS NMEA Sentence Parser (only parses latitude/logitude)
  *
+ * Parser is an incremental state machine, fed byte by byte (or span by span)
+ * straight from UART. Sentence type is matched right after the header, so
+ * unwanted sentences are skipped without buffering. Position fields are
+ * written in place (bounded), checksum is computed on the fly & location is
+ * emitted only for valid GLL/RMC/GGA sentences with a matching checksum
+ *
  *  ========================================================================= */
 #pragma once
 
@@ -15,11 +21,30 @@ extern "C" {
 
 /* Includes ================================================================= */
 #include "error/error.h"
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 /* Defines ================================================================== */
+/** Max NMEA sentence size, from '$' to the checksum (NMEA 0183 limits it to 82 with CRLF) */
+#define GPS_NMEA_MAX_SIZE 82
+
+/** Header size after '$' - talker (2) & sentence type (3) */
+#define GPS_NMEA_HEADER_SIZE 5
+
 /* Macros =================================================================== */
 /* Enums ==================================================================== */
+/**
+ * Parser state
+ */
+typedef enum {
+  /** Waiting for '$' */
+  GPS_STATE_SYNC = 0,
+  GPS_STATE_HEADER,
+  GPS_STATE_FIELDS,
+  GPS_STATE_CHECKSUM,
+} gps_state_t;
+
 /* Types ==================================================================== */
 /**
  * Raw location from GPS
@@ -44,17 +69,71 @@ typedef struct {
   } longitude;
 } gps_location_t;
 
+/**
+ * NMEA parser context
+ */
+typedef struct {
+  gps_state_t state;
+
+  /** Matched sentence (index into sentence table) */
+  uint8_t sentence;
+
+  /** Chars in sentence, index & size of current field */
+  uint8_t size;
+  uint8_t field;
+  uint8_t length;
+
+  /** Where current field is stored & how many chars fit (NULL - skipped) */
+  char *  target;
+  uint8_t capacity;
+
+  /** Running XOR of chars between '$' & '*', received checksum */
+  uint8_t checksum;
+  uint8_t expected;
+
+  /** Talker & sentence type */
+  char header[GPS_NMEA_HEADER_SIZE];
+
+  /** Status (GLL, RMC) or fix quality (GGA) */
+  char status;
+
+  /** Location of the sentence being parsed */
+  gps_location_t pending;
+
+  /** Sentences rejected due to checksum mismatch */
+  uint32_t checksum_errors;
+} gps_t;
+
 /* Variables ================================================================ */
 /* Shared functions ========================================================= */
 /**
- * Parse GPS location from NMEA sentence produced by GPS
+ * Initialize (reset) NMEA parser
  *
- * @param location Result location
- * @param buffer NMEA sentence data
- * @param size NMEA sentence size
+ * @param gps Parser context
  */
-error_t gps_parse(gps_location_t * location, char * buffer, size_t size);
+error_t gps_init(gps_t * gps);
+
+/**
+ * Parse a single byte of NMEA stream
+ *
+ * @param gps Parser context
+ * @param byte Received byte
+ * @param location Updated only if byte completes a valid position sentence
+ * @return E_OK if location was updated, E_AGAIN otherwise
+ */
+error_t gps_parse_byte(gps_t * gps, char byte, gps_location_t * location);
+
+/**
+ * Parse NMEA stream data, stops right after the first valid position sentence
+ *
+ * @param gps Parser context
+ * @param data Received data
+ * @param size Size of data, set to number of bytes consumed
+ * @param location Updated only if a valid position sentence was parsed
+ * @return E_OK if location was updated, E_AGAIN if all data was consumed without one
+ */
+error_t gps_parse(gps_t * gps, const uint8_t * data, size_t * size, gps_location_t * location);
 
 #ifdef __cplusplus
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,327 @@
+/** ========================================================================= *
+ *
+ * @file ubx.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "gps/ubx.h"
+#include "error/assertion.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+/** Frames with larger payload are treated as corrupted length */
+#define UBX_FRAME_MAX_PAYLOAD 512
+
+/** CFG-PRT: UART1 port, 8N1, UBX + NMEA in, UBX out */
+#define UBX_CFG_PRT_PORT_UART1 1
+#define UBX_CFG_PRT_MODE_8N1   0x000008D0
+#define UBX_CFG_PRT_PROTO_UBX  0x0001
+#define UBX_CFG_PRT_PROTO_NMEA 0x0002
+
+/** CFG-RATE: time reference is GPS time */
+#define UBX_CFG_RATE_TIME_GPS 1
+
+/** NAV-PVT: fix is valid flag & 2D/3D/GNSS+DR fix types */
+#define UBX_NAV_PVT_GNSS_FIX_OK 0x01
+#define UBX_NAV_PVT_FIX_MIN     2
+#define UBX_NAV_PVT_FIX_MAX     4
+
+/** Coordinates are in 1e-7 degrees */
+#define UBX_DEGREE 10000000
+
+/* Macros =================================================================== */
+#define UBX_MSG_CLASS(__msg) ((uint8_t) ((__msg) >> 8))
+#define UBX_MSG_ID(__msg)    ((uint8_t) ((__msg) & 0xFF))
+
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+__STATIC_INLINE void ubx_put_u16(uint8_t * buffer, uint16_t value) {
+  buffer[0] = value & 0xFF;
+  buffer[1] = value >> 8;
+}
+
+__STATIC_INLINE void ubx_put_u32(uint8_t * buffer, uint32_t value) {
+  ubx_put_u16(&buffer[0], value & 0xFFFF);
+  ubx_put_u16(&buffer[2], value >> 16);
+}
+
+__STATIC_INLINE uint32_t ubx_get_u32(const uint8_t * buffer) {
+  return buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | ((uint32_t) buffer[3] << 24);
+}
+
+/**
+ * Write value as zero padded decimal of count digits
+ */
+static char * ubx_put_digits(char * out, uint32_t value, uint8_t count) {
+  for (uint8_t i = count; i > 0; --i) {
+    out[i - 1] = '0' + value % 10;
+    value /= 10;
+  }
+
+  return out + count;
+}
+
+/**
+ * Convert coordinate (1e-7 degrees) to NMEA format (D..DMM.MMMMM)
+ *
+ * @param value Coordinate
+ * @param digits Number of degree digits (2 - latitude, 3 - longitude)
+ * @param out Output string (at least digits + 9 chars)
+ */
+static void ubx_to_nmea(int32_t value, uint8_t digits, char * out) {
+  uint32_t abs = value < 0 ? -(uint32_t) value : (uint32_t) value;
+
+  // 1e-7 degrees to 1e-5 minutes: * 60 / 100
+  uint32_t minutes = (abs % UBX_DEGREE) * 3 / 5;
+
+  out = ubx_put_digits(out, abs / UBX_DEGREE, digits);
+  out = ubx_put_digits(out, minutes / 100000, 2);
+  *out++ = '.';
+  out = ubx_put_digits(out, minutes % 100000, 5);
+  *out = '\0';
+}
+
+static void ubx_set_location(gps_location_t * location, int32_t lat, int32_t lon) {
+  ubx_to_nmea(lat, 2, location->latitude.value);
+  ubx_to_nmea(lon, 3, location->longitude.value);
+
+  location->latitude.direction  = lat < 0 ? 'S' : 'N';
+  location->longitude.direction = lon < 0 ? 'W' : 'E';
+}
+
+/**
+ * Send CFG-PRT for receiver UART1 (8N1, same baudrate, UBX + NMEA input)
+ *
+ * @param uart Receiver UART
+ * @param output Output protocol mask
+ */
+static error_t ubx_send_cfg_prt(uart_t * uart, uint16_t output) {
+  uint8_t frame[UBX_HEADER_SIZE + 20 + UBX_CRC_SIZE];
+  uint8_t payload[20] = {0};
+
+  payload[0] = UBX_CFG_PRT_PORT_UART1;
+  ubx_put_u32(&payload[4], UBX_CFG_PRT_MODE_8N1);
+  ubx_put_u32(&payload[8], UBX_BAUDRATE);
+  ubx_put_u16(&payload[12], UBX_CFG_PRT_PROTO_UBX | UBX_CFG_PRT_PROTO_NMEA);
+  ubx_put_u16(&payload[14], output);
+
+  return uart_send(uart, frame, ubx_frame(frame, UBX_CFG_PRT, payload, sizeof(payload)));
+}
+
+/**
+ * Handle frame with valid checksum
+ */
+static error_t ubx_handle(ubx_t * ubx, gps_location_t * location) {
+  const uint8_t * payload = ubx->payload;
+
+  if (!ubx->is_stored) {
+    return E_AGAIN;
+  }
+
+  switch (ubx->msg) {
+    case UBX_ACK_ACK:
+      ubx->acks++;
+      break;
+
+    case UBX_ACK_NAK:
+      ubx->naks++;
+      break;
+
+    case UBX_NAV_POSLLH:
+      if (ubx->size != UBX_NAV_POSLLH_SIZE || ubx_get_u32(&payload[20]) > UBX_POSLLH_MAX_HACC) {
+        break;
+      }
+
+      ubx_set_location(location, (int32_t) ubx_get_u32(&payload[8]), (int32_t) ubx_get_u32(&payload[4]));
+      return E_OK;
+
+    case UBX_NAV_PVT:
+      if (ubx->size != UBX_NAV_PVT_SIZE || !(payload[21] & UBX_NAV_PVT_GNSS_FIX_OK) ||
+          payload[20] < UBX_NAV_PVT_FIX_MIN || payload[20] > UBX_NAV_PVT_FIX_MAX) {
+        break;
+      }
+
+      ubx_set_location(location, (int32_t) ubx_get_u32(&payload[28]), (int32_t) ubx_get_u32(&payload[24]));
+      return E_OK;
+
+    default:
+      break;
+  }
+
+  return E_AGAIN;
+}
+
+/**
+ * Parser step, inlined into span parsing loop
+ */
+__STATIC_INLINE error_t ubx_step(ubx_t * ubx, uint8_t byte, gps_location_t * location) {
+  switch (ubx->state) {
+    case UBX_STATE_SYNC_1:
+      if (byte == UBX_SYNC_1) {
+        ubx->state = UBX_STATE_SYNC_2;
+      }
+      break;
+
+    case UBX_STATE_SYNC_2:
+      if (byte != UBX_SYNC_2) {
+        ubx->state = byte == UBX_SYNC_1 ? UBX_STATE_SYNC_2 : UBX_STATE_SYNC_1;
+        break;
+      }
+
+      ubx->ck_a   = 0;
+      ubx->ck_b   = 0;
+      ubx->length = 0;
+      ubx->state  = UBX_STATE_HEADER;
+      break;
+
+    case UBX_STATE_HEADER:
+      ubx->ck_a += byte;
+      ubx->ck_b += ubx->ck_a;
+
+      ubx->header[ubx->length++] = byte;
+
+      if (ubx->length < sizeof(ubx->header)) {
+        break;
+      }
+
+      ubx->msg  = (ubx->header[0] << 8) | ubx->header[1];
+      ubx->size = ubx->header[2] | (ubx->header[3] << 8);
+
+      if (ubx->size > UBX_FRAME_MAX_PAYLOAD) {
+        ubx->state = UBX_STATE_SYNC_1;
+        break;
+      }
+
+      // Only navigation message & acknowledgements are stored, the rest is just checksummed
+      ubx->is_stored = (ubx->msg == UBX_NAV_MSG || ubx->msg == UBX_ACK_ACK || ubx->msg == UBX_ACK_NAK) &&
+                       ubx->size <= sizeof(ubx->payload);
+
+      ubx->length = 0;
+      ubx->state  = ubx->size ? UBX_STATE_PAYLOAD : UBX_STATE_CRC;
+      break;
+
+    case UBX_STATE_PAYLOAD:
+      ubx->ck_a += byte;
+      ubx->ck_b += ubx->ck_a;
+
+      if (ubx->is_stored) {
+        ubx->payload[ubx->length] = byte;
+      }
+
+      if (++ubx->length == ubx->size) {
+        ubx->length = 0;
+        ubx->state  = UBX_STATE_CRC;
+      }
+      break;
+
+    case UBX_STATE_CRC:
+      ubx->crc[ubx->length++] = byte;
+
+      if (ubx->length < UBX_CRC_SIZE) {
+        break;
+      }
+
+      ubx->state = UBX_STATE_SYNC_1;
+
+      if (ubx->crc[0] != ubx->ck_a || ubx->crc[1] != ubx->ck_b) {
+        ubx->checksum_errors++;
+        break;
+      }
+
+      ubx->frames++;
+
+      return ubx_handle(ubx, location);
+
+    default:
+      ubx->state = UBX_STATE_SYNC_1;
+      break;
+  }
+
+  return E_AGAIN;
+}
+
+/* Shared functions ========================================================= */
+error_t ubx_init(ubx_t * ubx) {
+  ASSERT_RETURN(ubx, E_NULL);
+
+  memset(ubx, 0, sizeof(ubx_t));
+
+  return E_OK;
+}
+
+size_t ubx_frame(uint8_t * buffer, uint16_t msg, const uint8_t * payload, uint16_t size) {
+  ASSERT_RETURN(buffer && (payload || !size), 0);
+
+  buffer[0] = UBX_SYNC_1;
+  buffer[1] = UBX_SYNC_2;
+  buffer[2] = UBX_MSG_CLASS(msg);
+  buffer[3] = UBX_MSG_ID(msg);
+  ubx_put_u16(&buffer[4], size);
+
+  if (size) {
+    memcpy(&buffer[UBX_HEADER_SIZE], payload, size);
+  }
+
+  // Fletcher checksum over class, id, length & payload
+  uint8_t ck_a = 0;
+  uint8_t ck_b = 0;
+
+  for (size_t i = 2; i < UBX_HEADER_SIZE + size; ++i) {
+    ck_a += buffer[i];
+    ck_b += ck_a;
+  }
+
+  buffer[UBX_HEADER_SIZE + size]     = ck_a;
+  buffer[UBX_HEADER_SIZE + size + 1] = ck_b;
+
+  return UBX_HEADER_SIZE + size + UBX_CRC_SIZE;
+}
+
+error_t ubx_configure(uart_t * uart) {
+  ASSERT_RETURN(uart, E_NULL);
+
+  uint8_t frame[UBX_HEADER_SIZE + 6 + UBX_CRC_SIZE];
+  uint8_t payload[6] = {0};
+
+  // CFG-RATE: measurement period, navigation rate (must be 1 on u-blox 6) & time reference
+  ubx_put_u16(&payload[0], UBX_MEAS_PERIOD);
+  ubx_put_u16(&payload[2], 1);
+  ubx_put_u16(&payload[4], UBX_CFG_RATE_TIME_GPS);
+
+  ERROR_CHECK_RETURN(uart_send(uart, frame, ubx_frame(frame, UBX_CFG_RATE, payload, 6)));
+
+  // CFG-MSG: navigation message rate on current port (every UBX_NAV_RATE solutions)
+  payload[0] = UBX_MSG_CLASS(UBX_NAV_MSG);
+  payload[1] = UBX_MSG_ID(UBX_NAV_MSG);
+  payload[2] = UBX_NAV_RATE;
+
+  ERROR_CHECK_RETURN(uart_send(uart, frame, ubx_frame(frame, UBX_CFG_MSG, payload, 3)));
+
+  // CFG-PRT: UBX only output, default NMEA set is dropped
+  return ubx_send_cfg_prt(uart, UBX_CFG_PRT_PROTO_UBX);
+}
+
+error_t ubx_restore_nmea(uart_t * uart) {
+  ASSERT_RETURN(uart, E_NULL);
+
+  return ubx_send_cfg_prt(uart, UBX_CFG_PRT_PROTO_UBX | UBX_CFG_PRT_PROTO_NMEA);
+}
+
+error_t ubx_parse(ubx_t * ubx, const uint8_t * data, size_t * size, gps_location_t * location) {
+  ASSERT_RETURN(ubx && data && size && location, E_NULL);
+
+  for (size_t i = 0; i < *size; ++i) {
+    if (ubx_step(ubx, data[i], location) == E_OK) {
+      *size = i + 1;
+      return E_OK;
+    }
+  }
+
+  return E_AGAIN;
+}
@@ -0,0 +1,175 @@
+/** ========================================================================= *
+ *
+ * @file ubx.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief u-blox UBX binary protocol. Receiver is configured to output a single
+ *        navigation message (NAV-POSLLH or NAV-PVT) instead of the default NMEA
+ *        set, frames are parsed incrementally & checked with Fletcher checksum.
+ *        Location is converted to NMEA format, so the rest of the app doesn't
+ *        care, which protocol it came from
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "hal/uart/uart.h"
+#include "gps/gps.h"
+#include "error/error.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/** Message IDs (class << 8 | id) */
+#define UBX_NAV_POSLLH 0x0102
+#define UBX_NAV_PVT    0x0107
+#define UBX_ACK_NAK    0x0500
+#define UBX_ACK_ACK    0x0501
+#define UBX_CFG_PRT    0x0600
+#define UBX_CFG_MSG    0x0601
+#define UBX_CFG_RATE   0x0608
+
+/**
+ * Navigation message, that is enabled. NEO-6M (protocol 7) only has
+ * NAV-POSLLH, NAV-PVT needs u-blox 7 or newer
+ */
+#ifndef UBX_NAV_MSG
+#define UBX_NAV_MSG UBX_NAV_POSLLH
+#endif
+
+/**
+ * Measurement period (ms) & number of measurements per navigation message,
+ * so a fix is reported every UBX_MEAS_PERIOD * UBX_NAV_RATE ms
+ */
+#ifndef UBX_MEAS_PERIOD
+#define UBX_MEAS_PERIOD 1000
+#endif
+
+#ifndef UBX_NAV_RATE
+#define UBX_NAV_RATE 1
+#endif
+
+/**
+ * Horizontal accuracy estimate (mm), above which NAV-POSLLH isn't a fix
+ * (it has no fix status & is reported with huge accuracy before the fix)
+ */
+#define UBX_POSLLH_MAX_HACC 50000
+
+/** Receiver UART baudrate, it's kept the same when protocol is switched */
+#define UBX_BAUDRATE 9600
+
+/** Sync chars, header (class, id, length) & checksum sizes */
+#define UBX_SYNC_1      0xB5
+#define UBX_SYNC_2      0x62
+#define UBX_HEADER_SIZE 6
+#define UBX_CRC_SIZE    2
+
+/** Payload sizes of parsed messages */
+#define UBX_NAV_POSLLH_SIZE 28
+#define UBX_NAV_PVT_SIZE    92
+
+#if UBX_NAV_MSG == UBX_NAV_PVT
+#define UBX_PAYLOAD_MAX UBX_NAV_PVT_SIZE
+#else
+#define UBX_PAYLOAD_MAX UBX_NAV_POSLLH_SIZE
+#endif
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/**
+ * Frame parser state
+ */
+typedef enum {
+  UBX_STATE_SYNC_1 = 0,
+  UBX_STATE_SYNC_2,
+  UBX_STATE_HEADER,
+  UBX_STATE_PAYLOAD,
+  UBX_STATE_CRC,
+} ubx_state_t;
+
+/* Types ==================================================================== */
+/**
+ * UBX parser context
+ */
+typedef struct {
+  ubx_state_t state;
+
+  /** Class, id & little endian payload size */
+  uint8_t  header[UBX_HEADER_SIZE - 2];
+  uint16_t msg;
+  uint16_t size;
+
+  /** Bytes received in current state */
+  uint16_t length;
+
+  /** Fletcher checksum (running & received) */
+  uint8_t ck_a;
+  uint8_t ck_b;
+  uint8_t crc[UBX_CRC_SIZE];
+
+  /** Payload of wanted message (others are only checksummed) */
+  uint8_t payload[UBX_PAYLOAD_MAX];
+  bool    is_stored;
+
+  /** Valid frames, checksum errors & acknowledged configuration messages */
+  uint32_t frames;
+  uint32_t checksum_errors;
+  uint32_t acks;
+  uint32_t naks;
+} ubx_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize (reset) UBX parser
+ *
+ * @param ubx Parser context
+ */
+error_t ubx_init(ubx_t * ubx);
+
+/**
+ * Build UBX frame
+ *
+ * @param buffer Frame buffer, payload size + UBX_HEADER_SIZE + UBX_CRC_SIZE
+ * @param msg Message ID (class << 8 | id)
+ * @param payload Payload (can be NULL, if size is 0)
+ * @param size Payload size
+ * @return Frame size
+ */
+size_t ubx_frame(uint8_t * buffer, uint16_t msg, const uint8_t * payload, uint16_t size);
+
+/**
+ * Switch receiver to UBX output, with only UBX_NAV_MSG enabled every
+ * UBX_MEAS_PERIOD * UBX_NAV_RATE ms. NMEA input stays enabled
+ *
+ * @param uart Receiver UART
+ */
+error_t ubx_configure(uart_t * uart);
+
+/**
+ * Enable NMEA output back (fallback, if UBX isn't received)
+ *
+ * @param uart Receiver UART
+ */
+error_t ubx_restore_nmea(uart_t * uart);
+
+/**
+ * Parse UBX stream data, stops right after the first navigation message
+ * with a valid fix
+ *
+ * @param ubx Parser context
+ * @param data Received data
+ * @param size Size of data, set to number of bytes consumed
+ * @param location Updated only if a valid fix was parsed
+ * @return E_OK if location was updated, E_AGAIN if all data was consumed without one
+ */
+error_t ubx_parse(ubx_t * ubx, const uint8_t * data, size_t * size, gps_location_t * location);
+
+#ifdef __cplusplus
+}
+#endif
@@ -40,6 +40,7 @@ __STATIC_INLINE const char * net_cmd2str(net_cmd_t cmd) {
     case NET_CMD_STATUS:            return "STATUS";
     case NET_CMD_LOCATION:          return "LOCATION";
     case NET_CMD_ALERT:             return "ALERT";
+    case NET_CMD_CAPTURE:           return "CAPTURE";
     default:                        return "?";
   }
 }
@@ -68,9 +69,12 @@ __STATIC_INLINE const char * net_reset_reason2str(net_reset_reason_t reset_reaso
 
 __STATIC_INLINE const char * net_alert_trigger2str(net_alert_trigger_t trigger) {
   switch (trigger) {
-    case NET_ALERT_TRIGGER_PULSE_THRESHOLD: return "PULSE_THRESHOLD";
-    case NET_ALERT_TRIGGER_SUDDEN_MOVEMENT: return "SUDDEN_MOVEMENT";
-    default:                                return "?";
+    case NET_ALERT_TRIGGER_PULSE_THRESHOLD:  return "PULSE_THRESHOLD";
+    case NET_ALERT_TRIGGER_SUDDEN_MOVEMENT:  return "SUDDEN_MOVEMENT";
+    case NET_ALERT_TRIGGER_IRREGULAR_RHYTHM: return "IRREGULAR_RHYTHM";
+    case NET_ALERT_TRIGGER_FALL:             return "FALL";
+    case NET_ALERT_TRIGGER_PRONE_STILL:      return "PRONE_STILL";
+    default:                                 return "?";
   }
 }
 #endif
@@ -115,6 +119,9 @@ error_t net_packet_init(net_t * net, net_packet_t * packet, net_packet_cfg_t * c
     case NET_CMD_ALERT:
       packet->size = sizeof(net_alert_payload_t);
       break;
+    case NET_CMD_CAPTURE:
+      packet->size = sizeof(net_capture_payload_t);
+      break;
     default:
       return E_INVAL;
   }
@@ -239,13 +246,20 @@ error_t net_packet_dump(net_packet_t * packet) {
       }
       break;
     case NET_CMD_STATUS:
-      log_printf("flags=%d reset=(%s %d) cpu=%d bpm=(%d %d)",
+      log_printf("flags=%d reset=(%s %d) cpu=%d bpm=(%d %d) spo2=%d hrv=(%d %d %d) resp=%d act=%d posture=%d",
         packet->payload.status.flags,
         net_reset_reason2str(packet->payload.status.reset_reason),
         packet->payload.status.reset_count,
         packet->payload.status.cpu_temp,
         packet->payload.status.bpm,
-        packet->payload.status.avg_bpm
+        packet->payload.status.avg_bpm,
+        packet->payload.status.spo2,
+        packet->payload.status.hrv.rmssd,
+        packet->payload.status.hrv.sdnn,
+        packet->payload.status.hrv.pnn50,
+        packet->payload.status.resp_rate,
+        packet->payload.status.activity,
+        packet->payload.status.posture
       );
       break;
     case NET_CMD_LOCATION:
@@ -257,7 +271,19 @@ error_t net_packet_dump(net_packet_t * packet) {
       );
       break;
     case NET_CMD_ALERT:
-      log_printf("trigger=%s", net_alert_trigger2str(packet->payload.alert.trigger));
+      log_printf("trigger=%s value=%d",
+        net_alert_trigger2str(packet->payload.alert.trigger),
+        packet->payload.alert.value
+      );
+      break;
+    case NET_CMD_CAPTURE:
+      log_printf("id=%d trigger=%s channel=%d block=%d/%d",
+        packet->payload.capture.id,
+        net_alert_trigger2str(packet->payload.capture.trigger),
+        packet->payload.capture.channel,
+        packet->payload.capture.index,
+        packet->payload.capture.count
+      );
       break;
     default:
       return E_INVAL;
@@ -62,6 +62,21 @@ typedef __PACKED_STRUCT {
   int8_t             cpu_temp;
   uint8_t            bpm;
   uint8_t            avg_bpm;
+  uint8_t            spo2;
+
+  /** Heart Rate Variability (0 - not available) */
+  __PACKED_STRUCT {
+    uint8_t rmssd; // ms
+    uint8_t sdnn;  // ms
+    uint8_t pnn50; // %
+  } hrv;
+
+  /** Respiratory rate (breaths/min, 0 - not available) */
+  uint8_t resp_rate;
+
+  /** Wearer activity & posture */
+  net_activity_t activity;
+  net_posture_t  posture;
 } net_status_payload_t;
 
 /** NET_CMD_LOCATION_DATA Payload */
@@ -80,8 +95,32 @@ typedef __PACKED_STRUCT {
 /** NET_CMD_ALARM Payload */
 typedef __PACKED_STRUCT {
   net_alert_trigger_t trigger;
+
+  /**
+   * Trigger specific value (NET_ALERT_TRIGGER_FALL: peak impact, 0.1g;
+   * NET_ALERT_TRIGGER_PRONE_STILL: time lying prone without movement, s)
+   */
+  uint8_t value;
 } net_alert_payload_t;
 
+/** NET_CMD_CAPTURE Payload (single block of a capture, 16-bit values are big endian) */
+typedef __PACKED_STRUCT {
+  uint8_t               id;      /** Capture ID (increments with each capture) */
+  net_alert_trigger_t   trigger; /** Alert, that triggered capture */
+  net_capture_channel_t channel;
+  uint8_t               rate;    /** Frame rate (Hz) */
+  uint8_t               index;   /** Block index (0 - oldest) */
+  uint8_t               count;   /** Number of blocks in channel */
+
+  /** Trigger frame, counted from the first frame of the oldest block */
+  uint16_t trigger_frame;
+
+  /** Delta encoded block. Frame i is base + sum(delta[0..i-1] << shift) */
+  int16_t base;
+  uint8_t shift;
+  int8_t  delta[NET_CAPTURE_DELTAS];
+} net_capture_payload_t;
+
 /**
  * Network packet
  */
@@ -103,6 +142,7 @@ typedef __PACKED_STRUCT {
     net_status_payload_t    status;
     net_location_payload_t  location;
     net_alert_payload_t     alert;
+    net_capture_payload_t   capture;
     uint8_t                 raw[0];
   } payload;
 } net_packet_t;
@@ -30,6 +30,9 @@ extern "C" {
 /** Max size of packet (header + payload) */
 #define NET_PACKET_MAX_SIZE    62
 
+/** Number of deltas in a capture block */
+#define NET_CAPTURE_DELTAS 31
+
 /* Macros =================================================================== */
 /* Enums ==================================================================== */
 /**
@@ -44,6 +47,7 @@ typedef __PACKED_ENUM {
   NET_CMD_STATUS            = 5,
   NET_CMD_LOCATION          = 6,
   NET_CMD_ALERT             = 7,
+  NET_CMD_CAPTURE           = 8,
 } net_cmd_t;
 
 /**
@@ -61,6 +65,9 @@ typedef enum {
 typedef __PACKED_ENUM {
   NET_ALERT_TRIGGER_PULSE_THRESHOLD = 1,
   NET_ALERT_TRIGGER_SUDDEN_MOVEMENT = 2,
+  NET_ALERT_TRIGGER_IRREGULAR_RHYTHM = 3,
+  NET_ALERT_TRIGGER_FALL = 4,
+  NET_ALERT_TRIGGER_PRONE_STILL = 5,
 } net_alert_trigger_t;
 
 /**
@@ -83,8 +90,40 @@ typedef __PACKED_ENUM {
   NET_STATUS_FLAG_PULSE_SENSOR_FAILURE = (1 << 0),
   NET_STATUS_FLAG_ACCEL_SENSOR_FAILURE = (1 << 1),
   NET_STATUS_FLAG_GPS_FAILURE          = (1 << 2),
+  NET_STATUS_FLAG_PULSE_NO_CONTACT     = (1 << 3),
+  NET_STATUS_FLAG_PULSE_LOW_SIGNAL     = (1 << 4),
 } net_status_flags_t;
 
+/**
+ * Wearer activity (matches activity_class_t)
+ */
+typedef __PACKED_ENUM {
+  NET_ACTIVITY_UNKNOWN = 0,
+  NET_ACTIVITY_REST    = 1,
+  NET_ACTIVITY_WALK    = 2,
+  NET_ACTIVITY_RUN     = 3,
+  NET_ACTIVITY_VEHICLE = 4,
+} net_activity_t;
+
+/**
+ * Wearer posture (matches posture_class_t)
+ */
+typedef __PACKED_ENUM {
+  NET_POSTURE_UNKNOWN = 0,
+  NET_POSTURE_UPRIGHT = 1,
+  NET_POSTURE_PRONE   = 2,
+  NET_POSTURE_SUPINE  = 3,
+  NET_POSTURE_SIDE    = 4,
+} net_posture_t;
+
+/**
+ * Captured channel (matches capture_channel_t)
+ */
+typedef __PACKED_ENUM {
+  NET_CAPTURE_CHANNEL_ACCEL = 0,
+  NET_CAPTURE_CHANNEL_PPG   = 1,
+} net_capture_channel_t;
+
 /* Types ==================================================================== */
 /**
  * Network MAC Address of a node
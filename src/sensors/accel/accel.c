@@ -9,42 +9,45 @@
 /* Includes ================================================================= */
 #include "sensors/accel/accel.h"
 #include "error/assertion.h"
-#include "tty/ansi.h"
 #include "log/log.h"
+#include <string.h>
 
 /* Defines ================================================================== */
 #define LOG_TAG accel
 
-/* Macros =================================================================== */
-#define ABS_DIFF(__a, __b) \
-  ((__a) > (__b) ? (__a) - (__b) : (__b) - (__a))
+/** Prone still duration, as number of samples */
+#define ACCELERATION_PRONE_STILL_SAMPLES ACCELERATION_MS_TO_SAMPLES(ACCELERATION_PRONE_STILL_DURATION)
 
+/* Macros =================================================================== */
 /* Exposed macros =========================================================== */
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
 /* Variables ================================================================ */
 /* Private functions ======================================================== */
-static int16_t simple_moving_average(acceleration_sma_t * wma, int16_t value) {
-  wma->buffer[wma->index] = value;
-  wma->index = ++wma->index % ACCELERATION_SMA_BUFFER_SIZE;
-
-  int32_t sum = 0;
-  uint32_t sma_index = wma->index;
+/* Shared functions ========================================================= */
+error_t acceleration_monitor_init(acceleration_monitor_t * am) {
+  ASSERT_RETURN(am, E_NULL);
 
-  for (uint32_t i = 0; i < ACCELERATION_SMA_BUFFER_SIZE; ++i) {
-    sum += wma->buffer[sma_index];
+  memset(am, 0, sizeof(acceleration_monitor_t));
 
-    sma_index = ++sma_index % ACCELERATION_SMA_BUFFER_SIZE;
-  }
+  ERROR_CHECK_RETURN(fall_init(&am->fall));
+  ERROR_CHECK_RETURN(activity_init(&am->activity));
 
-  return sum /= ACCELERATION_SMA_BUFFER_SIZE;
+  return posture_init(&am->posture);
 }
 
-/* Shared functions ========================================================= */
-error_t acceleration_monitor_init(acceleration_monitor_t * am) {
+error_t acceleration_monitor_resume(acceleration_monitor_t * am) {
   ASSERT_RETURN(am, E_NULL);
 
-  memset(am, 0, sizeof(acceleration_monitor_t));
+  am->prone_still = 0;
+
+  ERROR_CHECK_RETURN(activity_init(&am->activity));
+  ERROR_CHECK_RETURN(posture_init(&am->posture));
+
+  // Not seeded yet (or already tracking) - plain free fall detection is left
+  if (fall_arm_impact(&am->fall) == E_OK) {
+    log_debug("Fall detector armed for impact");
+  }
 
   return E_OK;
 }
@@ -52,34 +55,82 @@ error_t acceleration_monitor_init(acceleration_monitor_t * am) {
 acceleration_process_result_t acceleration_monitor_process_sample(acceleration_monitor_t * am, acceleration_pos_t * sample) {
   ASSERT_RETURN(am && sample, ACCELERATION_RESULT_IDLE);
 
-  acceleration_process_result_t res = ACCELERATION_RESULT_IDLE;
+  activity_process(&am->activity, acceleration_magnitude(sample->x, sample->y, sample->z));
 
-  acceleration_pos_t avg = {
-    .x = simple_moving_average(&am->x, sample->x),
-    .y = simple_moving_average(&am->y, sample->y),
-    .z = simple_moving_average(&am->z, sample->z),
-  };
+  if (posture_process(&am->posture, sample->x, sample->y, sample->z)) {
+    log_debug("Posture %s", posture_to_str(posture_get(&am->posture)));
+  }
 
-#if 1
-  log_printf("accel {x=%d y=%d z=%d}; avg {x=%d y=%d z=%d}\r\n",
-    sample->x, sample->y, sample->z, avg.x, avg.y, avg.z
-  );
-#endif
+  if (posture_get(&am->posture) == POSTURE_PRONE && activity_get(&am->activity) == ACTIVITY_REST) {
+    am->prone_still += am->prone_still < UINT32_MAX;
+  } else {
+    am->prone_still = 0;
+  }
 
-  if (ABS_DIFF(sample->x, avg.x) > ACCELERATION_SUDDEN_MOVEMENT_THRESHOLD) {
-    log_printf(ANSI_COLOR_FG_RED "X > THRESHOLD (%d %d)" ANSI_TEXT_RESET "\r\n", sample->x, avg.x);
-    res = ACCELERATION_RESULT_SUDDEN_MOVEMENT_DETECTED;
+  if (fall_process(&am->fall, sample->x, sample->y, sample->z)) {
+    return ACCELERATION_RESULT_FALL_DETECTED;
   }
 
-  if (ABS_DIFF(sample->y, avg.y) > ACCELERATION_SUDDEN_MOVEMENT_THRESHOLD) {
-    log_printf(ANSI_COLOR_FG_RED "Y > THRESHOLD (%d %d)" ANSI_TEXT_RESET "\r\n", sample->y, avg.y);
-    res = ACCELERATION_RESULT_SUDDEN_MOVEMENT_DETECTED;
+  return ACCELERATION_RESULT_IDLE;
+}
+
+acceleration_process_result_t acceleration_monitor_process_block(
+  acceleration_monitor_t * am, acceleration_pos_t * samples, size_t size
+) {
+  ASSERT_RETURN(am && samples, ACCELERATION_RESULT_IDLE);
+
+  acceleration_process_result_t res      = ACCELERATION_RESULT_IDLE;
+  activity_class_t              activity = activity_get(&am->activity);
+
+  // Whole block is processed, so detectors stay in sync with samples
+  for (size_t i = 0; i < size; ++i) {
+    if (acceleration_monitor_process_sample(am, &samples[i]) == ACCELERATION_RESULT_FALL_DETECTED) {
+      res = ACCELERATION_RESULT_FALL_DETECTED;
+    }
   }
 
-  if (ABS_DIFF(sample->z, avg.z) > ACCELERATION_SUDDEN_MOVEMENT_THRESHOLD) {
-    log_printf(ANSI_COLOR_FG_RED "Z > THRESHOLD (%d %d)" ANSI_TEXT_RESET "\r\n", sample->z, avg.z);
-    res = ACCELERATION_RESULT_SUDDEN_MOVEMENT_DETECTED;
+  if (res == ACCELERATION_RESULT_FALL_DETECTED) {
+    uint32_t peak = fall_get_peak(&am->fall);
+    log_debug("Fall detected, peak %u.%u g", peak / 10, peak % 10);
+  }
+
+  if (activity != activity_get(&am->activity)) {
+    log_debug("Activity %s", activity_to_str(activity_get(&am->activity)));
   }
 
   return res;
 }
+
+uint32_t acceleration_monitor_get_fall_peak(acceleration_monitor_t * am) {
+  ASSERT_RETURN(am, 0);
+
+  return fall_get_peak(&am->fall);
+}
+
+activity_class_t acceleration_monitor_get_activity(acceleration_monitor_t * am) {
+  ASSERT_RETURN(am, ACTIVITY_UNKNOWN);
+
+  return activity_get(&am->activity);
+}
+
+posture_class_t acceleration_monitor_get_posture(acceleration_monitor_t * am) {
+  ASSERT_RETURN(am, POSTURE_UNKNOWN);
+
+  return posture_get(&am->posture);
+}
+
+bool acceleration_monitor_is_prone_still(acceleration_monitor_t * am, uint32_t * duration) {
+  ASSERT_RETURN(am, false);
+
+  if (duration) {
+    *duration = am->prone_still / ACCELERATION_SAMPLE_RATE_HZ;
+  }
+
+  return am->prone_still >= ACCELERATION_PRONE_STILL_SAMPLES;
+}
+
+bool acceleration_monitor_is_busy(acceleration_monitor_t * am) {
+  ASSERT_RETURN(am, false);
+
+  return fall_is_busy(&am->fall);
+}
@@ -4,7 +4,8 @@
  * @date 04-11-2025
  * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
  *
- * @brief Sudden movement detector from accelerometer data
+ * @brief Acceleration monitor. Runs detectors (fall) & classifiers (activity,
+ *        posture) on accelerometer data
  *
  *  ========================================================================= */
 #pragma once
@@ -14,19 +15,23 @@ extern "C" {
 #endif
 
 /* Includes ================================================================= */
+#include "sensors/accel/units.h"
+#include "sensors/accel/fall.h"
+#include "sensors/accel/activity.h"
+#include "sensors/accel/posture.h"
 #include "lib/error/error.h"
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /* Defines ================================================================== */
-/** Size of Simple Moving Average Buffer */
-#define ACCELERATION_SMA_BUFFER_SIZE 16
-
 /**
- * Threshold that difference of avg & sample value has to cross to be
- * considered a sudden movement
+ * Time (ms) wearer has to lie prone without movement (activity is rest),
+ * before it's reported. Unconscious casualty lying face down is the most
+ * urgent case
  */
-#ifndef ACCELERATION_SUDDEN_MOVEMENT_THRESHOLD
-#define ACCELERATION_SUDDEN_MOVEMENT_THRESHOLD 10000
+#ifndef ACCELERATION_PRONE_STILL_DURATION
+#define ACCELERATION_PRONE_STILL_DURATION 30000
 #endif
 
 /* Macros =================================================================== */
@@ -36,7 +41,7 @@ extern "C" {
  */
 typedef enum {
   ACCELERATION_RESULT_IDLE = 0,
-  ACCELERATION_RESULT_SUDDEN_MOVEMENT_DETECTED,
+  ACCELERATION_RESULT_FALL_DETECTED,
 } acceleration_process_result_t;
 
 /* Types ==================================================================== */
@@ -54,21 +59,21 @@ typedef struct {
   acceleration_point_t z;
 } acceleration_pos_t;
 
-/**
- * Simple Moving Average Context
- */
-typedef struct {
-  int16_t  buffer[ACCELERATION_SMA_BUFFER_SIZE];
-  uint32_t index;
-} acceleration_sma_t;
-
 /**
  * Acceleration Monitor Context
  */
 typedef struct {
-  acceleration_sma_t x;
-  acceleration_sma_t y;
-  acceleration_sma_t z;
+  /** Fall detector */
+  fall_t fall;
+
+  /** Activity classifier */
+  activity_t activity;
+
+  /** Posture classifier */
+  posture_t posture;
+
+  /** Number of samples wearer has been lying prone without movement */
+  uint32_t prone_still;
 } acceleration_monitor_t;
 
 /* Variables ================================================================ */
@@ -80,17 +85,81 @@ typedef struct {
  */
 error_t acceleration_monitor_init(acceleration_monitor_t * am);
 
+/**
+ * Resume Acceleration Monitor after a gap in samples (e.g. accelerometer was
+ * asleep). Activity & posture averages are stale, so they are re-seeded with
+ * the next sample. Gap starts with the motion, that ended it - if it was a
+ * fall, free fall is already over, so fall detector is armed for impact
+ *
+ * @param am Acceleration Monitor Context
+ */
+error_t acceleration_monitor_resume(acceleration_monitor_t * am);
+
 /**
  * Process accelerometer sample
  *
  * @param am Acceleration Monitor Context
  * @param sample Accelerometer Sample
- * @returns ACCELERATION_RESULT_SUDDEN_MOVEMENT_DETECTED if sudden movement detected
+ * @returns ACCELERATION_RESULT_FALL_DETECTED if fall was detected
  */
 acceleration_process_result_t acceleration_monitor_process_sample(
   acceleration_monitor_t * am, acceleration_pos_t * sample
 );
 
+/**
+ * Process block of accelerometer samples (e.g. read from FIFO)
+ *
+ * @param am Acceleration Monitor Context
+ * @param samples Accelerometer Samples
+ * @param size Number of samples
+ * @returns ACCELERATION_RESULT_FALL_DETECTED if fall was detected on any
+ *          sample
+ */
+acceleration_process_result_t acceleration_monitor_process_block(
+  acceleration_monitor_t * am, acceleration_pos_t * samples, size_t size
+);
+
+/**
+ * Get peak impact acceleration of last detected fall
+ *
+ * @param am Acceleration Monitor Context
+ * @return Peak acceleration (0.1g)
+ */
+uint32_t acceleration_monitor_get_fall_peak(acceleration_monitor_t * am);
+
+/**
+ * Get current activity class
+ *
+ * @param am Acceleration Monitor Context
+ * @return ACTIVITY_UNKNOWN until enough samples were processed
+ */
+activity_class_t acceleration_monitor_get_activity(acceleration_monitor_t * am);
+
+/**
+ * Get current posture
+ *
+ * @param am Acceleration Monitor Context
+ * @return POSTURE_UNKNOWN until first sample was processed
+ */
+posture_class_t acceleration_monitor_get_posture(acceleration_monitor_t * am);
+
+/**
+ * Check, if wearer has been lying prone without movement for at least
+ * ACCELERATION_PRONE_STILL_DURATION
+ *
+ * @param am Acceleration Monitor Context
+ * @param duration Time lying prone without movement (s), can be NULL
+ */
+bool acceleration_monitor_is_prone_still(acceleration_monitor_t * am, uint32_t * duration);
+
+/**
+ * Check, if fall detector is tracking a possible fall, so samples must keep
+ * coming
+ *
+ * @param am Acceleration Monitor Context
+ */
+bool acceleration_monitor_is_busy(acceleration_monitor_t * am);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,171 @@
+/** ========================================================================= *
+ *
+ * @file activity.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/accel/activity.h"
+#include "error/assertion.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+/** Samples in a slot & in a window */
+#define ACTIVITY_SLOT_SAMPLES   ACCELERATION_MS_TO_SAMPLES(ACTIVITY_SLOT_DURATION)
+#define ACTIVITY_WINDOW_SAMPLES (ACTIVITY_SLOT_SAMPLES * ACTIVITY_SLOTS)
+
+/** Window duration (ms) */
+#define ACTIVITY_WINDOW_DURATION (ACTIVITY_SLOT_DURATION * ACTIVITY_SLOTS)
+
+/**
+ * Dynamic acceleration is computed from squared magnitude m^2 as
+ * (m^2 - 1g^2) / 2g, which is close to m - 1g for m near 1g. It's scaled down
+ * by 4, so squared sums of a whole window fit into uint32_t
+ */
+#define ACTIVITY_SCALE 4
+
+/** Squared magnitude limit (3g), dynamic acceleration is clipped to 4g */
+#define ACTIVITY_MAGNITUDE_MAX ACCELERATION_MG_TO_SQ(3000)
+#define ACTIVITY_G_SQ          ACCELERATION_MG_TO_SQ(1000)
+
+/** Thresholds, as scaled dynamic acceleration */
+#define ACTIVITY_UNITS(__mg)    (ACCELERATION_MG_TO_LSB(__mg) / ACTIVITY_SCALE)
+#define ACTIVITY_VARIANCE(__mg) ((uint32_t) ACTIVITY_UNITS(__mg) * ACTIVITY_UNITS(__mg))
+
+#define ACTIVITY_STEP_UNITS  ACTIVITY_UNITS(ACTIVITY_STEP_HYSTERESIS)
+#define ACTIVITY_REST_VAR    ACTIVITY_VARIANCE(ACTIVITY_REST_MAX_STD)
+#define ACTIVITY_RUN_VAR     ACTIVITY_VARIANCE(ACTIVITY_RUN_MIN_STD)
+#define ACTIVITY_VEHICLE_VAR ACTIVITY_VARIANCE(ACTIVITY_VEHICLE_MAX_STD)
+
+#if ACTIVITY_SLOT_SAMPLES < 1
+#error "ACTIVITY_SLOT_DURATION is shorter than a sample"
+#endif
+
+#if ACTIVITY_WINDOW_SAMPLES > 1024
+#error "Activity window is too long, squared sums may overflow"
+#endif
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+static const char * activity_str[] = {
+  [ACTIVITY_UNKNOWN] = "unknown",
+  [ACTIVITY_REST]    = "rest",
+  [ACTIVITY_WALK]    = "walk",
+  [ACTIVITY_RUN]     = "run",
+  [ACTIVITY_VEHICLE] = "vehicle",
+};
+
+/* Private functions ======================================================== */
+__STATIC_INLINE int32_t activity_dynamic(uint32_t magnitude) {
+  if (magnitude > ACTIVITY_MAGNITUDE_MAX) {
+    magnitude = ACTIVITY_MAGNITUDE_MAX;
+  }
+
+  return ((int32_t) magnitude - (int32_t) ACTIVITY_G_SQ) / (2 * ACCELERATION_LSB_PER_G * ACTIVITY_SCALE);
+}
+
+/**
+ * Window features are computed from slot sums, so it's once per slot
+ */
+static void activity_update_features(activity_t * activity) {
+  int32_t  sum   = 0;
+  uint32_t sum2  = 0;
+  uint32_t steps = 0;
+
+  for (uint32_t i = 0; i < ACTIVITY_SLOTS; ++i) {
+    sum   += activity->slots[i].sum;
+    sum2  += activity->slots[i].sum2;
+    steps += activity->slots[i].steps;
+  }
+
+  int32_t  mean = sum / ACTIVITY_WINDOW_SAMPLES;
+  uint32_t mean2 = (uint32_t) (mean * mean);
+
+  sum2 /= ACTIVITY_WINDOW_SAMPLES;
+
+  activity->variance = sum2 > mean2 ? sum2 - mean2 : 0;
+  activity->cadence  = steps * 60000 / ACTIVITY_WINDOW_DURATION;
+}
+
+static activity_class_t activity_classify(activity_t * activity) {
+  if (activity->variance < ACTIVITY_REST_VAR) {
+    return ACTIVITY_REST;
+  }
+
+  if (activity->cadence < ACTIVITY_WALK_MIN_CADENCE) {
+    return activity->variance < ACTIVITY_VEHICLE_VAR ? ACTIVITY_VEHICLE : ACTIVITY_WALK;
+  }
+
+  if (activity->cadence >= ACTIVITY_RUN_MIN_CADENCE || activity->variance >= ACTIVITY_RUN_VAR) {
+    return ACTIVITY_RUN;
+  }
+
+  return ACTIVITY_WALK;
+}
+
+static void activity_next_slot(activity_t * activity) {
+  if (activity->count < ACTIVITY_SLOTS) {
+    activity->count++;
+  }
+
+  if (activity->count >= ACTIVITY_SLOTS) {
+    activity_update_features(activity);
+
+    activity_class_t candidate = activity_classify(activity);
+
+    activity->confirm   = candidate == activity->candidate ? activity->confirm + 1 : 1;
+    activity->candidate = candidate;
+
+    if (activity->confirm >= ACTIVITY_CONFIRM_SLOTS || activity->activity == ACTIVITY_UNKNOWN) {
+      activity->activity = candidate;
+    }
+  }
+
+  activity->index   = (activity->index + 1) % ACTIVITY_SLOTS;
+  activity->samples = 0;
+
+  memset(&activity->slots[activity->index], 0, sizeof(activity_slot_t));
+}
+
+/* Shared functions ========================================================= */
+error_t activity_init(activity_t * activity) {
+  ASSERT_RETURN(activity, E_NULL);
+
+  memset(activity, 0, sizeof(activity_t));
+
+  return E_OK;
+}
+
+void activity_process(activity_t * activity, uint32_t magnitude) {
+  int32_t           value = activity_dynamic(magnitude);
+  activity_slot_t * slot  = &activity->slots[activity->index];
+
+  slot->sum  += value;
+  slot->sum2 += (uint32_t) (value * value);
+
+  if (value < -ACTIVITY_STEP_UNITS) {
+    activity->below = true;
+  } else if (value > ACTIVITY_STEP_UNITS && activity->below) {
+    activity->below = false;
+    slot->steps++;
+  }
+
+  if (++activity->samples >= ACTIVITY_SLOT_SAMPLES) {
+    activity_next_slot(activity);
+  }
+}
+
+activity_class_t activity_get(activity_t * activity) {
+  ASSERT_RETURN(activity, ACTIVITY_UNKNOWN);
+
+  return activity->activity;
+}
+
+const char * activity_to_str(activity_class_t activity) {
+  return activity < sizeof(activity_str) / sizeof(activity_str[0]) ? activity_str[activity] : "?";
+}
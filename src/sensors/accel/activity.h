@@ -0,0 +1,147 @@
+/** ========================================================================= *
+ *
+ * @file activity.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Activity classifier (rest, walk, run, vehicle). Dynamic acceleration
+ *        (magnitude minus 1g) is summarized over a sliding window (variance &
+ *        step cadence) & classified with a small integer decision tree. Window
+ *        is made of slots, so each sample costs the same & it slides by a slot
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "sensors/accel/units.h"
+#include "error/error.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * Window is ACTIVITY_SLOTS slots of ACTIVITY_SLOT_DURATION (ms). It's long
+ * enough to hold a few steps at walking cadence & class is updated each slot
+ */
+#define ACTIVITY_SLOT_DURATION 1000
+#define ACTIVITY_SLOTS         4
+
+/**
+ * Standard deviation of dynamic acceleration (mg), below which wearer is at
+ * rest & above which wearer is running (regardless of cadence)
+ */
+#define ACTIVITY_REST_MAX_STD 40
+#define ACTIVITY_RUN_MIN_STD  700
+
+/**
+ * Standard deviation (mg), above which movement without steps isn't a vehicle
+ * ride (vibration), but some other movement (it's classified as walk)
+ */
+#define ACTIVITY_VEHICLE_MAX_STD 300
+
+/**
+ * Step detection hysteresis (mg). A step is dynamic acceleration rising above
+ * it, after it was below -hysteresis
+ */
+#define ACTIVITY_STEP_HYSTERESIS 150
+
+/**
+ * Step cadence (steps/min), below which "steps" are just random bumps (e.g.
+ * road) & above which wearer is running
+ */
+#define ACTIVITY_WALK_MIN_CADENCE 70
+#define ACTIVITY_RUN_MIN_CADENCE  140
+
+/**
+ * Number of consecutive slots with the same decision, before class changes
+ */
+#define ACTIVITY_CONFIRM_SLOTS 2
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/**
+ * Activity class
+ */
+typedef enum {
+  ACTIVITY_UNKNOWN = 0,
+  ACTIVITY_REST,
+  ACTIVITY_WALK,
+  ACTIVITY_RUN,
+  ACTIVITY_VEHICLE,
+} activity_class_t;
+
+/* Types ==================================================================== */
+/**
+ * Window slot (partial sums)
+ */
+typedef struct {
+  int32_t  sum;
+  uint32_t sum2;
+  uint32_t steps;
+} activity_slot_t;
+
+/**
+ * Activity classifier context
+ */
+typedef struct {
+  activity_slot_t slots[ACTIVITY_SLOTS];
+  uint32_t index;
+
+  /** Samples in current slot & number of complete slots */
+  uint32_t samples;
+  uint32_t count;
+
+  /** Dynamic acceleration is below -hysteresis (step is armed) */
+  bool below;
+
+  /** Last window features */
+  uint32_t variance; // (~2mg)^2
+  uint32_t cadence;  // steps/min
+
+  /** Last decision & number of consecutive slots it was made for */
+  activity_class_t candidate;
+  uint32_t confirm;
+
+  /** Current (confirmed) class */
+  activity_class_t activity;
+} activity_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize (reset) activity classifier
+ *
+ * @param activity Activity classifier context
+ */
+error_t activity_init(activity_t * activity);
+
+/**
+ * Process squared magnitude of accelerometer sample
+ *
+ * @param activity Activity classifier context
+ * @param magnitude Squared vector magnitude (raw units)
+ */
+void activity_process(activity_t * activity, uint32_t magnitude);
+
+/**
+ * Get current activity class
+ *
+ * @param activity Activity classifier context
+ * @return ACTIVITY_UNKNOWN until the first window is complete
+ */
+activity_class_t activity_get(activity_t * activity);
+
+/**
+ * Get activity class name
+ *
+ * @param activity Activity class
+ */
+const char * activity_to_str(activity_class_t activity);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,187 @@
+/** ========================================================================= *
+ *
+ * @file fall.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/accel/fall.h"
+#include "util/isqrt.h"
+#include "error/assertion.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+/** Thresholds, as squared raw magnitude */
+#define FALL_FREE_FALL_SQ  ACCELERATION_MG_TO_SQ(FALL_FREE_FALL_THRESHOLD)
+#define FALL_IMPACT_SQ     ACCELERATION_MG_TO_SQ(FALL_IMPACT_THRESHOLD)
+#define FALL_STILL_MIN_SQ  ACCELERATION_MG_TO_SQ(1000 - FALL_STILL_TOLERANCE)
+#define FALL_STILL_MAX_SQ  ACCELERATION_MG_TO_SQ(1000 + FALL_STILL_TOLERANCE)
+
+/** Durations, as number of samples */
+#define FALL_FREE_FALL_SAMPLES  ACCELERATION_MS_TO_SAMPLES(FALL_FREE_FALL_DURATION)
+#define FALL_IMPACT_SAMPLES     ACCELERATION_MS_TO_SAMPLES(FALL_IMPACT_WINDOW)
+#define FALL_SETTLE_SAMPLES     ACCELERATION_MS_TO_SAMPLES(FALL_SETTLE_DURATION)
+#define FALL_STILL_SAMPLES      ACCELERATION_MS_TO_SAMPLES(FALL_STILL_DURATION)
+#define FALL_STILL_MAX_ACTIVE_SAMPLES ACCELERATION_MS_TO_SAMPLES(FALL_STILL_MAX_ACTIVE)
+
+#if FALL_FREE_FALL_SAMPLES < 1
+#error "FALL_FREE_FALL_DURATION is shorter than a sample"
+#endif
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+__STATIC_INLINE void fall_enter(fall_t * fall, fall_state_t state) {
+  fall->state = state;
+  fall->timer = 0;
+  fall->count = 0;
+}
+
+__STATIC_INLINE void fall_update_ref(fall_t * fall, int32_t * v) {
+  for (uint32_t i = 0; i < 3; ++i) {
+    if (!fall->is_seeded) {
+      fall->ref[i] = v[i] << FALL_REF_SHIFT;
+    }
+
+    fall->ref[i] += v[i] - (fall->ref[i] >> FALL_REF_SHIFT);
+  }
+
+  fall->is_seeded = true;
+}
+
+/**
+ * Check, if body orientation while lying still differs from the one before
+ * the fall. Angle is compared with cos^2, so there is no square root (only
+ * called once per fall, so 64-bit math is fine). Vectors are scaled down to
+ * 11 bits, so squared dot product times 100 can't overflow
+ */
+static bool fall_is_orientation_changed(fall_t * fall) {
+  int32_t ref[3];
+  int32_t still[3];
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    ref[i]   = fall->ref[i] >> (FALL_REF_SHIFT + 4);
+    still[i] = (fall->still[i] / (int32_t) fall->timer) >> 4;
+  }
+
+  int64_t dot = (int64_t) ref[0] * still[0] + (int64_t) ref[1] * still[1] + (int64_t) ref[2] * still[2];
+
+  if (dot <= 0) {
+    return true;
+  }
+
+  uint64_t norm = (uint64_t) acceleration_magnitude(ref[0], ref[1], ref[2]) * acceleration_magnitude(still[0], still[1], still[2]);
+
+  return (uint64_t) dot * dot * 100 < norm * FALL_ORIENTATION_COS2;
+}
+
+/* Shared functions ========================================================= */
+error_t fall_init(fall_t * fall) {
+  ASSERT_RETURN(fall, E_NULL);
+
+  memset(fall, 0, sizeof(fall_t));
+
+  return E_OK;
+}
+
+bool fall_process(fall_t * fall, int16_t x, int16_t y, int16_t z) {
+  int32_t  v[3]      = {x, y, z};
+  uint32_t magnitude = acceleration_magnitude(x, y, z);
+
+  fall->timer++;
+
+  switch (fall->state) {
+    case FALL_STATE_IDLE:
+      fall_update_ref(fall, v);
+
+      fall->count = magnitude < FALL_FREE_FALL_SQ ? fall->count + 1 : 0;
+
+      if (fall->count >= FALL_FREE_FALL_SAMPLES) {
+        fall_enter(fall, FALL_STATE_FREE_FALL);
+      }
+      break;
+
+    case FALL_STATE_FREE_FALL:
+      if (magnitude > FALL_IMPACT_SQ) {
+        fall_enter(fall, FALL_STATE_IMPACT);
+        fall->peak = magnitude;
+      } else if (fall->timer >= FALL_IMPACT_SAMPLES) {
+        fall_enter(fall, FALL_STATE_IDLE);
+      }
+      break;
+
+    case FALL_STATE_IMPACT:
+      if (magnitude > fall->peak) {
+        fall->peak = magnitude;
+      }
+
+      if (fall->timer >= FALL_SETTLE_SAMPLES) {
+        fall_enter(fall, FALL_STATE_STILL);
+        memset(fall->still, 0, sizeof(fall->still));
+      }
+      break;
+
+    case FALL_STATE_STILL:
+      if (magnitude < FALL_STILL_MIN_SQ || magnitude > FALL_STILL_MAX_SQ) {
+        if (++fall->count > FALL_STILL_MAX_ACTIVE_SAMPLES) {
+          fall_enter(fall, FALL_STATE_IDLE);
+          break;
+        }
+      }
+
+      for (uint32_t i = 0; i < 3; ++i) {
+        fall->still[i] += v[i];
+      }
+
+      if (fall->timer >= FALL_STILL_SAMPLES) {
+        bool is_fall = fall_is_orientation_changed(fall);
+
+        // Reference is re-seeded with new orientation
+        fall->is_seeded = false;
+        fall_enter(fall, FALL_STATE_IDLE);
+
+        return is_fall;
+      }
+      break;
+
+    default:
+      fall_enter(fall, FALL_STATE_IDLE);
+      break;
+  }
+
+  return false;
+}
+
+error_t fall_arm_impact(fall_t * fall) {
+  ASSERT_RETURN(fall, E_NULL);
+
+  if (fall->state != FALL_STATE_IDLE) {
+    return E_BUSY;
+  }
+
+  // Without reference, any still orientation would count as changed
+  if (!fall->is_seeded) {
+    return E_INVAL;
+  }
+
+  fall_enter(fall, FALL_STATE_FREE_FALL);
+
+  return E_OK;
+}
+
+bool fall_is_busy(fall_t * fall) {
+  ASSERT_RETURN(fall, false);
+
+  return fall->state != FALL_STATE_IDLE;
+}
+
+uint32_t fall_get_peak(fall_t * fall) {
+  ASSERT_RETURN(fall, 0);
+
+  return isqrt(fall->peak) * 10 / ACCELERATION_LSB_PER_G;
+}
@@ -0,0 +1,155 @@
+/** ========================================================================= *
+ *
+ * @file fall.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Fall detector. A fall is a free fall (magnitude well below 1g),
+ *        followed by an impact (magnitude spike), followed by lying still
+ *        (magnitude close to 1g) in another orientation than before the fall.
+ *        It's a state machine on squared vector magnitude, so each sample costs
+ *        the same & there is no square root
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "sensors/accel/units.h"
+#include "error/error.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * Magnitude (mg), below which body is falling & time (ms) it has to last.
+ * Jumps & running strides have short free fall phases too, they are mostly
+ * rejected by the impact & stillness checks
+ */
+#define FALL_FREE_FALL_THRESHOLD 600
+#define FALL_FREE_FALL_DURATION  80
+
+/**
+ * Magnitude (mg), above which an impact is, & time (ms) after free fall it
+ * has to happen within
+ */
+#ifndef FALL_IMPACT_THRESHOLD
+#define FALL_IMPACT_THRESHOLD 2500
+#endif
+#define FALL_IMPACT_WINDOW    1000
+
+/**
+ * Time after impact (ms), that is ignored (bounces, rolling), while peak is
+ * still tracked
+ */
+#define FALL_SETTLE_DURATION 1000
+
+/**
+ * Stillness check. Magnitude has to stay within 1g +- tolerance (mg) for the
+ * duration (ms), only a short active time (ms) is allowed (breathing,
+ * twitches). Getting up or walking on after a trip isn't a fall
+ */
+#define FALL_STILL_TOLERANCE  300
+#define FALL_STILL_DURATION   2000
+#define FALL_STILL_MAX_ACTIVE 200
+
+/**
+ * Min angle between gravity before the fall & while lying still, given as
+ * cos^2 of it (%). 50% is 45 degrees. Stopping after a run has an impact &
+ * stillness too, but body stays upright
+ */
+#define FALL_ORIENTATION_COS2 50
+
+/**
+ * Gravity reference (before the fall) smoothing (EMA, alpha = 1/2^SHIFT),
+ * ~640ms @ 50Hz
+ */
+#define FALL_REF_SHIFT 5
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/**
+ * Fall detector state
+ */
+typedef enum {
+  FALL_STATE_IDLE = 0,
+  FALL_STATE_FREE_FALL,
+  FALL_STATE_IMPACT,
+  FALL_STATE_STILL,
+} fall_state_t;
+
+/* Types ==================================================================== */
+/**
+ * Fall detector context
+ */
+typedef struct {
+  fall_state_t state;
+
+  /** Samples since current state was entered */
+  uint32_t timer;
+
+  /** Free fall samples (in idle state) or active samples (in still state) */
+  uint32_t count;
+
+  /** Peak squared magnitude of impact */
+  uint32_t peak;
+
+  /** Gravity reference (scaled by 2^FALL_REF_SHIFT), updated in idle state */
+  int32_t ref[3];
+  bool    is_seeded;
+
+  /** Sum of samples in still state */
+  int32_t still[3];
+} fall_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize (reset) fall detector
+ *
+ * @param fall Fall detector context
+ */
+error_t fall_init(fall_t * fall);
+
+/**
+ * Process accelerometer sample
+ *
+ * @param fall Fall detector context
+ * @param x, y, z Accelerometer sample (raw units)
+ * @return true if a fall was detected with this sample
+ */
+bool fall_process(fall_t * fall, int16_t x, int16_t y, int16_t z);
+
+/**
+ * Arm detector for impact, as if free fall was just detected. Used, when
+ * samples before the impact are missing (e.g. accelerometer was woken up by
+ * the fall itself). Gravity reference from before is kept for orientation
+ * check
+ *
+ * @param fall Fall detector context
+ * @return E_OK, E_BUSY if a fall is being tracked, E_INVAL if gravity
+ *         reference isn't seeded yet
+ */
+error_t fall_arm_impact(fall_t * fall);
+
+/**
+ * Check, if detector is tracking a fall (free fall, impact or still state)
+ *
+ * @param fall Fall detector context
+ */
+bool fall_is_busy(fall_t * fall);
+
+/**
+ * Get peak impact acceleration of last fall
+ *
+ * @param fall Fall detector context
+ * @return Peak acceleration (0.1g)
+ */
+uint32_t fall_get_peak(fall_t * fall);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,221 @@
+/** ========================================================================= *
+ *
+ * @file mpu6050_ext.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/accel/mpu6050_ext.h"
+#include "error/assertion.h"
+#include "log/log.h"
+
+/* Defines ================================================================== */
+#define LOG_TAG mpu6050
+
+/** MPU6050 Registers */
+#define MPU6050_REG_SMPLRT_DIV   0x19
+#define MPU6050_REG_CONFIG       0x1A
+#define MPU6050_REG_ACCEL_CONFIG 0x1C
+#define MPU6050_REG_MOT_THR      0x1F
+#define MPU6050_REG_MOT_DUR      0x20
+#define MPU6050_REG_FIFO_EN      0x23
+#define MPU6050_REG_INT_PIN_CFG  0x37
+#define MPU6050_REG_INT_ENABLE   0x38
+#define MPU6050_REG_INT_STATUS   0x3A
+#define MPU6050_REG_USER_CTRL    0x6A
+#define MPU6050_REG_FIFO_COUNTH  0x72
+#define MPU6050_REG_FIFO_R_W     0x74
+#define MPU6050_REG_WHO_AM_I     0x75
+
+/** WHO_AM_I register value */
+#define MPU6050_WHO_AM_I 0x68
+
+/** CONFIG register DLPF_CFG field */
+#define MPU6050_DLPF_CFG_MASK 0x07
+#define MPU6050_DLPF_CFG_94HZ 2
+#define MPU6050_DLPF_CFG_44HZ 3
+#define MPU6050_DLPF_CFG_21HZ 4
+
+/** Sample rate base, while DLPF is on (Hz) */
+#define MPU6050_DLPF_RATE 1000
+
+/**
+ * ACCEL_CONFIG register ACCEL_HPF field. Motion detection compares high pass
+ * filtered acceleration with threshold, at 1.25Hz gravity is removed, while
+ * onset of a free fall still passes
+ */
+#define MPU6050_ACCEL_HPF_MASK   0x07
+#define MPU6050_ACCEL_HPF_1_25HZ 3
+
+/** MOT_THR register unit (mg) */
+#define MPU6050_MOT_THR_MG 2
+
+/** INT_PIN_CFG register bits */
+#define MPU6050_INT_PIN_CFG_LEVEL_LOW (1 << 7)
+#define MPU6050_INT_PIN_CFG_OPEN      (1 << 6)
+#define MPU6050_INT_PIN_CFG_LATCH     (1 << 5)
+
+/** INT_ENABLE & INT_STATUS register bits */
+#define MPU6050_INT_MOT (1 << 6)
+
+/** FIFO_EN register bits */
+#define MPU6050_FIFO_EN_ACCEL (1 << 3)
+
+/** USER_CTRL register bits */
+#define MPU6050_USER_CTRL_FIFO_EN    (1 << 6)
+#define MPU6050_USER_CTRL_FIFO_RESET (1 << 2)
+
+/** Size of accelerometer sample in FIFO (x, y & z, big endian) */
+#define MPU6050_FIFO_SAMPLE_SIZE 6
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+static error_t mpu6050_ext_read(mpu6050_ext_t * ext, uint8_t reg, uint8_t * data, size_t size) {
+  ERROR_CHECK_RETURN(i2c_send(ext->i2c, MPU6050_EXT_I2C_ADDR, &reg, 1));
+  return i2c_recv(ext->i2c, MPU6050_EXT_I2C_ADDR, data, size);
+}
+
+static error_t mpu6050_ext_write_reg(mpu6050_ext_t * ext, uint8_t reg, uint8_t value) {
+  uint8_t data[2] = {reg, value};
+  return i2c_send(ext->i2c, MPU6050_EXT_I2C_ADDR, data, sizeof(data));
+}
+
+static error_t mpu6050_ext_update_reg(mpu6050_ext_t * ext, uint8_t reg, uint8_t mask, uint8_t value) {
+  uint8_t current = 0;
+  ERROR_CHECK_RETURN(mpu6050_ext_read(ext, reg, &current, 1));
+  return mpu6050_ext_write_reg(ext, reg, (current & ~mask) | (value & mask));
+}
+
+__STATIC_INLINE error_t mpu6050_ext_reset_fifo(mpu6050_ext_t * ext) {
+  return mpu6050_ext_write_reg(
+    ext, MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_EN | MPU6050_USER_CTRL_FIFO_RESET
+  );
+}
+
+__STATIC_INLINE uint8_t mpu6050_ext_clamp_u8(uint32_t value) {
+  return value > UINT8_MAX ? UINT8_MAX : value;
+}
+
+/* Shared functions ========================================================= */
+error_t mpu6050_ext_init(mpu6050_ext_t * ext, i2c_t * i2c) {
+  ASSERT_RETURN(ext && i2c, E_NULL);
+
+  ext->i2c = i2c;
+
+  uint8_t id = 0;
+  ERROR_CHECK_RETURN(mpu6050_ext_read(ext, MPU6050_REG_WHO_AM_I, &id, 1));
+
+  if (id != MPU6050_WHO_AM_I) {
+    log_error("Unknown device 0x%x", id);
+    return E_INVAL;
+  }
+
+  return E_OK;
+}
+
+error_t mpu6050_ext_enable_fifo(mpu6050_ext_t * ext, uint32_t rate) {
+  ASSERT_RETURN(ext, E_NULL);
+  ASSERT_RETURN(rate && rate <= MPU6050_DLPF_RATE && !(MPU6050_DLPF_RATE % rate), E_INVAL);
+
+  uint8_t dlpf = rate > 200 ? MPU6050_DLPF_CFG_94HZ : rate > 100 ? MPU6050_DLPF_CFG_44HZ : MPU6050_DLPF_CFG_21HZ;
+
+  ERROR_CHECK_RETURN(mpu6050_ext_update_reg(ext, MPU6050_REG_CONFIG, MPU6050_DLPF_CFG_MASK, dlpf));
+  ERROR_CHECK_RETURN(mpu6050_ext_write_reg(ext, MPU6050_REG_SMPLRT_DIV, MPU6050_DLPF_RATE / rate - 1));
+  ERROR_CHECK_RETURN(mpu6050_ext_write_reg(ext, MPU6050_REG_FIFO_EN, MPU6050_FIFO_EN_ACCEL));
+
+  return mpu6050_ext_reset_fifo(ext);
+}
+
+error_t mpu6050_ext_suspend_fifo(mpu6050_ext_t * ext) {
+  ASSERT_RETURN(ext, E_NULL);
+
+  return mpu6050_ext_write_reg(ext, MPU6050_REG_USER_CTRL, 0);
+}
+
+error_t mpu6050_ext_resume_fifo(mpu6050_ext_t * ext) {
+  ASSERT_RETURN(ext, E_NULL);
+
+  return mpu6050_ext_reset_fifo(ext);
+}
+
+error_t mpu6050_ext_enable_motion_irq(mpu6050_ext_t * ext, uint32_t threshold, uint32_t duration) {
+  ASSERT_RETURN(ext, E_NULL);
+
+  uint8_t thr = mpu6050_ext_clamp_u8(threshold / MPU6050_MOT_THR_MG);
+  uint8_t dur = mpu6050_ext_clamp_u8(duration);
+
+  ASSERT_RETURN(thr && dur, E_INVAL);
+
+  ERROR_CHECK_RETURN(
+    mpu6050_ext_update_reg(ext, MPU6050_REG_ACCEL_CONFIG, MPU6050_ACCEL_HPF_MASK, MPU6050_ACCEL_HPF_1_25HZ)
+  );
+
+  ERROR_CHECK_RETURN(mpu6050_ext_write_reg(ext, MPU6050_REG_MOT_THR, thr));
+  ERROR_CHECK_RETURN(mpu6050_ext_write_reg(ext, MPU6050_REG_MOT_DUR, dur));
+
+  // INT is held, until INT_STATUS is read, so an edge can't be missed while EXTI is masked
+  ERROR_CHECK_RETURN(
+    mpu6050_ext_write_reg(
+      ext,
+      MPU6050_REG_INT_PIN_CFG,
+      MPU6050_INT_PIN_CFG_LEVEL_LOW | MPU6050_INT_PIN_CFG_OPEN | MPU6050_INT_PIN_CFG_LATCH
+    )
+  );
+
+  return mpu6050_ext_write_reg(ext, MPU6050_REG_INT_ENABLE, MPU6050_INT_MOT);
+}
+
+error_t mpu6050_ext_poll_motion_irq(mpu6050_ext_t * ext, bool * motion) {
+  ASSERT_RETURN(ext && motion, E_NULL);
+
+  uint8_t status = 0;
+  ERROR_CHECK_RETURN(mpu6050_ext_read(ext, MPU6050_REG_INT_STATUS, &status, 1));
+
+  *motion = status & MPU6050_INT_MOT;
+
+  return E_OK;
+}
+
+error_t mpu6050_ext_read_fifo(mpu6050_ext_t * ext, acceleration_pos_t * samples, size_t * size) {
+  ASSERT_RETURN(ext && samples && size, E_NULL);
+
+  uint8_t count[2] = {0};
+  ERROR_CHECK_RETURN(mpu6050_ext_read(ext, MPU6050_REG_FIFO_COUNTH, count, sizeof(count)));
+
+  size_t bytes = (count[0] << 8) | count[1];
+
+  // Full FIFO has overwritten oldest bytes, so sample boundaries are lost
+  if (bytes >= MPU6050_EXT_FIFO_SIZE) {
+    *size = 0;
+    ERROR_CHECK_RETURN(mpu6050_ext_reset_fifo(ext));
+    return E_OVERFLOW;
+  }
+
+  size_t n = bytes / MPU6050_FIFO_SAMPLE_SIZE;
+  n = n < *size ? n : *size;
+
+  *size = n;
+
+  if (!n) {
+    return E_OK;
+  }
+
+  // Samples have the same layout as in FIFO, so they are read in place & byte swapped
+  uint8_t * data = (uint8_t *) samples;
+
+  ERROR_CHECK_RETURN(mpu6050_ext_read(ext, MPU6050_REG_FIFO_R_W, data, n * MPU6050_FIFO_SAMPLE_SIZE));
+
+  for (size_t i = 0; i < n; ++i, data += MPU6050_FIFO_SAMPLE_SIZE) {
+    samples[i].x = (int16_t) ((data[0] << 8) | data[1]);
+    samples[i].y = (int16_t) ((data[2] << 8) | data[3]);
+    samples[i].z = (int16_t) ((data[4] << 8) | data[5]);
+  }
+
+  return E_OK;
+}
@@ -0,0 +1,110 @@
+/** ========================================================================= *
+ *
+ * @file mpu6050_ext.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief MPU6050 register level extensions, for features that aren't
+ *        covered by SDK driver
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "sensors/accel/accel.h"
+#include "error/error.h"
+#include "i2c/i2c.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/** MPU6050 I2C Address (AD0 is low) */
+#define MPU6050_EXT_I2C_ADDR 0x68
+
+/** FIFO size (bytes) */
+#define MPU6050_EXT_FIFO_SIZE 1024
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * MPU6050 Extensions Context
+ */
+typedef struct {
+  /** I2C Handle, sensor is connected to */
+  i2c_t * i2c;
+} mpu6050_ext_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize MPU6050 Extensions Context
+ *
+ * @param ext MPU6050 Extensions Context
+ * @param i2c I2C Handle, sensor is connected to
+ */
+error_t mpu6050_ext_init(mpu6050_ext_t * ext, i2c_t * i2c);
+
+/**
+ * Sample accelerometer at a fixed rate into FIFO (accelerometer only, 6 bytes
+ * per sample). Digital low pass filter is set below half of the rate
+ *
+ * @note FIFO holds 170 samples (3.4s @ 50Hz), it has to be read before
+ *
+ * @param ext MPU6050 Extensions Context
+ * @param rate Sample rate (Hz), divisor of 1000
+ */
+error_t mpu6050_ext_enable_fifo(mpu6050_ext_t * ext, uint32_t rate);
+
+/**
+ * Stop writing samples into FIFO (it's not reset, until resumed)
+ *
+ * @param ext MPU6050 Extensions Context
+ */
+error_t mpu6050_ext_suspend_fifo(mpu6050_ext_t * ext);
+
+/**
+ * Reset FIFO & start writing samples into it again
+ *
+ * @param ext MPU6050 Extensions Context
+ */
+error_t mpu6050_ext_resume_fifo(mpu6050_ext_t * ext);
+
+/**
+ * Enable motion detection interrupt. It's raised, when high pass filtered
+ * acceleration on any axis exceeds threshold for a duration. INT pin is
+ * open-drain, active low & latched, until mpu6050_ext_poll_motion_irq
+ *
+ * @param ext MPU6050 Extensions Context
+ * @param threshold Motion threshold (mg), 2mg resolution. Clamped to 510mg
+ * @param duration Motion duration (ms). Clamped to 255ms
+ */
+error_t mpu6050_ext_enable_motion_irq(mpu6050_ext_t * ext, uint32_t threshold, uint32_t duration);
+
+/**
+ * Read interrupt status. Reading it also de-asserts INT pin
+ *
+ * @param ext MPU6050 Extensions Context
+ * @param motion Set, if motion was detected since last poll
+ */
+error_t mpu6050_ext_poll_motion_irq(mpu6050_ext_t * ext, bool * motion);
+
+/**
+ * Read accelerometer samples from FIFO, in a single burst
+ *
+ * @param ext MPU6050 Extensions Context
+ * @param samples Where to put samples
+ * @param size Max number of samples, replaced with number of read ones.
+ *             Samples that don't fit are left in FIFO
+ * @return E_OVERFLOW if FIFO has overflown (it's reset & samples are lost)
+ */
+error_t mpu6050_ext_read_fifo(mpu6050_ext_t * ext, acceleration_pos_t * samples, size_t * size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,130 @@
+/** ========================================================================= *
+ *
+ * @file posture.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/accel/posture.h"
+#include "error/assertion.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+#define POSTURE_AXIS_SIDE (3 - POSTURE_AXIS_UP - POSTURE_AXIS_FRONT)
+
+/** Hysteresis, as raw units */
+#define POSTURE_HYSTERESIS_LSB ACCELERATION_MG_TO_LSB(POSTURE_HYSTERESIS)
+
+#if POSTURE_AXIS_UP == POSTURE_AXIS_FRONT || POSTURE_AXIS_UP > 2 || POSTURE_AXIS_FRONT > 2
+#error "POSTURE_AXIS_UP & POSTURE_AXIS_FRONT must be different axes (0 - 2)"
+#endif
+
+/* Macros =================================================================== */
+#define POSTURE_ABS(__v) ((__v) < 0 ? -(__v) : (__v))
+
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+static const char * posture_str[] = {
+  [POSTURE_UNKNOWN] = "unknown",
+  [POSTURE_UPRIGHT] = "upright",
+  [POSTURE_PRONE]   = "prone",
+  [POSTURE_SUPINE]  = "supine",
+  [POSTURE_SIDE]    = "side",
+};
+
+/* Private functions ======================================================== */
+/**
+ * Gravity along body axis of a posture (raw units). It's 0 for unknown
+ * posture, so any posture replaces it
+ */
+__STATIC_INLINE int32_t posture_component(posture_class_t posture, int32_t up, int32_t front, int32_t side) {
+  switch (posture) {
+    case POSTURE_UPRIGHT: return up;
+    case POSTURE_PRONE:   return -front;
+    case POSTURE_SUPINE:  return front;
+    case POSTURE_SIDE:    return POSTURE_ABS(side);
+    default:              return 0;
+  }
+}
+
+/**
+ * Posture of the body axis gravity is mostly aligned with
+ */
+__STATIC_INLINE posture_class_t posture_classify(int32_t up, int32_t front, int32_t side) {
+  int32_t abs_up    = POSTURE_ABS(up);
+  int32_t abs_front = POSTURE_ABS(front);
+  int32_t abs_side  = POSTURE_ABS(side);
+
+  if (abs_up >= abs_front && abs_up >= abs_side) {
+    return up > 0 ? POSTURE_UPRIGHT : POSTURE_UNKNOWN;
+  }
+
+  if (abs_front >= abs_side) {
+    return front > 0 ? POSTURE_SUPINE : POSTURE_PRONE;
+  }
+
+  return POSTURE_SIDE;
+}
+
+/* Shared functions ========================================================= */
+error_t posture_init(posture_t * posture) {
+  ASSERT_RETURN(posture, E_NULL);
+
+  memset(posture, 0, sizeof(posture_t));
+
+  return E_OK;
+}
+
+bool posture_process(posture_t * posture, int16_t x, int16_t y, int16_t z) {
+  int32_t v[3] = {x, y, z};
+
+  for (uint32_t i = 0; i < 3; ++i) {
+    if (!posture->is_seeded) {
+      posture->gravity[i] = v[i] << POSTURE_LPF_SHIFT;
+    }
+
+    posture->gravity[i] += v[i] - (posture->gravity[i] >> POSTURE_LPF_SHIFT);
+  }
+
+  posture->is_seeded = true;
+
+  int32_t up    = POSTURE_AXIS_UP_SIGN * (posture->gravity[POSTURE_AXIS_UP] >> POSTURE_LPF_SHIFT);
+  int32_t front = POSTURE_AXIS_FRONT_SIGN * (posture->gravity[POSTURE_AXIS_FRONT] >> POSTURE_LPF_SHIFT);
+  int32_t side  = posture->gravity[POSTURE_AXIS_SIDE] >> POSTURE_LPF_SHIFT;
+
+  posture_class_t candidate = posture_classify(up, front, side);
+
+  if (candidate == posture->posture) {
+    return false;
+  }
+
+  int32_t current = posture_component(posture->posture, up, front, side);
+  int32_t next    = posture_component(candidate, up, front, side);
+
+  // Upside down has no axis of its own, so it's entered with the same margin
+  if (candidate == POSTURE_UNKNOWN) {
+    next = -up;
+  }
+
+  if (next < current + POSTURE_HYSTERESIS_LSB) {
+    return false;
+  }
+
+  posture->posture = candidate;
+
+  return true;
+}
+
+posture_class_t posture_get(posture_t * posture) {
+  ASSERT_RETURN(posture, POSTURE_UNKNOWN);
+
+  return posture->posture;
+}
+
+const char * posture_to_str(posture_class_t posture) {
+  return posture < sizeof(posture_str) / sizeof(posture_str[0]) ? posture_str[posture] : "?";
+}
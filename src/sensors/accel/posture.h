@@ -0,0 +1,115 @@
+/** ========================================================================= *
+ *
+ * @file posture.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Posture classifier (upright, prone, supine, on side). Gravity vector
+ *        is low pass filtered from accelerometer samples & classified by the
+ *        body axis it is aligned with. Posture changes only, when the new axis
+ *        dominates the current one by a margin (hysteresis)
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "sensors/accel/units.h"
+#include "error/error.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * Accelerometer mounting: axis (0 - x, 1 - y, 2 - z) & sign of body axes.
+ * "Up" points to the head, "front" points out of the chest. Third axis is the
+ * lateral one
+ */
+#ifndef POSTURE_AXIS_UP
+#define POSTURE_AXIS_UP         1
+#define POSTURE_AXIS_UP_SIGN    1
+#endif
+
+#ifndef POSTURE_AXIS_FRONT
+#define POSTURE_AXIS_FRONT      2
+#define POSTURE_AXIS_FRONT_SIGN 1
+#endif
+
+/**
+ * Gravity low pass filter (EMA, alpha = 1/2^SHIFT), ~1.3s @ 50Hz. Steps &
+ * vibrations are filtered out, while lying down is still picked up quickly
+ */
+#define POSTURE_LPF_SHIFT 6
+
+/**
+ * Margin (mg), by which gravity along the new body axis has to exceed gravity
+ * along the current one, before posture changes. 250mg is ~10 degrees past
+ * the 45 degree boundary
+ */
+#define POSTURE_HYSTERESIS 250
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/**
+ * Posture class
+ */
+typedef enum {
+  POSTURE_UNKNOWN = 0,
+  POSTURE_UPRIGHT,
+  POSTURE_PRONE,
+  POSTURE_SUPINE,
+  POSTURE_SIDE,
+} posture_class_t;
+
+/* Types ==================================================================== */
+/**
+ * Posture classifier context
+ */
+typedef struct {
+  /** Gravity vector (scaled by 2^POSTURE_LPF_SHIFT) */
+  int32_t gravity[3];
+  bool    is_seeded;
+
+  /** Current posture */
+  posture_class_t posture;
+} posture_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize (reset) posture classifier
+ *
+ * @param posture Posture classifier context
+ */
+error_t posture_init(posture_t * posture);
+
+/**
+ * Process accelerometer sample
+ *
+ * @param posture Posture classifier context
+ * @param x, y, z Accelerometer sample (raw units)
+ * @return true if posture has changed with this sample
+ */
+bool posture_process(posture_t * posture, int16_t x, int16_t y, int16_t z);
+
+/**
+ * Get current posture
+ *
+ * @param posture Posture classifier context
+ * @return POSTURE_UNKNOWN until the first sample or while upside down
+ */
+posture_class_t posture_get(posture_t * posture);
+
+/**
+ * Get posture name
+ *
+ * @param posture Posture class
+ */
+const char * posture_to_str(posture_class_t posture);
+
+#ifdef __cplusplus
+}
+#endif
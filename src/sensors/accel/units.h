@@ -0,0 +1,72 @@
+/** ========================================================================= *
+ *
+ * @file units.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Accelerometer sample rate & scale. Detector thresholds are given in
+ *        mg & windows in ms, they are converted to raw units with helpers below
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "error/error.h"
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * Rate of accelerometer samples (Hz), MPU6050 FIFO is sampled at it
+ */
+#ifndef ACCELERATION_SAMPLE_RATE_HZ
+#define ACCELERATION_SAMPLE_RATE_HZ 50
+#endif
+
+/**
+ * Accelerometer resolution (LSB/g), matches MPU6050_ACCEL_AFS_SEL_16G
+ */
+#define ACCELERATION_LSB_PER_G 2048
+
+/* Macros =================================================================== */
+/**
+ * Number of samples in a time interval
+ *
+ * @param __ms Time interval (ms)
+ */
+#define ACCELERATION_MS_TO_SAMPLES(__ms) ((__ms) * ACCELERATION_SAMPLE_RATE_HZ / 1000)
+
+/**
+ * Raw accelerometer value of an acceleration
+ *
+ * @param __mg Acceleration (mg)
+ */
+#define ACCELERATION_MG_TO_LSB(__mg) ((__mg) * ACCELERATION_LSB_PER_G / 1000)
+
+/**
+ * Squared raw magnitude of an acceleration, for comparing with squared vector
+ * magnitude (no square root)
+ *
+ * @param __mg Acceleration (mg)
+ */
+#define ACCELERATION_MG_TO_SQ(__mg) \
+  ((uint32_t) ACCELERATION_MG_TO_LSB(__mg) * ACCELERATION_MG_TO_LSB(__mg))
+
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Squared vector magnitude (raw units). Max is 3 * 2^30, so it fits into
+ * uint32_t
+ */
+__STATIC_INLINE uint32_t acceleration_magnitude(int32_t x, int32_t y, int32_t z) {
+  return (uint32_t) (x * x) + (uint32_t) (y * y) + (uint32_t) (z * z);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,233 @@
+/** ========================================================================= *
+ *
+ * @file agc.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/pulse/agc.h"
+#include "error/assertion.h"
+#include "log/log.h"
+
+/* Defines ================================================================== */
+#define LOG_TAG agc
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/**
+ * Result of single channel adjustment
+ */
+typedef enum {
+  AGC_ADJUST_NONE = 0,
+  AGC_ADJUST_CHANGED,
+  AGC_ADJUST_NEED_LESS_GAIN, // Current is at min, but level is still too high
+  AGC_ADJUST_NEED_MORE_GAIN, // Current is at max, but level is still too low
+} agc_adjust_t;
+
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+__STATIC_INLINE void agc_channel_process(agc_channel_t * ch, int32_t value) {
+  // Seed DC estimate with first sample, so it doesn't have to settle from 0
+  if (!ch->dc) {
+    ch->dc = value << 8;
+  }
+
+  int32_t ac = (value << 8) - ch->dc;
+  ch->dc += ac >> AGC_DC_SHIFT;
+  ch->ac += ((ac < 0 ? -ac : ac) - ch->ac) >> AGC_AC_SHIFT;
+
+  if ((uint32_t) value > ch->max) {
+    ch->max = value;
+  }
+}
+
+__STATIC_INLINE void agc_channel_reset(agc_channel_t * ch) {
+  ch->dc  = 0;
+  ch->ac  = 0;
+  ch->max = 0;
+}
+
+/**
+ * Index of the highest LED current level, that doesn't exceed current
+ */
+static uint8_t agc_level(agc_t * agc, uint8_t current) {
+  uint8_t level = 0;
+
+  while (level + 1 < agc->level_count && agc->levels[level + 1] <= current * 10) {
+    level++;
+  }
+
+  return level;
+}
+
+/**
+ * LED current of a level (mA), rounded up, so sensor quantizes it back to
+ * the same level
+ */
+__STATIC_INLINE uint8_t agc_level_current(agc_t * agc, int32_t level) {
+  return (uint8_t) ((agc->levels[level] + 9) / 10);
+}
+
+/**
+ * LED current moved by delta (mA) & limited, that sensor drives at a
+ * different level, than current one. Returns current, if there's no such
+ * level within limits
+ */
+static uint8_t agc_next_current(agc_t * agc, uint8_t current, int32_t delta) {
+  int32_t target = current + delta;
+
+  if (target < AGC_MIN_CURRENT) {
+    target = AGC_MIN_CURRENT;
+  } else if (target > AGC_MAX_CURRENT) {
+    target = AGC_MAX_CURRENT;
+  }
+
+  if (!agc->levels) {
+    return (uint8_t) target;
+  }
+
+  int32_t level = agc_level(agc, current);
+  int32_t next  = agc_level(agc, (uint8_t) target);
+
+  // Step is too small to change register value, so it's at least one level
+  if (next == level) {
+    next = delta < 0 ? level - 1 : level + 1;
+  }
+
+  // Levels outside of limits are skipped
+  while (next >= 0 && next < agc->level_count && agc_level_current(agc, next) < AGC_MIN_CURRENT) {
+    next++;
+  }
+
+  while (next >= 0 && next < agc->level_count && agc_level_current(agc, next) > AGC_MAX_CURRENT) {
+    next--;
+  }
+
+  if (next < 0 || next >= agc->level_count || next == level) {
+    return current;
+  }
+
+  return agc_level_current(agc, next);
+}
+
+static agc_adjust_t agc_channel_adjust(agc_t * agc, agc_channel_t * ch) {
+  uint32_t dc = ch->dc >> 8;
+  uint32_t ac = ch->ac >> 8;
+
+  // Large steps, when level is out of target window
+  int32_t step = ch->current >> 2 ? ch->current >> 2 : 1;
+
+  if (ch->max >= agc->saturation || dc > agc->dc_high) {
+    uint8_t current = agc_next_current(agc, ch->current, -step);
+
+    if (current == ch->current) {
+      return AGC_ADJUST_NEED_LESS_GAIN;
+    }
+
+    ch->current = current;
+    return AGC_ADJUST_CHANGED;
+  }
+
+  if (dc < agc->dc_low) {
+    uint8_t current = agc_next_current(agc, ch->current, step);
+
+    if (current == ch->current) {
+      return AGC_ADJUST_NEED_MORE_GAIN;
+    }
+
+    ch->current = current;
+    return AGC_ADJUST_CHANGED;
+  }
+
+  // Level is inside target window - fine tune by one level, towards lowest usable current
+  uint8_t lower  = agc_next_current(agc, ch->current, -1);
+  uint8_t higher = agc_next_current(agc, ch->current, 1);
+
+  if (ac > agc->ac_min * 2 && lower != ch->current &&
+      dc - dc * (ch->current - lower) / ch->current >= agc->dc_low) {
+    ch->current = lower;
+    return AGC_ADJUST_CHANGED;
+  }
+
+  if (ac < agc->ac_min && higher != ch->current &&
+      dc + dc * (higher - ch->current) / ch->current <= agc->dc_high) {
+    ch->current = higher;
+    return AGC_ADJUST_CHANGED;
+  }
+
+  return AGC_ADJUST_NONE;
+}
+
+/* Shared functions ========================================================= */
+error_t agc_init(agc_t * agc, agc_cfg_t * cfg) {
+  ASSERT_RETURN(agc && cfg, E_NULL);
+  ASSERT_RETURN(cfg->ranges && cfg->range < cfg->ranges, E_INVAL);
+  ASSERT_RETURN(cfg->current >= AGC_MIN_CURRENT && cfg->current <= AGC_MAX_CURRENT, E_INVAL);
+  ASSERT_RETURN(!cfg->levels || cfg->level_count, E_INVAL);
+
+  memset(agc, 0, sizeof(agc_t));
+
+  agc->dc_low     = (uint64_t) cfg->full_scale * AGC_DC_LOW_PERMILLE / 1000;
+  agc->dc_high    = (uint64_t) cfg->full_scale * AGC_DC_HIGH_PERMILLE / 1000;
+  agc->saturation = (uint64_t) cfg->full_scale * AGC_SATURATION_PERMILLE / 1000;
+  agc->ac_min     = (uint64_t) cfg->full_scale * AGC_AC_MIN_BP / 10000;
+
+  agc->ranges = cfg->ranges;
+  agc->range  = cfg->range;
+
+  agc->levels      = cfg->levels;
+  agc->level_count = cfg->levels ? cfg->level_count : 0;
+  agc->settle = AGC_SETTLE_SAMPLES;
+
+  agc->ir.current = cfg->current;
+
+  // Red LED is used in SpO2 mode only, it stays off otherwise
+  agc->red.current = cfg->red ? cfg->current : 0;
+
+  return E_OK;
+}
+
+error_t agc_process_block(agc_t * agc, const max3010x_sample_t * samples, size_t size) {
+  ASSERT_RETURN(agc && samples, E_NULL);
+
+  for (size_t i = 0; i < size; ++i) {
+    agc_channel_process(&agc->ir, (int32_t) samples[i].ir);
+
+    if (agc->red.current) {
+      agc_channel_process(&agc->red, (int32_t) samples[i].red);
+    }
+  }
+
+  if (agc->settle > size) {
+    agc->settle -= size;
+    return E_AGAIN;
+  }
+
+  agc_adjust_t ir  = agc_channel_adjust(agc, &agc->ir);
+  agc_adjust_t red = agc->red.current ? agc_channel_adjust(agc, &agc->red) : ir;
+
+  bool changed = ir == AGC_ADJUST_CHANGED || red == AGC_ADJUST_CHANGED;
+
+  // ADC range is shared - it is widened if any channel is too strong, narrowed only if both are too weak
+  if ((ir == AGC_ADJUST_NEED_LESS_GAIN || red == AGC_ADJUST_NEED_LESS_GAIN) && agc->range + 1 < agc->ranges) {
+    agc->range++;
+    changed = true;
+  } else if (ir == AGC_ADJUST_NEED_MORE_GAIN && red == AGC_ADJUST_NEED_MORE_GAIN && agc->range) {
+    agc->range--;
+    changed = true;
+  }
+
+  agc_channel_reset(&agc->ir);
+  agc_channel_reset(&agc->red);
+  agc->settle = AGC_SETTLE_SAMPLES;
+
+  if (changed) {
+    log_debug("ir=%u mA red=%u mA range=%u", agc->ir.current, agc->red.current, agc->range);
+  }
+
+  return changed ? E_OK : E_AGAIN;
+}
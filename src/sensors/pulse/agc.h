@@ -0,0 +1,159 @@
+/** ========================================================================= *
+ *
+ * @file agc.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief MAX3010x LED current AGC (Automatic Gain Control). Keeps DC level of
+ *        each channel inside a target window, using the lowest LED current
+ *        that still gives usable AC amplitude
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "max3010x/max3010x.h"
+#include "error/error.h"
+#include "sensors/pulse/sample_rate.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * DC target window & saturation level (permille of ADC full scale)
+ */
+#define AGC_DC_LOW_PERMILLE        250
+#define AGC_DC_HIGH_PERMILLE       750
+#define AGC_SATURATION_PERMILLE    950
+
+/**
+ * Min usable AC amplitude (1/10000 of ADC full scale). Current is lowered,
+ * while AC amplitude stays above 2x of this value
+ */
+#define AGC_AC_MIN_BP 5
+
+/**
+ * LED current limits (mA)
+ */
+#define AGC_MIN_CURRENT 2
+#define AGC_MAX_CURRENT 50
+
+/**
+ * Number of samples to wait after each adjustment, before next one (so
+ * DC & AC estimates settle)
+ */
+#define AGC_SETTLE_SAMPLES PULSE_MS_TO_SAMPLES(2000)
+
+/**
+ * DC & AC estimates smoothing (EMA, alpha = 1/2^SHIFT), ~320ms
+ */
+#define AGC_DC_SHIFT PULSE_MS_TO_SHIFT(320)
+#define AGC_AC_SHIFT PULSE_MS_TO_SHIFT(320)
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Single channel (LED) context
+ */
+typedef struct {
+  /** LED current (mA) */
+  uint8_t current;
+
+  /** DC estimate (Q8) */
+  int32_t dc;
+
+  /** AC amplitude estimate (EMA of |AC|, Q8) */
+  int32_t ac;
+
+  /** Max raw value since last adjustment */
+  uint32_t max;
+} agc_channel_t;
+
+/**
+ * AGC context
+ */
+typedef struct {
+  /** Thresholds in raw ADC units, calculated from full scale */
+  uint32_t dc_low;
+  uint32_t dc_high;
+  uint32_t saturation;
+  uint32_t ac_min;
+
+  /** Number of available ADC ranges (1 - if range can't be changed) */
+  uint8_t ranges;
+
+  /** LED current levels, sensor can drive (see agc_cfg_t) */
+  const uint16_t * levels;
+  uint8_t          level_count;
+
+  /** Current ADC range */
+  uint8_t range;
+
+  /** Samples left until next adjustment */
+  uint32_t settle;
+
+  /** Channels */
+  agc_channel_t ir;
+  agc_channel_t red;
+} agc_t;
+
+/**
+ * AGC config
+ */
+typedef struct {
+  /** ADC full scale (raw value) */
+  uint32_t full_scale;
+
+  /** Number of available ADC ranges (1 - if range can't be changed) */
+  uint8_t ranges;
+
+  /** Initial ADC range */
+  uint8_t range;
+
+  /** Initial LED current (mA) */
+  uint8_t current;
+
+  /**
+   * LED current levels, sensor can drive (0.1 mA, ascending) & their number.
+   * Current is stepped from level to level, rounded up to mA. NULL - every
+   * whole mA is a distinct level
+   */
+  const uint16_t * levels;
+  uint8_t          level_count;
+
+  /** Red channel is used (SpO2 mode) */
+  bool red;
+} agc_cfg_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize AGC
+ *
+ * @param agc AGC context
+ * @param cfg AGC config
+ */
+error_t agc_init(agc_t * agc, agc_cfg_t * cfg);
+
+/**
+ * Process a block of samples (whole MAX3010x FIFO batch)
+ *
+ * When E_OK is returned, new LED currents (agc->ir.current, agc->red.current)
+ * and ADC range (agc->range) have to be applied to sensor
+ *
+ * @param agc AGC context
+ * @param samples MAX3010x samples
+ * @param size Number of samples
+ * @return E_OK if settings were changed, E_AGAIN if not
+ */
+error_t agc_process_block(agc_t * agc, const max3010x_sample_t * samples, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
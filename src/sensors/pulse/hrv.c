@@ -0,0 +1,104 @@
+/** ========================================================================= *
+ *
+ * @file hrv.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/pulse/hrv.h"
+#include "util/isqrt.h"
+#include "error/assertion.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+/**
+ * Square root of Q8 value, rounded to integer
+ */
+__STATIC_INLINE uint32_t hrv_sqrt_q8(uint32_t value) {
+  return (isqrt(value) + 8) >> 4;
+}
+
+/* Shared functions ========================================================= */
+error_t hrv_init(hrv_t * hrv) {
+  ASSERT_RETURN(hrv, E_NULL);
+
+  memset(hrv, 0, sizeof(hrv_t));
+
+  return E_OK;
+}
+
+error_t hrv_add_interval(hrv_t * hrv, uint32_t interval) {
+  ASSERT_RETURN(hrv, E_NULL);
+
+  int32_t x = interval << 8;
+
+  if (!hrv->intervals) {
+    hrv->mean = x;
+    hrv->var  = 0;
+  } else {
+    // Exponentially weighted Welford: var = (1 - alpha) * (var + diff * alpha * diff)
+    int32_t  diff = x - hrv->mean;
+    int32_t  incr = diff >> HRV_EMA_SHIFT;
+    uint32_t var  = hrv->var + (uint32_t) (((int64_t) diff * incr) >> 8);
+
+    hrv->mean += incr;
+    hrv->var   = var - (var >> HRV_EMA_SHIFT);
+  }
+
+  if (hrv->intervals < HRV_MIN_INTERVALS) {
+    hrv->intervals++;
+  }
+
+  if (hrv->prev) {
+    uint32_t diff = interval > hrv->prev ? interval - hrv->prev : hrv->prev - interval;
+    int32_t  sq   = (diff * diff) << 8;
+    int32_t  nn50 = diff > HRV_NN50_THRESHOLD ? (1 << 16) : 0;
+
+    // First difference seeds accumulators, so they don't have to rise from 0
+    if (!hrv->diffs) {
+      hrv->msd  = sq;
+      hrv->nn50 = nn50;
+    } else {
+      hrv->msd  += (sq - (int32_t) hrv->msd) >> HRV_EMA_SHIFT;
+      hrv->nn50 += (nn50 - (int32_t) hrv->nn50) >> HRV_EMA_SHIFT;
+    }
+
+    if (hrv->diffs < HRV_MIN_INTERVALS) {
+      hrv->diffs++;
+    }
+  }
+
+  hrv->prev = interval;
+
+  return E_OK;
+}
+
+error_t hrv_break(hrv_t * hrv) {
+  ASSERT_RETURN(hrv, E_NULL);
+
+  hrv->prev = 0;
+
+  return E_OK;
+}
+
+error_t hrv_get(hrv_t * hrv, hrv_metrics_t * metrics) {
+  ASSERT_RETURN(hrv && metrics, E_NULL);
+
+  if (hrv->intervals < HRV_MIN_INTERVALS || hrv->diffs < HRV_MIN_INTERVALS) {
+    return E_AGAIN;
+  }
+
+  metrics->rmssd = hrv_sqrt_q8(hrv->msd);
+  metrics->sdnn  = hrv_sqrt_q8(hrv->var);
+  metrics->pnn50 = (hrv->nn50 * 100 + (1 << 15)) >> 16;
+
+  return E_OK;
+}
@@ -0,0 +1,116 @@
+/** ========================================================================= *
+ *
+ * @file hrv.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Heart Rate Variability. RMSSD, SDNN & pNN50 over beat (NN) intervals,
+ *        updated per beat with exponentially weighted Welford accumulators
+ *        (fixed point, no float & no division)
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "error/error.h"
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * Accumulators smoothing (alpha = 1/2^SHIFT)
+ * 64 beats ~ 1 min, which is the shortest window HRV is usually taken over
+ */
+#define HRV_EMA_SHIFT 6
+
+/**
+ * Number of intervals, before metrics are reported
+ */
+#define HRV_MIN_INTERVALS 16
+
+/**
+ * Successive interval difference, that is counted by pNN50 (ms)
+ */
+#define HRV_NN50_THRESHOLD 50
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * HRV context
+ */
+typedef struct {
+  /** Mean interval (ms, Q8) */
+  int32_t mean;
+
+  /** Interval variance (ms^2, Q8) */
+  uint32_t var;
+
+  /** Mean squared successive difference (ms^2, Q8) */
+  uint32_t msd;
+
+  /** Share of successive differences above HRV_NN50_THRESHOLD (Q16) */
+  uint32_t nn50;
+
+  /** Previous interval (ms), 0 if next interval isn't successive to it */
+  uint32_t prev;
+
+  /** Number of intervals & successive differences (saturate at HRV_MIN_INTERVALS) */
+  uint32_t intervals;
+  uint32_t diffs;
+} hrv_t;
+
+/**
+ * HRV metrics
+ */
+typedef struct {
+  /** Root mean square of successive differences (ms) */
+  uint32_t rmssd;
+
+  /** Standard deviation of intervals (ms) */
+  uint32_t sdnn;
+
+  /** Share of successive differences above 50 ms (%) */
+  uint32_t pnn50;
+} hrv_metrics_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize (reset) HRV context
+ *
+ * @param hrv HRV context
+ */
+error_t hrv_init(hrv_t * hrv);
+
+/**
+ * Add beat interval
+ *
+ * @param hrv HRV context
+ * @param interval Beat interval (ms)
+ */
+error_t hrv_add_interval(hrv_t * hrv, uint32_t interval);
+
+/**
+ * Mark a gap (missed or rejected beat), so next interval isn't used in
+ * successive differences
+ *
+ * @param hrv HRV context
+ */
+error_t hrv_break(hrv_t * hrv);
+
+/**
+ * Get HRV metrics
+ *
+ * @param hrv HRV context
+ * @param metrics Where to put metrics
+ * @return E_OK on success, E_AGAIN - if there are not enough intervals yet
+ */
+error_t hrv_get(hrv_t * hrv, hrv_metrics_t * metrics);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,381 @@
+/** ========================================================================= *
+ *
+ * @file max3010x_ext.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/pulse/max3010x_ext.h"
+#include "error/assertion.h"
+#include "log/log.h"
+
+/* Defines ================================================================== */
+#define LOG_TAG max3010x
+
+/** MAX30100 Registers */
+#define MAX30100_REG_INT_ENABLE   0x01
+#define MAX30100_REG_FIFO_WR_PTR  0x02
+#define MAX30100_REG_OVF_COUNTER  0x03
+#define MAX30100_REG_FIFO_RD_PTR  0x04
+#define MAX30100_REG_FIFO_DATA    0x05
+#define MAX30100_REG_MODE_CONFIG  0x06
+#define MAX30100_REG_LED_CONFIG   0x09
+
+/** MAX30102 Registers */
+#define MAX30102_REG_INT_ENABLE   0x02
+#define MAX30102_REG_FIFO_WR_PTR  0x04
+#define MAX30102_REG_OVF_COUNTER  0x05
+#define MAX30102_REG_FIFO_RD_PTR  0x06
+#define MAX30102_REG_FIFO_DATA    0x07
+#define MAX30102_REG_FIFO_CONFIG  0x08
+#define MAX30102_REG_MODE_CONFIG  0x09
+#define MAX30102_REG_SPO2_CONFIG  0x0A
+#define MAX30102_REG_LED1_PA      0x0C // Red
+#define MAX30102_REG_LED2_PA      0x0D // IR
+
+/** Common Registers */
+#define MAX3010X_REG_PART_ID     0xFF
+
+/** OVF_COUNTER register mask */
+#define MAX3010X_OVF_COUNTER_MASK 0x1F
+
+/** Shutdown bit of MODE_CONFIG register (same for both parts) */
+#define MAX3010X_MODE_SHDN (1 << 7)
+
+/** MODE field of MODE_CONFIG register & its values (same for both parts) */
+#define MAX3010X_MODE_FIELD_MASK 0x07
+#define MAX3010X_MODE_FIELD_HR   0x02
+#define MAX3010X_MODE_FIELD_SPO2 0x03
+
+/** FIFO depth (samples) & bytes per channel of a FIFO sample */
+#define MAX30100_FIFO_DEPTH         16
+#define MAX30100_FIFO_CHANNEL_BYTES 2
+#define MAX30102_FIFO_CHANNEL_BYTES 3
+
+/** MAX30102 FIFO channel data is 18 bit, left-justified for lower ADC resolutions */
+#define MAX30102_FIFO_DATA_MASK 0x3FFFF
+
+/** Max number of samples read from FIFO in one I2C transfer */
+#define MAX3010X_EXT_READ_CHUNK 8
+
+/** FIFO Almost Full interrupt enable bit (same for both parts) */
+#define MAX3010X_INT_A_FULL_EN (1 << 7)
+
+/** MAX30102 FIFO depth & FIFO_A_FULL field (number of free slots on interrupt) */
+#define MAX30102_FIFO_DEPTH       32
+#define MAX30102_FIFO_A_FULL_MASK 0x0F
+
+/** MAX30102 SMP_AVE field of FIFO_CONFIG register (log2 of averaged samples) */
+#define MAX30102_FIFO_SMP_AVE_MASK  0xE0
+#define MAX30102_FIFO_SMP_AVE_SHIFT 5
+
+/** MAX30102 LED current step (0.2 mA) */
+#define MAX30102_LED_PA_PER_MA 5
+
+/** MAX30102 SPO2_ADC_RGE field */
+#define MAX30102_SPO2_ADC_RGE_MASK  0x60
+#define MAX30102_SPO2_ADC_RGE_SHIFT 5
+
+/* Macros =================================================================== */
+/**
+ * Select register address based on detected part
+ */
+#define MAX3010X_REG(__ext, __name) \
+  ((__ext)->part == MAX3010X_EXT_PART_MAX30102 ? MAX30102_REG_ ## __name : MAX30100_REG_ ## __name)
+
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/**
+ * MAX30100 LED current for each LED_CONFIG nibble value (0.1 mA)
+ */
+static const uint16_t max30100_led_current[MAX3010X_EXT_LED_LEVELS] = {
+  0, 44, 76, 110, 142, 174, 208, 240, 271, 306, 338, 370, 402, 436, 468, 500
+};
+
+/* Private functions ======================================================== */
+static error_t max3010x_ext_read_reg(max3010x_ext_t * ext, uint8_t reg, uint8_t * value) {
+  ERROR_CHECK_RETURN(i2c_send(ext->i2c, MAX3010X_EXT_I2C_ADDR, &reg, 1));
+  return i2c_recv(ext->i2c, MAX3010X_EXT_I2C_ADDR, value, 1);
+}
+
+static error_t max3010x_ext_write_reg(max3010x_ext_t * ext, uint8_t reg, uint8_t value) {
+  uint8_t data[2] = {reg, value};
+  return i2c_send(ext->i2c, MAX3010X_EXT_I2C_ADDR, data, sizeof(data));
+}
+
+static error_t max3010x_ext_update_reg(max3010x_ext_t * ext, uint8_t reg, uint8_t mask, uint8_t value) {
+  uint8_t current = 0;
+  ERROR_CHECK_RETURN(max3010x_ext_read_reg(ext, reg, &current));
+  return max3010x_ext_write_reg(ext, reg, (current & ~mask) | (value & mask));
+}
+
+/**
+ * Convert LED current to MAX30100 LED_CONFIG nibble (rounded down)
+ */
+static uint8_t max30100_led_level(uint8_t ma) {
+  uint8_t level = 0;
+
+  while (level + 1 < MAX3010X_EXT_LED_LEVELS && max30100_led_current[level + 1] <= ma * 10) {
+    level++;
+  }
+
+  return level;
+}
+
+/**
+ * Drop partial software average
+ */
+__STATIC_INLINE void max3010x_ext_avg_reset(max3010x_ext_t * ext) {
+  ext->avg.count = 0;
+  ext->avg.ir    = 0;
+  ext->avg.red   = 0;
+}
+
+/**
+ * Drop samples in FIFO (& partial software average of them)
+ */
+static error_t max3010x_ext_fifo_clear(max3010x_ext_t * ext) {
+  ERROR_CHECK_RETURN(max3010x_ext_write_reg(ext, MAX3010X_REG(ext, FIFO_WR_PTR), 0));
+  ERROR_CHECK_RETURN(max3010x_ext_write_reg(ext, MAX3010X_REG(ext, OVF_COUNTER), 0));
+  ERROR_CHECK_RETURN(max3010x_ext_write_reg(ext, MAX3010X_REG(ext, FIFO_RD_PTR), 0));
+
+  max3010x_ext_avg_reset(ext);
+
+  return E_OK;
+}
+
+/**
+ * Parse one channel of FIFO sample & advance data pointer past it
+ */
+__STATIC_INLINE uint32_t max3010x_ext_fifo_channel(max3010x_ext_t * ext, const uint8_t ** data) {
+  const uint8_t * p = *data;
+
+  if (ext->part == MAX3010X_EXT_PART_MAX30102) {
+    *data += MAX30102_FIFO_CHANNEL_BYTES;
+    return (((uint32_t) p[0] << 16) | ((uint32_t) p[1] << 8) | p[2]) & MAX30102_FIFO_DATA_MASK;
+  }
+
+  *data += MAX30100_FIFO_CHANNEL_BYTES;
+  return ((uint32_t) p[0] << 8) | p[1];
+}
+
+/* Shared functions ========================================================= */
+error_t max3010x_ext_init(max3010x_ext_t * ext, i2c_t * i2c) {
+  ASSERT_RETURN(ext && i2c, E_NULL);
+
+  ext->i2c = i2c;
+  ext->avg.samples = 1;
+  max3010x_ext_avg_reset(ext);
+
+  uint8_t part = 0;
+  ERROR_CHECK_RETURN(max3010x_ext_read_reg(ext, MAX3010X_REG_PART_ID, &part));
+
+  switch (part) {
+    case MAX3010X_EXT_PART_MAX30100:
+    case MAX3010X_EXT_PART_MAX30102:
+      ext->part = part;
+      break;
+
+    default:
+      log_error("Unknown part 0x%x", part);
+      return E_INVAL;
+  }
+
+  ext->is_spo2 = false;
+
+  return E_OK;
+}
+
+error_t max3010x_ext_get_overflow(max3010x_ext_t * ext, uint8_t * count) {
+  ASSERT_RETURN(ext && count, E_NULL);
+
+  ERROR_CHECK_RETURN(max3010x_ext_read_reg(ext, MAX3010X_REG(ext, OVF_COUNTER), count));
+
+  *count = (*count & MAX3010X_OVF_COUNTER_MASK) / ext->avg.samples;
+
+  return E_OK;
+}
+
+error_t max3010x_ext_enable_fifo_irq(max3010x_ext_t * ext, uint8_t samples) {
+  ASSERT_RETURN(ext, E_NULL);
+
+  if (ext->part == MAX3010X_EXT_PART_MAX30102) {
+    ASSERT_RETURN(
+      samples <= MAX30102_FIFO_DEPTH && samples > MAX30102_FIFO_DEPTH - MAX30102_FIFO_A_FULL_MASK - 1,
+      E_INVAL
+    );
+
+    ERROR_CHECK_RETURN(max3010x_ext_update_reg(
+      ext, MAX30102_REG_FIFO_CONFIG, MAX30102_FIFO_A_FULL_MASK, MAX30102_FIFO_DEPTH - samples
+    ));
+  }
+
+  return max3010x_ext_update_reg(
+    ext, MAX3010X_REG(ext, INT_ENABLE), MAX3010X_INT_A_FULL_EN, MAX3010X_INT_A_FULL_EN
+  );
+}
+
+error_t max3010x_ext_set_shutdown(max3010x_ext_t * ext, bool shutdown) {
+  ASSERT_RETURN(ext, E_NULL);
+
+  if (!shutdown) {
+    // FIFO holds samples taken before shutdown, drop them
+    ERROR_CHECK_RETURN(max3010x_ext_fifo_clear(ext));
+  }
+
+  return max3010x_ext_update_reg(
+    ext, MAX3010X_REG(ext, MODE_CONFIG), MAX3010X_MODE_SHDN, shutdown ? MAX3010X_MODE_SHDN : 0
+  );
+}
+
+const uint16_t * max3010x_ext_get_led_levels(max3010x_ext_t * ext) {
+  return ext && ext->part == MAX3010X_EXT_PART_MAX30100 ? max30100_led_current : NULL;
+}
+
+error_t max3010x_ext_set_led_current(max3010x_ext_t * ext, uint8_t ir, uint8_t red) {
+  ASSERT_RETURN(ext, E_NULL);
+  ASSERT_RETURN(ir <= MAX3010X_EXT_LED_MAX_CURRENT && red <= MAX3010X_EXT_LED_MAX_CURRENT, E_INVAL);
+
+  if (ext->part == MAX3010X_EXT_PART_MAX30102) {
+    ERROR_CHECK_RETURN(max3010x_ext_write_reg(ext, MAX30102_REG_LED1_PA, red * MAX30102_LED_PA_PER_MA));
+    return max3010x_ext_write_reg(ext, MAX30102_REG_LED2_PA, ir * MAX30102_LED_PA_PER_MA);
+  }
+
+  return max3010x_ext_write_reg(
+    ext, MAX30100_REG_LED_CONFIG, (max30100_led_level(red) << 4) | max30100_led_level(ir)
+  );
+}
+
+error_t max3010x_ext_set_sample_averaging(max3010x_ext_t * ext, uint8_t samples) {
+  ASSERT_RETURN(ext, E_NULL);
+  ASSERT_RETURN(samples && samples <= MAX3010X_EXT_MAX_AVERAGING && !(samples & (samples - 1)), E_INVAL);
+
+  ext->avg.samples = 1;
+  max3010x_ext_avg_reset(ext);
+
+  if (ext->part == MAX3010X_EXT_PART_MAX30102) {
+    return max3010x_ext_update_reg(
+      ext, MAX30102_REG_FIFO_CONFIG, MAX30102_FIFO_SMP_AVE_MASK, __builtin_ctz(samples) << MAX30102_FIFO_SMP_AVE_SHIFT
+    );
+  }
+
+  ext->avg.samples = samples;
+
+  return E_OK;
+}
+
+error_t max3010x_ext_average_samples(max3010x_ext_t * ext, max3010x_sample_t * samples, size_t * size) {
+  ASSERT_RETURN(ext && samples && size, E_NULL);
+
+  if (ext->avg.samples == 1) {
+    return E_OK;
+  }
+
+  uint32_t shift = __builtin_ctz(ext->avg.samples);
+  size_t   out   = 0;
+
+  // Output index never passes input one, so samples are averaged in place
+  for (size_t i = 0; i < *size; ++i) {
+    ext->avg.ir  += samples[i].ir;
+    ext->avg.red += samples[i].red;
+
+    if (++ext->avg.count == ext->avg.samples) {
+      samples[out].ir  = ext->avg.ir >> shift;
+      samples[out].red = ext->avg.red >> shift;
+      out++;
+
+      max3010x_ext_avg_reset(ext);
+    }
+  }
+
+  *size = out;
+
+  return E_OK;
+}
+
+error_t max3010x_ext_set_adc_range(max3010x_ext_t * ext, uint8_t range) {
+  ASSERT_RETURN(ext, E_NULL);
+  ASSERT_RETURN(ext->part == MAX3010X_EXT_PART_MAX30102, E_INVAL);
+  ASSERT_RETURN(range < MAX3010X_EXT_ADC_RANGES, E_INVAL);
+
+  return max3010x_ext_update_reg(
+    ext, MAX30102_REG_SPO2_CONFIG, MAX30102_SPO2_ADC_RGE_MASK, range << MAX30102_SPO2_ADC_RGE_SHIFT
+  );
+}
+
+error_t max3010x_ext_set_spo2_mode(max3010x_ext_t * ext, bool enable) {
+  ASSERT_RETURN(ext, E_NULL);
+
+  ERROR_CHECK_RETURN(max3010x_ext_update_reg(
+    ext, MAX3010X_REG(ext, MODE_CONFIG), MAX3010X_MODE_FIELD_MASK,
+    enable ? MAX3010X_MODE_FIELD_SPO2 : MAX3010X_MODE_FIELD_HR
+  ));
+
+  ext->is_spo2 = enable;
+
+  // FIFO layout changes with mode, samples taken in the other one are dropped
+  return max3010x_ext_fifo_clear(ext);
+}
+
+error_t max3010x_ext_read_samples(max3010x_ext_t * ext, max3010x_sample_t * samples, size_t * size) {
+  ASSERT_RETURN(ext && samples && size, E_NULL);
+
+  bool   is_max30102 = ext->part == MAX3010X_EXT_PART_MAX30102;
+  size_t depth       = is_max30102 ? MAX30102_FIFO_DEPTH : MAX30100_FIFO_DEPTH;
+
+  // MAX30100 always stores both channels, MAX30102 only the sampled ones
+  size_t sample_bytes = is_max30102
+    ? (ext->is_spo2 ? 2 : 1) * MAX30102_FIFO_CHANNEL_BYTES
+    : 2 * MAX30100_FIFO_CHANNEL_BYTES;
+
+  uint8_t wr = 0;
+  uint8_t rd = 0;
+  ERROR_CHECK_RETURN(max3010x_ext_read_reg(ext, MAX3010X_REG(ext, FIFO_WR_PTR), &wr));
+  ERROR_CHECK_RETURN(max3010x_ext_read_reg(ext, MAX3010X_REG(ext, FIFO_RD_PTR), &rd));
+
+  size_t count = (size_t) (wr - rd) & (depth - 1);
+
+  // Equal pointers are either empty FIFO or a full one, that has overflowed
+  if (!count) {
+    uint8_t ovf = 0;
+    ERROR_CHECK_RETURN(max3010x_ext_read_reg(ext, MAX3010X_REG(ext, OVF_COUNTER), &ovf));
+
+    count = ovf & MAX3010X_OVF_COUNTER_MASK ? depth : 0;
+  }
+
+  count = count < *size ? count : *size;
+
+  uint8_t data[MAX3010X_EXT_READ_CHUNK * 2 * MAX30102_FIFO_CHANNEL_BYTES];
+  uint8_t reg = MAX3010X_REG(ext, FIFO_DATA);
+
+  for (size_t i = 0; i < count;) {
+    size_t chunk = count - i < MAX3010X_EXT_READ_CHUNK ? count - i : MAX3010X_EXT_READ_CHUNK;
+
+    // FIFO_DATA address doesn't advance, every byte read pops the FIFO
+    ERROR_CHECK_RETURN(i2c_send(ext->i2c, MAX3010X_EXT_I2C_ADDR, &reg, 1));
+    ERROR_CHECK_RETURN(i2c_recv(ext->i2c, MAX3010X_EXT_I2C_ADDR, data, chunk * sample_bytes));
+
+    const uint8_t * p = data;
+
+    for (size_t j = 0; j < chunk; ++j, ++i) {
+      if (is_max30102) {
+        // LED1 (red) goes first, heart rate mode samples it only
+        uint32_t led1 = max3010x_ext_fifo_channel(ext, &p);
+
+        samples[i].red = ext->is_spo2 ? led1 : 0;
+        samples[i].ir  = ext->is_spo2 ? max3010x_ext_fifo_channel(ext, &p) : led1;
+      } else {
+        samples[i].ir  = max3010x_ext_fifo_channel(ext, &p);
+        samples[i].red = max3010x_ext_fifo_channel(ext, &p);
+      }
+    }
+  }
+
+  *size = count;
+
+  return E_OK;
+}
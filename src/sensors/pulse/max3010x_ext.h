@@ -0,0 +1,204 @@
+/** ========================================================================= *
+ *
+ * @file max3010x_ext.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief MAX3010x register level extensions, for features that aren't
+ *        covered by SDK driver
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "max3010x/max3010x.h"
+#include "error/error.h"
+#include "i2c/i2c.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/** MAX3010x I2C Address */
+#define MAX3010X_EXT_I2C_ADDR 0x57
+
+/** Max LED current (mA) */
+#define MAX3010X_EXT_LED_MAX_CURRENT 50
+
+/** Number of LED current levels on MAX30100 */
+#define MAX3010X_EXT_LED_LEVELS 16
+
+/** Number of ADC ranges on MAX30102 (2048 nA << range full scale) */
+#define MAX3010X_EXT_ADC_RANGES 4
+
+/** Max number of averaged samples (MAX30102 FIFO averaging) */
+#define MAX3010X_EXT_MAX_AVERAGING 32
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/**
+ * MAX3010x Part (value of PART_ID register)
+ */
+typedef enum {
+  MAX3010X_EXT_PART_MAX30100 = 0x11,
+  MAX3010X_EXT_PART_MAX30102 = 0x15,
+} max3010x_ext_part_t;
+
+/* Types ==================================================================== */
+/**
+ * MAX3010x Extensions Context
+ */
+typedef struct {
+  /** I2C Handle, sensor is connected to */
+  i2c_t * i2c;
+
+  /** Detected part */
+  max3010x_ext_part_t part;
+
+  /** Software sample averaging (MAX30100 has no FIFO averaging) */
+  struct {
+    /** Number of averaged samples (1 - off) */
+    uint8_t samples;
+
+    /** Number of samples in accumulators */
+    uint8_t count;
+
+    uint32_t ir;
+    uint32_t red;
+  } avg;
+
+  /** Red & IR are sampled (SpO2 mode), otherwise it's heart rate mode */
+  bool is_spo2;
+} max3010x_ext_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize MAX3010x Extensions Context. Detects sensor part
+ *
+ * @param ext MAX3010x Extensions Context
+ * @param i2c I2C Handle, sensor is connected to
+ */
+error_t max3010x_ext_init(max3010x_ext_t * ext, i2c_t * i2c);
+
+/**
+ * Read FIFO overflow counter (number of samples lost since last FIFO read)
+ *
+ * @note Counter is reset by sensor, when samples are read from FIFO, so
+ *       it must be read before max3010x_read_samples/max3010x_ext_read_samples
+ *
+ * @param ext MAX3010x Extensions Context
+ * @param count Where to put number of lost samples (saturates at 31), after
+ *              software averaging
+ */
+error_t max3010x_ext_get_overflow(max3010x_ext_t * ext, uint8_t * count);
+
+/**
+ * Enable FIFO Almost Full interrupt (INT pin is asserted, when FIFO holds
+ * a number of unread samples)
+ *
+ * @note MAX30100 has fixed threshold of 15 samples (out of 16)
+ *
+ * @param ext MAX3010x Extensions Context
+ * @param samples Number of unread samples, on which interrupt is asserted
+ *                (17-32, MAX30102 only)
+ */
+error_t max3010x_ext_enable_fifo_irq(max3010x_ext_t * ext, uint8_t samples);
+
+/**
+ * Enter/leave power-save (shutdown) mode. LEDs are off & no samples are
+ * taken, while registers keep their values
+ *
+ * @note FIFO is cleared on wake up, so stale samples aren't read
+ *
+ * @param ext MAX3010x Extensions Context
+ * @param shutdown true to enter shutdown mode, false to resume sampling
+ */
+error_t max3010x_ext_set_shutdown(max3010x_ext_t * ext, bool shutdown);
+
+/**
+ * Get LED current levels, sensor can drive
+ *
+ * @param ext MAX3010x Extensions Context
+ * @return MAX30100 levels (0.1 mA, ascending, MAX3010X_EXT_LED_LEVELS of
+ *         them), NULL for MAX30102 (it steps by 0.2 mA, so any whole mA)
+ */
+const uint16_t * max3010x_ext_get_led_levels(max3010x_ext_t * ext);
+
+/**
+ * Set LED drive current
+ *
+ * @note MAX30100 has only 16 current levels, so value is rounded down to
+ *       the closest one. MAX30102 has a step of 0.2 mA
+ *
+ * @param ext MAX3010x Extensions Context
+ * @param ir IR LED current (mA, 0-50)
+ * @param red Red LED current (mA, 0-50)
+ */
+error_t max3010x_ext_set_led_current(max3010x_ext_t * ext, uint8_t ir, uint8_t red);
+
+/**
+ * Set number of averaged samples. Sensor outputs one sample per averaged
+ * ones, so output rate is sample rate divided by it
+ *
+ * @note MAX30102 averages in FIFO, so there are less samples to read. On
+ *       MAX30100 samples are averaged in software by
+ *       max3010x_ext_average_samples, which only cuts processing
+ *
+ * @param ext MAX3010x Extensions Context
+ * @param samples Number of averaged samples (power of 2, up to 32)
+ */
+error_t max3010x_ext_set_sample_averaging(max3010x_ext_t * ext, uint8_t samples);
+
+/**
+ * Average samples in software (in place), if it's enabled. Partial average
+ * is carried over to the next call
+ *
+ * @param ext MAX3010x Extensions Context
+ * @param samples Samples, that were read from FIFO
+ * @param size Number of samples, replaced with number of averaged samples
+ */
+error_t max3010x_ext_average_samples(max3010x_ext_t * ext, max3010x_sample_t * samples, size_t * size);
+
+/**
+ * Set ADC full scale range (MAX30102 only)
+ *
+ * @param ext MAX3010x Extensions Context
+ * @param range ADC range (0-3), full scale is 2048 nA << range
+ * @return E_INVAL on MAX30100
+ */
+error_t max3010x_ext_set_adc_range(max3010x_ext_t * ext, uint8_t range);
+
+/**
+ * Switch between SpO2 (red & IR LEDs are sampled) & heart rate mode. SDK
+ * driver doesn't know about the switch, so FIFO has to be read with
+ * max3010x_ext_read_samples, which follows the mode
+ *
+ * @note FIFO is cleared, as its layout changes
+ *
+ * @param ext MAX3010x Extensions Context
+ * @param enable true for SpO2 mode, false for heart rate mode
+ */
+error_t max3010x_ext_set_spo2_mode(max3010x_ext_t * ext, bool enable);
+
+/**
+ * Read samples from FIFO, in layout of the mode set by
+ * max3010x_ext_set_spo2_mode. MAX30102 values are 18 bit, left-justified
+ * for lower ADC resolutions. Heart rate mode has a single channel, it's
+ * returned as IR (red is 0)
+ *
+ * @note Overflow counter is reset by the read, see max3010x_ext_get_overflow
+ *
+ * @param ext MAX3010x Extensions Context
+ * @param samples Where to put samples
+ * @param size Max number of samples, replaced with number of read samples
+ */
+error_t max3010x_ext_read_samples(max3010x_ext_t * ext, max3010x_sample_t * samples, size_t * size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -8,6 +8,7 @@
 
 /* Includes ================================================================= */
 #include "sensors/pulse/pulse.h"
+#include "sensors/pulse/pulse_engine.h"
 #include "error/assertion.h"
 #include "log/log.h"
 #include "tty/ansi.h"
@@ -15,77 +16,465 @@
 /* Defines ================================================================== */
 #define LOG_TAG pulse
 
+/** Engine, that is used by default (can be changed with PULSE_ENGINE feature) */
+#ifndef PULSE_ENGINE
+#define PULSE_ENGINE pulse_engine_peak
+#endif
+
+/** Mask for wrapping BPM approximation buffer index */
+#define PULSE_BEAT_APPROX_INDEX_MASK (PULSE_BEAT_APPROX_SAMPLES - 1)
+
+#if PULSE_BEAT_APPROX_SAMPLES & PULSE_BEAT_APPROX_INDEX_MASK
+#error "PULSE_BEAT_APPROX_SAMPLES must be a power of 2"
+#endif
+
+#if PULSE_BEAT_OUTLIER_MIN_COUNT > PULSE_BEAT_APPROX_SAMPLES
+#error "PULSE_BEAT_OUTLIER_MIN_COUNT can't exceed PULSE_BEAT_APPROX_SAMPLES"
+#endif
+
+#if PULSE_MC_MIN_POWER < (1 << (PULSE_MC_WEIGHT_FRAC_BITS - PULSE_MC_MU_SHIFT))
+#error "PULSE_MC_MIN_POWER is too low, weight update shift would be negative"
+#endif
+
+/** Mask for wrapping motion reference ring index */
+#define PULSE_MC_REF_INDEX_MASK (PULSE_MC_REF_COUNT - 1)
+
+#if PULSE_MC_REF_COUNT & PULSE_MC_REF_INDEX_MASK || PULSE_MC_REF_COUNT > 128
+#error "PULSE_MC_REF_COUNT must be a power of 2, up to 128"
+#endif
+
+/** Fractional bits of average beat interval */
+#define PULSE_AVG_INTERVAL_FRAC_BITS 8
+
+/**
+ * BPM Lookup Table Config
+ *
+ * Table holds 60000/interval (Q4) for beat intervals starting from
+ * PULSE_BPM_LUT_BASE with a step of 2^PULSE_BPM_LUT_STEP_SHIFT ms. Values in
+ * between are linearly interpolated (error < 0.3 BPM)
+ */
+#define PULSE_BPM_LUT_FRAC_BITS  4
+#define PULSE_BPM_LUT_STEP_SHIFT 4
+#define PULSE_BPM_LUT_SIZE       112
+#define PULSE_BPM_LUT_BASE       (PULSE_MIN_BEAT_TIME_DELTA & ~((1 << PULSE_BPM_LUT_STEP_SHIFT) - 1))
+#define PULSE_BPM_LUT_LAST       (PULSE_BPM_LUT_BASE + ((PULSE_BPM_LUT_SIZE - 1) << PULSE_BPM_LUT_STEP_SHIFT))
+
+#if PULSE_BPM_LUT_LAST < PULSE_MAX_BEAT_TIME_DELTA
+#error "BPM lookup table doesn't cover PULSE_MAX_BEAT_TIME_DELTA"
+#endif
+
 /* Macros =================================================================== */
+/**
+ * BPM lookup table entry (rounded 60000/interval in Q4)
+ *
+ * @param __i Entry index
+ */
+#define PULSE_BPM_LUT_ENTRY(__i)                                              \
+  ((uint16_t) (((60000 << PULSE_BPM_LUT_FRAC_BITS)                            \
+    + ((PULSE_BPM_LUT_BASE + ((__i) << PULSE_BPM_LUT_STEP_SHIFT)) / 2))       \
+    / (PULSE_BPM_LUT_BASE + ((__i) << PULSE_BPM_LUT_STEP_SHIFT))))
+
+/**
+ * 8 consecutive BPM lookup table entries
+ *
+ * @param __i Index of first entry
+ */
+#define PULSE_BPM_LUT_ROW(__i)                                                \
+  PULSE_BPM_LUT_ENTRY((__i) + 0), PULSE_BPM_LUT_ENTRY((__i) + 1),             \
+  PULSE_BPM_LUT_ENTRY((__i) + 2), PULSE_BPM_LUT_ENTRY((__i) + 3),             \
+  PULSE_BPM_LUT_ENTRY((__i) + 4), PULSE_BPM_LUT_ENTRY((__i) + 5),             \
+  PULSE_BPM_LUT_ENTRY((__i) + 6), PULSE_BPM_LUT_ENTRY((__i) + 7)
+
 /* Exposed macros =========================================================== */
 /* Enums ==================================================================== */
+/**
+ * Beat interval check result
+ */
+typedef enum {
+  PULSE_INTERVAL_OK = 0,
+  PULSE_INTERVAL_SHORT, // Double detection
+  PULSE_INTERVAL_LONG,  // Missed beat (or a gap in samples)
+} pulse_interval_t;
+
 /* Types ==================================================================== */
 /* Variables ================================================================ */
+/** Beat interval to BPM lookup table */
+static const uint16_t bpm_lut[PULSE_BPM_LUT_SIZE] = {
+  PULSE_BPM_LUT_ROW(0),  PULSE_BPM_LUT_ROW(8),  PULSE_BPM_LUT_ROW(16), PULSE_BPM_LUT_ROW(24),
+  PULSE_BPM_LUT_ROW(32), PULSE_BPM_LUT_ROW(40), PULSE_BPM_LUT_ROW(48), PULSE_BPM_LUT_ROW(56),
+  PULSE_BPM_LUT_ROW(64), PULSE_BPM_LUT_ROW(72), PULSE_BPM_LUT_ROW(80), PULSE_BPM_LUT_ROW(88),
+  PULSE_BPM_LUT_ROW(96), PULSE_BPM_LUT_ROW(104),
+};
+
 /* Private functions ======================================================== */
-static int32_t low_pass_filter(pulse_t * pulse, int32_t value) {
+__STATIC_INLINE int32_t low_pass_filter(pulse_t * pulse, int32_t value) {
   // y[n] = y[n-1] + alpha * (x - y[n-1])
   pulse->filter.lpf.y = pulse->filter.lpf.y + ((PULSE_LPF_ALPHA * ((value << 8) - pulse->filter.lpf.y)) >> 8);
   return pulse->filter.lpf.y >> 8; // scale back to original range
 }
 
-static int32_t dc_filter(pulse_t * pulse, int32_t value) {
+__STATIC_INLINE int32_t dc_filter(pulse_t * pulse, int32_t value) {
   int32_t filtered = value - pulse->filter.dc.baseline;
 
   // Update baseline slowly
-  pulse->filter.dc.baseline += (value - pulse->filter.dc.baseline) >> 8; // simple low-pass for DC
+  pulse->filter.dc.baseline += (value - pulse->filter.dc.baseline) >> PULSE_DC_FILTER_SHIFT; // simple low-pass for DC
 
   return filtered;
 }
 
-static int32_t gauss_filter(pulse_t * pulse, int32_t value) {
-  int32_t acc = 0;
-  int32_t idx = 0;
+#if USE_PULSE_MOTION_CANCELLER
+/**
+ * Get motion reference at current sample, interpolated between references
+ * around it. Newest one is held, if PPG is ahead of accelerometer
+ */
+__STATIC_INLINE int32_t motion_reference(pulse_t * pulse) {
+  uint16_t n     = (uint16_t) pulse->sample_index;
+  uint32_t tail  = pulse->filter.mc.refs.tail;
+  uint32_t count = pulse->filter.mc.refs.count;
+
+  if (!count) {
+    return 0;
+  }
+
+  // Only the last reference at or before current sample is still needed
+  while (count > 1) {
+    uint32_t next = (tail + 1) & PULSE_MC_REF_INDEX_MASK;
 
-  pulse->filter.gauss.buffer[pulse->filter.gauss.index] = value;
+    if ((int16_t) (pulse->filter.mc.refs.index[next] - n) > 0) {
+      break;
+    }
 
-  // FIXME: If WINDOW_SIZE != 5 this breaks
-  for (int32_t i = -2; i <= 2; ++i) {
-    uint32_t buf_idx = (pulse->filter.gauss.index + i + PULSE_GAUSS_WINDOW_SIZE) % PULSE_GAUSS_WINDOW_SIZE;
-    acc += pulse->filter.gauss.buffer[buf_idx] * PULSE_GAUSS_COEFFICIENTS[idx++];
+    tail = next;
+    count--;
   }
 
-  pulse->filter.gauss.index = ++pulse->filter.gauss.index % PULSE_GAUSS_WINDOW_SIZE;
+  pulse->filter.mc.refs.tail  = tail;
+  pulse->filter.mc.refs.count = count;
+
+  int32_t ref = pulse->filter.mc.refs.value[tail];
+  int32_t dt  = (int16_t) (n - pulse->filter.mc.refs.index[tail]);
 
-  return acc / PULSE_GAUSS_FACTOR;
+  if (count > 1 && dt > 0) {
+    uint32_t next = (tail + 1) & PULSE_MC_REF_INDEX_MASK;
+    ref += (pulse->filter.mc.refs.slope[next] * dt) >> PULSE_MC_SLOPE_FRAC_BITS;
+  }
+
+  return ref;
 }
 
-static int32_t weighted_moving_average(pulse_t * pulse, int32_t value) {
-  pulse->filter.wma.buffer[pulse->filter.wma.index] = value;
-  pulse->filter.wma.index = ++pulse->filter.wma.index % PULSE_WMA_BUFFER_SIZE;
+__STATIC_INLINE int32_t motion_canceller(pulse_t * pulse, int32_t value) {
+  uint32_t index = pulse->filter.mc.index;
+  int32_t  ref   = motion_reference(pulse);
+  // Reference sample that leaves the history
+  int32_t oldest = pulse->filter.mc.buffer[index];
+
+  pulse->filter.mc.buffer[index] = ref;
+  pulse->filter.mc.buffer[index + PULSE_MC_TAPS] = ref;
 
-  int32_t wma = 0;
-  int32_t wma_index = pulse->filter.wma.index;
-  for (uint32_t i = 0; i < PULSE_WMA_BUFFER_SIZE; ++i) {
-    wma += pulse->filter.wma.buffer[wma_index] * pulse->filter.wma.weights[i];
+  index = index + 1 < PULSE_MC_TAPS ? index + 1 : 0;
+  pulse->filter.mc.index = index;
 
-    wma_index = ++wma_index % PULSE_WMA_BUFFER_SIZE;
+  pulse->filter.mc.power += ref * ref - oldest * oldest;
+
+  // Whole history (from oldest to newest sample)
+  const int32_t * window  = &pulse->filter.mc.buffer[index];
+  int32_t       * weights = pulse->filter.mc.weights;
+
+  int32_t artifact = 0;
+
+  for (uint32_t i = 0; i < PULSE_MC_TAPS; ++i) {
+    artifact += weights[i] * window[i];
+  }
+
+  int32_t err = value - (artifact >> PULSE_MC_WEIGHT_FRAC_BITS);
+
+  if (pulse->filter.mc.power >= PULSE_MC_MIN_POWER) {
+    // w += mu * e * x / power, power is rounded down to a power of 2, so division is a shift
+    uint32_t shift = (31 - __builtin_clz(pulse->filter.mc.power)) + PULSE_MC_MU_SHIFT - PULSE_MC_WEIGHT_FRAC_BITS;
+    int32_t  e     = err;
+
+    e = e >  PULSE_MC_ERROR_MAX ?  PULSE_MC_ERROR_MAX : e;
+    e = e < -PULSE_MC_ERROR_MAX ? -PULSE_MC_ERROR_MAX : e;
+
+    for (uint32_t i = 0; i < PULSE_MC_TAPS; ++i) {
+      int32_t w = weights[i] + ((e * window[i]) >> shift);
+
+      w = w >  PULSE_MC_WEIGHT_MAX ?  PULSE_MC_WEIGHT_MAX : w;
+      w = w < -PULSE_MC_WEIGHT_MAX ? -PULSE_MC_WEIGHT_MAX : w;
+
+      weights[i] = w;
+    }
   }
-  wma /= pulse->filter.wma.weights_sum;
 
-  return wma;
+  return err;
 }
+#endif
 
-static void pulse_detected(pulse_t * pulse) {
-  pulse->total.beats++;
+/**
+ * Median of approximation buffer (ms, Q1 - sum of two middle samples, so even
+ * number of samples doesn't need rounding)
+ */
+__STATIC_INLINE uint32_t pulse_approx_median(pulse_t * pulse) {
+  uint32_t count = pulse->approx.count;
 
-  if (!pulse->detect.last_beat_timestamp) {
-    pulse->detect.last_beat_timestamp = pulse->last_process_timestamp;
+  return pulse->approx.sorted[(count - 1) >> 1] + pulse->approx.sorted[count >> 1];
+}
+
+/**
+ * Find position of first sorted sample, that isn't less than value
+ */
+__STATIC_INLINE uint32_t pulse_approx_lower_bound(pulse_t * pulse, uint32_t size, uint32_t value) {
+  uint32_t lo = 0;
+  uint32_t hi = size;
+
+  while (lo < hi) {
+    uint32_t mid = (lo + hi) >> 1;
+
+    if (pulse->approx.sorted[mid] < value) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
   }
 
-  uint32_t dt = runtime_get() - pulse->detect.last_beat_timestamp;
+  return lo;
+}
+
+/**
+ * Add interval to approximation buffer & its sorted copy
+ *
+ * Position of the interval, that leaves the buffer, is found with binary
+ * search, new one is moved from there to its place - only samples in between
+ * are shifted (buffer is small, so this is cheaper than a tree or heaps)
+ */
+__STATIC_INLINE void pulse_approx_add(pulse_t * pulse, uint32_t dt) {
+  uint16_t * sorted = pulse->approx.sorted;
+  uint32_t   count  = pulse->approx.count;
+  uint32_t   i;
+
+  if (count == PULSE_BEAT_APPROX_SAMPLES) {
+    i = pulse_approx_lower_bound(pulse, count, pulse->approx.beats[pulse->approx.index]);
+
+    while (i > 0 && sorted[i - 1] > dt) {
+      sorted[i] = sorted[i - 1];
+      i--;
+    }
 
-  pulse->approx.beats[pulse->approx.index] = dt < PULSE_MAX_BEAT_TIME_DELTA ? dt : PULSE_MAX_BEAT_TIME_DELTA;
-  pulse->approx.index = ++pulse->approx.index % PULSE_BEAT_APPROX_SAMPLES;
+    while (i + 1 < count && sorted[i + 1] < dt) {
+      sorted[i] = sorted[i + 1];
+      i++;
+    }
+  } else {
+    i = pulse_approx_lower_bound(pulse, count, dt);
+    memmove(&sorted[i + 1], &sorted[i], (count - i) * sizeof(uint16_t));
 
-  // store/use bpm
-  pulse->detect.last_beat_timestamp = runtime_get();
+    pulse->approx.count++;
+  }
+
+  sorted[i] = dt;
+
+  pulse->approx.beats[pulse->approx.index] = dt;
+  pulse->approx.index = (pulse->approx.index + 1) & PULSE_BEAT_APPROX_INDEX_MASK;
+}
+
+__STATIC_INLINE void pulse_approx_reset(pulse_t * pulse) {
+  memset(pulse->approx.beats, 0, sizeof(pulse->approx.beats));
+  pulse->approx.index    = 0;
+  pulse->approx.count    = 0;
+  pulse->approx.outliers = 0;
+}
+
+/**
+ * Check interval against median of approximation buffer
+ */
+static pulse_interval_t pulse_interval_check(pulse_t * pulse, uint32_t dt) {
+  if (dt > PULSE_MAX_BEAT_TIME_DELTA) {
+    return PULSE_INTERVAL_LONG;
+  }
+
+  if (pulse->approx.count < PULSE_BEAT_OUTLIER_MIN_COUNT) {
+    return PULSE_INTERVAL_OK;
+  }
+
+  uint32_t median    = pulse_approx_median(pulse) >> 1;
+  uint32_t tolerance = median >> PULSE_BEAT_OUTLIER_SHIFT;
+
+  pulse_interval_t res = PULSE_INTERVAL_OK;
+
+  if (dt + tolerance < median) {
+    res = PULSE_INTERVAL_SHORT;
+  } else if (dt > median + tolerance) {
+    res = PULSE_INTERVAL_LONG;
+  }
+
+  if (res == PULSE_INTERVAL_OK) {
+    pulse->approx.outliers -= pulse->approx.outliers ? 1 : 0;
+  } else if ((pulse->approx.outliers += 2) >= PULSE_BEAT_OUTLIER_MAX_SCORE) {
+    // Outliers outnumber accepted intervals - it's the median, that is stale
+    log_debug("Rhythm changed (median=%u dt=%u), restarting approximation", median, dt);
+    pulse_approx_reset(pulse);
+
+    // Current interval is still suspicious, beat only becomes a new reference
+    res = PULSE_INTERVAL_LONG;
+  }
+
+  return res;
+}
+
+/**
+ * Drop state, that is no longer valid after contact loss - beat reference &
+ * approximated BPM (so stale BPM isn't reported, while there is no contact)
+ */
+__STATIC_INLINE void pulse_contact_lost(pulse_t * pulse) {
+  pulse->detect.has_reference = false;
+
+  pulse_approx_reset(pulse);
+  pulse->approx.bpm = 0;
+
+#if USE_PULSE_HRV
+  hrv_init(&pulse->hrv);
+#endif
+
+#if USE_PULSE_RHYTHM
+  rhythm_init(&pulse->rhythm);
+#endif
+
+#if USE_PULSE_RESP
+  resp_init(&pulse->resp, PULSE_SAMPLE_RATE_HZ);
+#endif
+
+#if USE_PULSE_MOTION_CANCELLER
+  // References aren't consumed without contact, so they'd go stale
+  pulse->filter.mc.refs.count = 0;
+#endif
+
+  pulse->quality.ac = 0;
+
+  pulse->engine->init(pulse);
 }
 
 /* Shared functions ========================================================= */
+error_t pulse_frontend(pulse_t * pulse, int32_t sample, int32_t * value) {
+  pulse->total.time += PULSE_SAMPLE_PERIOD_MS;
+
+  if (sample < pulse->detect.raw_threshold) {
+    if (++pulse->quality.no_contact == PULSE_NO_CONTACT_SAMPLES) {
+      pulse_contact_lost(pulse);
+    }
+    return E_OUTOFBOUNDS;
+  }
+
+  pulse->quality.no_contact = 0;
+
+  // Sensor settings settle - filters follow new DC level, there are no beats
+  if (pulse->detect.blank) {
+    pulse->detect.blank--;
+    pulse->filter.lpf.y       = sample << 8;
+    pulse->filter.dc.baseline = sample;
+    return E_OUTOFBOUNDS;
+  }
+
+  int32_t lpf_res = low_pass_filter(pulse, sample);
+  int32_t dcf_res = dc_filter(pulse, lpf_res);
+
+#if USE_PULSE_RESP
+  // Breathing modulates baseline, which DC filter removes from signal
+  resp_add_sample(&pulse->resp, pulse->filter.dc.baseline);
+#endif
+
+  // AC amplitude for signal quality, baseline is already tracked by DC filter
+  pulse->quality.ac += (((dcf_res < 0 ? -dcf_res : dcf_res) << 8) - pulse->quality.ac) >> PULSE_QUALITY_AC_SHIFT;
+
+#if USE_PULSE_MOTION_CANCELLER
+  dcf_res = motion_canceller(pulse, dcf_res);
+#endif
+
+  *value = dcf_res;
+
+  return E_OK;
+}
+
+void pulse_beat(pulse_t * pulse) {
+  // First beat only sets a reference point for the following ones
+  if (pulse->detect.has_reference) {
+    uint32_t dt = (pulse->sample_index - pulse->detect.last_beat_index) * PULSE_SAMPLE_PERIOD_MS;
+
+    switch (pulse_interval_check(pulse, dt)) {
+      case PULSE_INTERVAL_OK: {
+        pulse_approx_add(pulse, dt);
+
+        // Pseudo-beats of non-aligned engines have no variability to measure
+        if (pulse->engine->beat_aligned) {
+#if USE_PULSE_HRV
+          hrv_add_interval(&pulse->hrv, dt);
+#endif
+#if USE_PULSE_RHYTHM
+          rhythm_add_interval(&pulse->rhythm, dt);
+#endif
+        }
+
+        int32_t interval = dt << PULSE_AVG_INTERVAL_FRAC_BITS;
+
+        if (pulse->total.avg_interval) {
+          pulse->total.avg_interval += (interval - pulse->total.avg_interval) >> PULSE_AVG_BPM_EMA_SHIFT;
+        } else {
+          pulse->total.avg_interval = interval;
+        }
+        break;
+      }
+
+      case PULSE_INTERVAL_SHORT: {
+        // Double detection - beat is dropped, previous one stays a reference
+        return;
+      }
+
+      default: {
+        // Missed beat - interval is dropped, beat becomes a new reference
+#if USE_PULSE_HRV
+        hrv_break(&pulse->hrv);
+#endif
+        break;
+      }
+    }
+  }
+
+  pulse->total.beats++;
+
+  pulse->detect.last_beat_index = pulse->sample_index;
+  pulse->detect.has_reference   = true;
+}
+
+error_t pulse_beats_get_bpm(pulse_t * pulse, uint32_t * bpm) {
+  // Value needs to stabilize, over whole approximation buffer
+  if (pulse->approx.count < PULSE_BEAT_APPROX_SAMPLES) {
+    return E_AGAIN;
+  }
+
+  // Median isn't dragged by a single missed or double detected beat, as average is
+  pulse->approx.bpm = pulse_interval_to_bpm(pulse_approx_median(pulse), 1);
+
+  *bpm = pulse->approx.bpm;
+
+  return E_OK;
+}
+
+uint32_t pulse_interval_to_bpm(uint32_t interval, uint32_t frac_bits) {
+  uint32_t shift = frac_bits + PULSE_BPM_LUT_STEP_SHIFT;
+  uint32_t base  = PULSE_BPM_LUT_BASE << frac_bits;
+  uint32_t last  = PULSE_BPM_LUT_LAST << frac_bits;
+
+  interval = interval < base ? base : interval;
+  interval = interval < last ? interval : last - 1;
+
+  uint32_t offset = interval - base;
+  uint32_t i      = offset >> shift;
+  uint32_t frac   = offset & ((1 << shift) - 1);
+
+  uint32_t bpm = bpm_lut[i] - (((bpm_lut[i] - bpm_lut[i + 1]) * frac) >> shift);
+
+  return (bpm + (1 << (PULSE_BPM_LUT_FRAC_BITS - 1))) >> PULSE_BPM_LUT_FRAC_BITS;
+}
+
 error_t pulse_init(pulse_t * pulse, int32_t raw_threshold, int32_t dcf_init_shift) {
   ASSERT_RETURN(pulse, E_NULL);
 
@@ -94,135 +483,216 @@ error_t pulse_init(pulse_t * pulse, int32_t raw_threshold, int32_t dcf_init_shif
   pulse->detect.raw_threshold = raw_threshold;
   pulse->filter.dc.baseline = raw_threshold - dcf_init_shift;
 
-  log_debug("Raw Threshold: %d", pulse->detect.raw_threshold);
+  pulse->engine = &PULSE_ENGINE;
+  pulse->engine->init(pulse);
 
-  for (int32_t w = 0; w < PULSE_WMA_BUFFER_SIZE; ++w) {
-    pulse->filter.wma.weights[PULSE_WMA_BUFFER_SIZE - w - 1] = w;
-    pulse->filter.wma.weights_sum += w;
-  }
+#if USE_PULSE_RESP
+  resp_init(&pulse->resp, PULSE_SAMPLE_RATE_HZ);
+#endif
+
+  log_debug("Raw Threshold: %d, engine: %s", pulse->detect.raw_threshold, pulse->engine->name);
+
+  return E_OK;
+}
+
+error_t pulse_set_engine(pulse_t * pulse, const pulse_engine_t * engine) {
+  ASSERT_RETURN(pulse && engine, E_NULL);
+
+  pulse->engine = engine;
+  pulse->engine->init(pulse);
+
+#if USE_PULSE_HRV
+  hrv_init(&pulse->hrv);
+#endif
+
+#if USE_PULSE_RHYTHM
+  rhythm_init(&pulse->rhythm);
+#endif
 
   return E_OK;
 }
 
 error_t pulse_process_sample(pulse_t * pulse, int32_t sample) {
   ASSERT_RETURN(pulse, E_NULL);
-  error_t err = E_AGAIN;
 
-  if (!pulse->last_process_timestamp) {
-    pulse->last_process_timestamp = runtime_get() - 300;
-  }
+  max3010x_sample_t block = { .ir = sample };
 
-  pulse->total.time += runtime_get() - pulse->last_process_timestamp;
+  error_t err = pulse->engine->process_block(pulse, &block, 1, NULL);
 
-  if (sample < pulse->detect.raw_threshold) {
-    err = E_OUTOFBOUNDS;
-    goto exit;
+  return err == E_AGAIN && sample < pulse->detect.raw_threshold ? E_OUTOFBOUNDS : err;
+}
+
+error_t pulse_process_block(
+  pulse_t * pulse, const max3010x_sample_t * samples, size_t size, pulse_beats_t * beats
+) {
+  ASSERT_RETURN(pulse && samples, E_NULL);
+
+  if (beats) {
+    beats->count = 0;
   }
 
-  int32_t lpf_res   = low_pass_filter(pulse, sample);
-  int32_t dcf_res   = dc_filter(pulse, lpf_res);
-  int32_t gauss_res = gauss_filter(pulse, dcf_res);
-  int32_t filtered  = weighted_moving_average(pulse, gauss_res);
+  return pulse->engine->process_block(pulse, samples, size, beats);
+}
 
-#if 0
-  uint32_t bpm = 0;
-  pulse_approximate_bpm(pulse, &bpm);
+error_t pulse_skip_samples(pulse_t * pulse, uint32_t count) {
+  ASSERT_RETURN(pulse, E_NULL);
 
-  log_printf("\r" ANSI_ERASE_LINE "raw=%d f=%d (bpm=%d/%d total=%d)",
-    sample, filtered,
-    pulse->approx.bpm,
-    PULSE_CALCULATE_BPM_TOTAL_AVG(pulse->total.beats, pulse->total.time),
-    pulse->total.beats
-  );
+  pulse->sample_index += count;
+  pulse->total.time   += count * PULSE_SAMPLE_PERIOD_MS;
+
+  return E_OK;
+}
+
+error_t pulse_settle(pulse_t * pulse, uint32_t samples) {
+  ASSERT_RETURN(pulse, E_NULL);
+
+  pulse->detect.blank = samples;
+
+  return E_OK;
+}
+
+error_t pulse_reset_contact(pulse_t * pulse) {
+  ASSERT_RETURN(pulse, E_NULL);
+
+  pulse->quality.no_contact = 0;
+
+  return E_OK;
+}
+
+#if USE_PULSE_BENCH && USE_PULSE_MOTION_CANCELLER
+int32_t pulse_bench_motion_canceller(pulse_t * pulse, int32_t value) {
+  return motion_canceller(pulse, value);
+}
 #endif
 
-  if (filtered > PULSE_FILTERED_MAX_THRESHOLD) {
-    err = E_OUTOFBOUNDS;
-    goto exit;
+#if USE_PULSE_MOTION_CANCELLER
+error_t pulse_add_motion_reference(pulse_t * pulse, uint32_t index, int16_t x, int16_t y, int16_t z) {
+  ASSERT_RETURN(pulse, E_NULL);
+
+  uint32_t count = pulse->filter.mc.refs.count;
+  uint32_t head  = (pulse->filter.mc.refs.tail + count) & PULSE_MC_REF_INDEX_MASK;
+  uint32_t last  = (head - 1) & PULSE_MC_REF_INDEX_MASK;
+  int32_t  span  = count ? (int32_t) (index - pulse->filter.mc.refs.last) : 1;
+
+  if (span < 0) {
+    return E_INVAL;
   }
 
-  switch (pulse->detect.state) {
-    case PULSE_DETECT_STATE_IDLE: {
-      if (filtered > PULSE_FILTERED_MIN_THRESHOLD && filtered > pulse->detect.prev) {
-        pulse->detect.state = PULSE_DETECT_STATE_SLOPE_UP;
-      }
-      break;
-    }
+  int32_t magnitude = (x < 0 ? -x : x) + (y < 0 ? -y : y) + (z < 0 ? -z : z);
 
-    case PULSE_DETECT_STATE_SLOPE_UP: {
-      if (filtered < pulse->detect.prev) {
-        pulse->detect.state = PULSE_DETECT_STATE_SLOPE_PEAK;
-      }
-      break;
-    }
+  // Seed baseline with first sample, so gravity doesn't show up as motion
+  if (!pulse->filter.mc.ref_dc) {
+    pulse->filter.mc.ref_dc = magnitude << 8;
+  }
 
-    case PULSE_DETECT_STATE_SLOPE_PEAK: {
-      if (filtered < pulse->detect.prev) {
-        pulse_detected(pulse);
-        pulse->detect.state = PULSE_DETECT_STATE_COOLDOWN;
-        err = E_OK;
-      } else {
-        pulse->detect.state = PULSE_DETECT_STATE_SLOPE_UP;
-      }
-      break;
-    }
+  int32_t ref = (magnitude << 8) - pulse->filter.mc.ref_dc;
+  pulse->filter.mc.ref_dc += ref >> PULSE_MC_REF_DC_SHIFT;
 
-    case PULSE_DETECT_STATE_COOLDOWN: {
-      if (runtime_get() + PULSE_MIN_BEAT_TIME_DELTA > pulse->detect.last_beat_timestamp) {
-        pulse->detect.state = PULSE_DETECT_STATE_IDLE;
-      }
-      break;
-    }
+  ref >>= 8;
+  ref = ref >  PULSE_MC_REF_MAX ?  PULSE_MC_REF_MAX : ref;
+  ref = ref < -PULSE_MC_REF_MAX ? -PULSE_MC_REF_MAX : ref;
 
-    default: {
-      break;
-    }
+  if (!span) {
+    pulse->filter.mc.refs.value[last] = (int16_t) ref;
+    return E_OK;
   }
 
-exit:
-#if 0
-  if (err != E_OUTOFBOUNDS) {
-    log_printf("ir=%d f=%d gauss=%d wma=%d pulse=%d\r\n",
-      sample, dcf_res, gauss_res, filtered, err == E_OK ? 300 : 0
-    );
+  // Slope is found once per accelerometer sample, so there is no division per PPG sample
+  int32_t slope = count && span <= INT16_MAX
+    ? ((ref - pulse->filter.mc.refs.value[last]) << PULSE_MC_SLOPE_FRAC_BITS) / span
+    : 0;
+
+  // Ring is full - oldest reference is dropped
+  if (count == PULSE_MC_REF_COUNT) {
+    pulse->filter.mc.refs.tail = (pulse->filter.mc.refs.tail + 1) & PULSE_MC_REF_INDEX_MASK;
+    count--;
   }
-#endif
 
-  pulse->detect.prev = filtered;
-  pulse->last_process_timestamp = runtime_get();
+  pulse->filter.mc.refs.index[head] = (uint16_t) index;
+  pulse->filter.mc.refs.value[head] = (int16_t) ref;
+  pulse->filter.mc.refs.slope[head] = (int16_t) slope;
+  pulse->filter.mc.refs.count       = count + 1;
+  pulse->filter.mc.refs.last        = index;
 
-  return err;
+  return E_OK;
 }
+#endif
 
 error_t pulse_approximate_bpm(pulse_t * pulse, uint32_t * bpm) {
   ASSERT_RETURN(pulse && bpm, E_NULL);
 
-  uint32_t avg_beat_time = 0;
-  uint32_t beat_count = 0;
+  return pulse->engine->get_bpm(pulse, bpm);
+}
+
+error_t pulse_get_avg_bpm(pulse_t * pulse, uint32_t * bpm) {
+  ASSERT_RETURN(pulse && bpm, E_NULL);
 
-  // TODO: Value needs to stabilize, over at least 10-16 samples
-  for (uint32_t i = 0; i < PULSE_BEAT_APPROX_SAMPLES; ++i) {
-    if (pulse->approx.beats[i]) {
-      avg_beat_time += pulse->approx.beats[i];
-      beat_count++;
-    }
+  if (!pulse->total.avg_interval) {
+    return E_AGAIN;
   }
-  avg_beat_time /= beat_count;
 
-  uint32_t bpms = 1000000 / avg_beat_time;
-  pulse->approx.bpm = 60 * bpms / 1000;
+  *bpm = pulse_interval_to_bpm(pulse->total.avg_interval, PULSE_AVG_INTERVAL_FRAC_BITS);
 
-  *bpm = pulse->approx.bpm;
+  return E_OK;
+}
+
+bool pulse_has_contact(pulse_t * pulse) {
+  ASSERT_RETURN(pulse, false);
+
+  return pulse->quality.no_contact < PULSE_NO_CONTACT_SAMPLES;
+}
+
+error_t pulse_get_perfusion_index(pulse_t * pulse, uint32_t * pi) {
+  ASSERT_RETURN(pulse && pi, E_NULL);
+
+  if (!pulse_has_contact(pulse) || pulse->filter.dc.baseline <= 0) {
+    return E_AGAIN;
+  }
+
+  // PI = AC / DC * 100%, division is fine here - it's not on per sample path
+  *pi = ((uint64_t) pulse->quality.ac * 10000) / ((uint64_t) pulse->filter.dc.baseline << 8);
 
   return E_OK;
 }
 
+#if USE_PULSE_HRV
+error_t pulse_get_hrv(pulse_t * pulse, hrv_metrics_t * metrics) {
+  ASSERT_RETURN(pulse && metrics, E_NULL);
+
+  return hrv_get(&pulse->hrv, metrics);
+}
+#endif
+
+#if USE_PULSE_RHYTHM
+error_t pulse_get_rhythm_score(pulse_t * pulse, uint32_t * score) {
+  ASSERT_RETURN(pulse && score, E_NULL);
+
+  return rhythm_get_score(&pulse->rhythm, score);
+}
+
+bool pulse_is_rhythm_irregular(pulse_t * pulse) {
+  ASSERT_RETURN(pulse, false);
+
+  return rhythm_is_irregular(&pulse->rhythm);
+}
+#endif
+
+#if USE_PULSE_RESP
+error_t pulse_get_resp_rate(pulse_t * pulse, uint32_t * rate) {
+  ASSERT_RETURN(pulse && rate, E_NULL);
+
+  return resp_get_rate(&pulse->resp, rate);
+}
+#endif
+
 error_t pulse_report_bpm(pulse_t * pulse) {
   ASSERT_RETURN(pulse, E_NULL);
 
   uint32_t bpm = 0;
+  uint32_t avg_bpm = 0;
 
   ERROR_CHECK_RETURN(pulse_approximate_bpm(pulse, &bpm));
+  pulse_get_avg_bpm(pulse, &avg_bpm);
 
 #if PULSE_REPORT_ON_SAME_LINE
   log_printf(ANSI_CURSOR_MOVE_UP(1) "\r" ANSI_ERASE_LINE);
@@ -231,9 +701,9 @@ error_t pulse_report_bpm(pulse_t * pulse) {
 #if PULSE_REPORT_EXT
   log_info("BPM=%d (dt=%d total=%d avg=%d)",
     bpm,
-    pulse->approx.beats[pulse->approx.index ? pulse->approx.index - 1 : PULSE_BEAT_APPROX_SAMPLES - 1],
+    pulse->approx.beats[(pulse->approx.index - 1) & PULSE_BEAT_APPROX_INDEX_MASK],
     pulse->total.beats,
-    PULSE_CALCULATE_BPM_TOTAL_AVG(pulse->total.beats, pulse->total.time)
+    avg_bpm
   );
 #else
   log_printf(ANSI_CURSOR_MOVE_UP(1) "\r" ANSI_ERASE_LINE "BPM=%d", bpm);
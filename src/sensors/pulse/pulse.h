@@ -14,8 +14,15 @@ extern "C" {
 #endif
 
 /* Includes ================================================================= */
+#include "max3010x/max3010x.h"
 #include "error/error.h"
 #include "time/time.h"
+#include "sensors/pulse/sample_rate.h"
+#include "sensors/pulse/hrv.h"
+#include "sensors/pulse/rhythm.h"
+#include "sensors/pulse/resp.h"
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 /* Defines ================================================================== */
@@ -32,110 +39,316 @@ extern "C" {
 /**
  * Number of approximation samples
  * Each sample consists of a time difference with previous heartbeat
+ *
+ * @note Must be a power of 2, buffer index is wrapped with a mask
  */
 #define PULSE_BEAT_APPROX_SAMPLES 32
 
-/** Low Pass Filter Config  */
-#define PULSE_LPF_SCALE 256
-#define PULSE_LPF_ALPHA 16 // alpha = 16/256 ~ 0.0625
+/**
+ * Beat interval outlier rejection
+ *
+ * Once there are PULSE_BEAT_OUTLIER_MIN_COUNT intervals in approximation
+ * buffer, interval that differs from median by more than
+ * median >> PULSE_BEAT_OUTLIER_SHIFT doesn't enter the buffer. Too short one
+ * is a double detection (beat is dropped), too long one is a missed beat (beat
+ * becomes a reference for the next one).
+ *
+ * Each rejection adds 2 to outlier score & each accepted interval takes 1
+ * from it, once score reaches PULSE_BEAT_OUTLIER_MAX_SCORE rhythm is
+ * considered changed & buffer is restarted. So a real rate change is picked up
+ * even when every other beat passes (e.g. 2 short intervals, that add up to
+ * one within tolerance)
+ */
+#define PULSE_BEAT_OUTLIER_SHIFT     2 // +-25%
+#define PULSE_BEAT_OUTLIER_MIN_COUNT 8
+#define PULSE_BEAT_OUTLIER_MAX_SCORE 16
 
-/** Gauss Filter Config */
+/**
+ * Average BPM smoothing (EMA of beat interval, alpha = 1/2^SHIFT)
+ */
+#define PULSE_AVG_BPM_EMA_SHIFT 8
 
-#if 0
-#define PULSE_GAUSS_WINDOW_SIZE 5
-#define PULSE_GAUSS_COEFFICIENTS ((int32_t[]){1, 4, 6, 4, 1})
-#define PULSE_GAUSS_FACTOR      16
-#endif
+/**
+ * Max number of beats reported by a single pulse_process_block call
+ *
+ * @note Beats are at least PULSE_MIN_BEAT_TIME_DELTA apart, so a block of
+ *       FIFO samples (up to 32) won't contain more than block time divided
+ *       by it (2 at 100Hz, 6 at 25Hz), rest is a margin
+ */
+#define PULSE_BLOCK_MAX_BEATS (32 * PULSE_SAMPLE_PERIOD_MS / PULSE_MIN_BEAT_TIME_DELTA + 3)
+
+/** Low Pass Filter Config (alpha = 16/256 ~ 0.0625 @ 100Hz) */
+#define PULSE_LPF_SCALE  256
+#define PULSE_LPF_TAU_MS 160
+#define PULSE_LPF_ALPHA  (PULSE_LPF_SCALE * PULSE_SAMPLE_PERIOD_MS / PULSE_LPF_TAU_MS)
+
+/**
+ * DC Filter baseline smoothing (EMA, alpha = 1/2^SHIFT), ~2.5s
+ */
+#define PULSE_DC_FILTER_SHIFT PULSE_MS_TO_SHIFT(2560)
 
-#if 1
+/**
+ * Gauss Filter Kernel Presets (3, 5, 7 & 9 taps)
+ */
+#define PULSE_GAUSS_3_COEFFICIENTS {64, 128, 64}
+#define PULSE_GAUSS_3_FACTOR       256
+#define PULSE_GAUSS_5_COEFFICIENTS {16, 64, 96, 64, 16}
+#define PULSE_GAUSS_5_FACTOR       256
+#define PULSE_GAUSS_7_COEFFICIENTS {1, 6, 15, 20, 15, 6, 1}
+#define PULSE_GAUSS_7_FACTOR       64
+#define PULSE_GAUSS_9_COEFFICIENTS {1, 4, 11, 20, 26, 20, 11, 4, 1}
+#define PULSE_GAUSS_9_FACTOR       64 // original: 98
+
+/**
+ * Gauss Filter Config
+ *
+ * Window size selects one of the kernel presets above. By default it
+ * follows sample rate, so kernel spans about the same time (~40ms, 5 taps
+ * at 100Hz, 3 taps at 50Hz & below, 9 taps at 200Hz & above). Custom kernel
+ * can be used by defining PULSE_GAUSS_WINDOW_SIZE, PULSE_GAUSS_COEFFICIENTS
+ * & PULSE_GAUSS_FACTOR together
+ *
+ * Kernel is centred on the middle sample of the window, so the filter has a
+ * constant delay of (PULSE_GAUSS_WINDOW_SIZE - 1) / 2 samples (20ms for 5
+ * taps at 100Hz). Previous implementation applied the kernel rotated (peak
+ * tap on the newest sample, outer taps on ages 2, 3 & 4), which wasn't a
+ * proper low pass & delayed the signal by ~1.6 samples on average, so beats
+ * are now detected up to ~0.5 sample later. Beat intervals aren't affected,
+ * since delay is constant
+ *
+ * @note Window size must be odd & coefficients must be symmetric
+ * @note If factor is a power of 2, normalization is done with a shift
+ */
+#ifndef PULSE_GAUSS_WINDOW_SIZE
+#if PULSE_SAMPLE_RATE_HZ >= 200
+#define PULSE_GAUSS_WINDOW_SIZE 9
+#elif PULSE_SAMPLE_RATE_HZ >= 100
 #define PULSE_GAUSS_WINDOW_SIZE 5
-#define PULSE_GAUSS_COEFFICIENTS ((int32_t[]){16, 64, 96, 64, 16})
-#define PULSE_GAUSS_FACTOR      256
+#else
+#define PULSE_GAUSS_WINDOW_SIZE 3
 #endif
-
-#if 0
-#define PULSE_GAUSS_WINDOW_SIZE  7
-#define PULSE_GAUSS_COEFFICIENTS ((int32_t[]){1, 6, 15, 20, 15, 6, 1})
-#define PULSE_GAUSS_FACTOR       64
 #endif
 
-#if 0
-#define PULSE_GAUSS_WINDOW_SIZE  9
-#define PULSE_GAUSS_COEFFICIENTS ((int32_t[]){1, 4, 11, 20, 26, 20, 11, 4, 1})
-#define PULSE_GAUSS_FACTOR       64 // original: 98
+#ifndef PULSE_GAUSS_COEFFICIENTS
+#if PULSE_GAUSS_WINDOW_SIZE == 3
+#define PULSE_GAUSS_COEFFICIENTS PULSE_GAUSS_3_COEFFICIENTS
+#define PULSE_GAUSS_FACTOR       PULSE_GAUSS_3_FACTOR
+#elif PULSE_GAUSS_WINDOW_SIZE == 5
+#define PULSE_GAUSS_COEFFICIENTS PULSE_GAUSS_5_COEFFICIENTS
+#define PULSE_GAUSS_FACTOR       PULSE_GAUSS_5_FACTOR
+#elif PULSE_GAUSS_WINDOW_SIZE == 7
+#define PULSE_GAUSS_COEFFICIENTS PULSE_GAUSS_7_COEFFICIENTS
+#define PULSE_GAUSS_FACTOR       PULSE_GAUSS_7_FACTOR
+#elif PULSE_GAUSS_WINDOW_SIZE == 9
+#define PULSE_GAUSS_COEFFICIENTS PULSE_GAUSS_9_COEFFICIENTS
+#define PULSE_GAUSS_FACTOR       PULSE_GAUSS_9_FACTOR
+#else
+#error "No Gauss kernel preset for PULSE_GAUSS_WINDOW_SIZE"
 #endif
+#endif
+
+/**
+ * Motion Canceller Config (USE_PULSE_MOTION_CANCELLER)
+ *
+ * NLMS adaptive filter, that estimates motion artifact from accelerometer
+ * magnitude (reference) & subtracts it from DC filtered signal, before beat
+ * detection. Weights are in fixed point with PULSE_MC_WEIGHT_FRAC_BITS
+ *
+ * Accelerometer samples are stamped with PPG sample index, at which they were
+ * taken, & kept in a ring of PULSE_MC_REF_COUNT entries. Each PPG sample gets
+ * a reference, that is linearly interpolated between the entries around it
+ *
+ * @note Weights are adapted only while reference power is above
+ *       PULSE_MC_MIN_POWER, so they don't drift when there is no motion
+ * @note Ring has to cover accelerometer samples, that arrive ahead of PPG
+ *       (FIFO latency difference), 32 entries are 640ms @ 50Hz
+ */
+#define PULSE_MC_TAPS             8
+#define PULSE_MC_MU_SHIFT         7 // mu = 1/128
+#define PULSE_MC_WEIGHT_FRAC_BITS 12
+#define PULSE_MC_WEIGHT_MAX       (4 << PULSE_MC_WEIGHT_FRAC_BITS)
+#define PULSE_MC_REF_MAX          4095
+#define PULSE_MC_REF_DC_SHIFT     4
+#define PULSE_MC_ERROR_MAX        (1 << 18)
+#define PULSE_MC_MIN_POWER        (PULSE_MC_TAPS * 64 * 64) // ~0.03g @ 16G range
+#define PULSE_MC_REF_COUNT        32
+#define PULSE_MC_SLOPE_FRAC_BITS  2 // |slope| <= 2 * PULSE_MC_REF_MAX, so it fits int16
+
+/**
+ * Autocorrelation Engine Config (PULSE_ENGINE=pulse_engine_acf)
+ *
+ * Autocorrelation of first difference of decimated signal (so baseline wander
+ * doesn't shift the peak) is kept for every lag, that corresponds to a valid
+ * beat interval & is updated with each sample as an EMA, so nothing is
+ * recomputed per window. Beat interval is the first lag with a local maximum
+ * above r[0] >> PULSE_ACF_PEAK_SHIFT, refined with parabolic interpolation
+ */
+#define PULSE_ACF_DECIMATION_SHIFT (PULSE_SAMPLE_RATE_HZ > 50 ? 1 : 0) // 50Hz @ 100Hz
+#define PULSE_ACF_DECIMATION       (1 << PULSE_ACF_DECIMATION_SHIFT)
+#define PULSE_ACF_EMA_SHIFT        PULSE_MS_TO_SHIFT(2560 / PULSE_ACF_DECIMATION) // ~2.5s
+#define PULSE_ACF_PEAK_SHIFT       1
+#define PULSE_ACF_INPUT_SHIFT      4 // Gain, so EMA doesn't lose weak signals to truncation
+#define PULSE_ACF_INPUT_MAX        ((1 << 14) - 1)
+
+/** Lag range (in decimated samples), that covers valid beat intervals */
+#define PULSE_ACF_MIN_LAG (PULSE_MIN_BEAT_TIME_DELTA / (PULSE_SAMPLE_PERIOD_MS * PULSE_ACF_DECIMATION))
+#define PULSE_ACF_MAX_LAG (PULSE_MAX_BEAT_TIME_DELTA / (PULSE_SAMPLE_PERIOD_MS * PULSE_ACF_DECIMATION))
+
+/** Number of tracked lags (with one extra lag on each side, for interpolation) */
+#define PULSE_ACF_LAGS (PULSE_ACF_MAX_LAG - PULSE_ACF_MIN_LAG + 3)
+
+/** Length of decimated sample history */
+#define PULSE_ACF_HISTORY (PULSE_ACF_MAX_LAG + 2)
+
+/** Number of decimated samples, before first estimate */
+#define PULSE_ACF_WARMUP (PULSE_ACF_HISTORY + (1 << PULSE_ACF_EMA_SHIFT))
+
+/**
+ * Weighted Moving Average Window(Buffer) Size, 320ms (32 samples @ 100Hz)
+ *
+ * @note Must be a power of 2, ring buffer index is wrapped with a mask
+ */
+#define PULSE_WMA_BUFFER_SIZE PULSE_MS_TO_SAMPLES(320)
 
 /**
- * Weighted Moving Average Window(Buffer) Size
+ * Sum of Weighted Moving Average weights. Weight of each sample in the
+ * window is equal to its age (0 for newest, PULSE_WMA_BUFFER_SIZE-1 for oldest)
  */
-#define PULSE_WMA_BUFFER_SIZE 32
+#define PULSE_WMA_WEIGHTS_SUM (PULSE_WMA_BUFFER_SIZE * (PULSE_WMA_BUFFER_SIZE - 1) / 2)
 
 /**
- * Thresholds for filtered ADC values
+ * Thresholds for filtered ADC values (peak engine). Filtered signal has
+ * about the same amplitude at any rate (filters are defined in ms), but it
+ * changes more between two samples at lower rates. Rising edge has to land
+ * a sample inside the window, so its width (50 at 100Hz, where it was
+ * tuned) grows with sample period
  */
 #define PULSE_FILTERED_MIN_THRESHOLD 210
-#define PULSE_FILTERED_MAX_THRESHOLD 260
+#define PULSE_FILTERED_MAX_THRESHOLD (PULSE_FILTERED_MIN_THRESHOLD + 5 * PULSE_SAMPLE_PERIOD_MS)
 
 /**
  * Beat time delta min/max values
  */
 #define PULSE_MIN_BEAT_TIME_DELTA 250  // Max BPM ~ 240
-#define PULSE_MAX_BEAT_TIME_DELTA 1200 // Min BPM ~ 50
+#define PULSE_MAX_BEAT_TIME_DELTA 2000 // Min BPM ~ 30, bradycardia (< 40) has to be measured
 
-/* Macros =================================================================== */
 /**
- * Calculate average BPM from total beats count & total time(in ms) in which
- * those beats happened
- *
- * @param __total_beats   Beats count
- * @param __total_time_ms Milliseconds
+ * Min beat time delta, in samples
+ */
+#define PULSE_MIN_BEAT_SAMPLES (PULSE_MIN_BEAT_TIME_DELTA / PULSE_SAMPLE_PERIOD_MS)
+
+/**
+ * Number of consecutive samples below raw threshold, after which contact is
+ * considered lost (1s)
+ */
+#define PULSE_NO_CONTACT_SAMPLES (1000 / PULSE_SAMPLE_PERIOD_MS)
+
+/**
+ * AC amplitude smoothing (EMA of |AC|, alpha = 1/2^SHIFT), ~320ms
+ */
+#define PULSE_QUALITY_AC_SHIFT PULSE_MS_TO_SHIFT(320)
+
+/**
+ * Min perfusion index (0.01%), below which signal is considered too weak
+ * for reliable beat detection
  */
-#define PULSE_CALCULATE_BPM_TOTAL_AVG(__total_beats, __total_time_ms) \
-  (60 * (1000000 / (__total_time_ms / __total_beats)) / 1000)
+#define PULSE_MIN_PERFUSION_INDEX 20
 
+/* Macros =================================================================== */
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
+/**
+ * Pulse detector engine (see pulse_engine.h)
+ */
+typedef struct pulse_engine pulse_engine_t;
+
+/**
+ * Beats detected in a block of samples
+ */
+typedef struct {
+  /** Indexes of samples (in processed block) on which beats were detected */
+  uint8_t position[PULSE_BLOCK_MAX_BEATS];
+
+  /** Number of detected beats */
+  uint8_t count;
+} pulse_beats_t;
+
 /**
  * Pulse detector context
  */
 typedef struct {
-  /** Timestamp of last time pulse_process_sample was called */
-  milliseconds_t last_process_timestamp;
+  /**
+   * Index of next sample in the sample stream. Used as a time base - each
+   * sample is PULSE_SAMPLE_PERIOD_MS apart from the previous one
+   */
+  uint32_t sample_index;
 
   /** Total counters */
   struct {
     uint32_t beats;
     uint32_t time;
+
+    /** Long term average beat interval (ms, Q8), see PULSE_AVG_BPM_EMA_SHIFT */
+    int32_t avg_interval;
   } total;
 
   /** Beat Detection Context */
   struct {
-    enum {
-      PULSE_DETECT_STATE_IDLE = 0,
-      PULSE_DETECT_STATE_SLOPE_UP,
-      PULSE_DETECT_STATE_SLOPE_PEAK,
-      PULSE_DETECT_STATE_COOLDOWN,
-    } state;
-
-    /** Previous filtered value */
-    uint32_t prev;
-
     /** Threshold that raw ADC value has to surpass */
     uint32_t raw_threshold;
 
-    /** Timestamp of last detect heartbeat */
-    milliseconds_t last_beat_timestamp;
+    /** Sample index of last detected heartbeat */
+    uint32_t last_beat_index;
+
+    /** Last heartbeat can be used as a reference for the next one */
+    bool has_reference;
+
+    /** Number of samples left, while sensor settings settle (no detection) */
+    uint32_t blank;
   } detect;
 
+  /** Signal Quality Context */
+  struct {
+    /** AC amplitude (EMA of |AC|, Q8) */
+    int32_t ac;
+
+    /** Number of consecutive samples below raw threshold */
+    uint32_t no_contact;
+  } quality;
+
   /** BPM Approximation Context */
   struct {
-    uint32_t beats[PULSE_BEAT_APPROX_SAMPLES];
+    uint16_t beats[PULSE_BEAT_APPROX_SAMPLES];
     uint32_t index;
 
+    /** Number of samples in buffer */
+    uint32_t count;
+
+    /** Same samples, kept in ascending order (for median) */
+    uint16_t sorted[PULSE_BEAT_APPROX_SAMPLES];
+
+    /** Outlier score (see PULSE_BEAT_OUTLIER_MAX_SCORE) */
+    uint32_t outliers;
+
     /** Last approximated value */
     uint32_t bpm;
   } approx;
 
+#if USE_PULSE_HRV
+  /** Heart Rate Variability (accepted intervals only) */
+  hrv_t hrv;
+#endif
+
+#if USE_PULSE_RHYTHM
+  /** Irregular rhythm detector (accepted intervals only) */
+  rhythm_t rhythm;
+#endif
+
+#if USE_PULSE_RESP
+  /** Respiratory rate (from DC filter baseline) */
+  resp_t resp;
+#endif
+
   /** Filters Context */
   struct {
     /** Low Pass Filter */
@@ -148,21 +361,103 @@ typedef struct {
       int32_t baseline;
     } dc;
 
-    /** Gauss Filter */
+#if USE_PULSE_MOTION_CANCELLER
+    /** Motion Canceller (NLMS) */
     struct {
-      int32_t  buffer[PULSE_GAUSS_WINDOW_SIZE];
+      /** References (accelerometer magnitude without DC), stamped with PPG sample index */
+      struct {
+        uint16_t index[PULSE_MC_REF_COUNT];
+        int16_t  value[PULSE_MC_REF_COUNT];
+
+        /** Slope from previous entry (per PPG sample, Q PULSE_MC_SLOPE_FRAC_BITS) */
+        int16_t slope[PULSE_MC_REF_COUNT];
+
+        /** Index of the newest reference (full width, so order check doesn't wrap) */
+        uint32_t last;
+
+        /** Oldest entry & number of entries */
+        uint8_t tail;
+        uint8_t count;
+      } refs;
+
+      /** Reference DC baseline (Q8) */
+      int32_t ref_dc;
+
+      /** Reference history is stored twice, so it can always be read contiguously */
+      int32_t  buffer[PULSE_MC_TAPS * 2];
       uint32_t index;
-    } gauss;
 
-    /** Weighted Moving Average */
+      /** Reference power (sum of squares) over history */
+      uint32_t power;
+
+      /** Filter weights (oldest to newest reference sample) */
+      int32_t weights[PULSE_MC_TAPS];
+    } mc;
+#endif
+
+  } filter;
+
+  /** Engine, that turns filtered samples into beats/BPM */
+  const pulse_engine_t * engine;
+
+  /** Engine Context */
+  union {
+    /** Peak Detector Engine */
     struct {
-      int32_t  buffer[PULSE_WMA_BUFFER_SIZE];
+      enum {
+        PULSE_DETECT_STATE_IDLE = 0,
+        PULSE_DETECT_STATE_SLOPE_UP,
+        PULSE_DETECT_STATE_SLOPE_PEAK,
+        PULSE_DETECT_STATE_COOLDOWN,
+      } state;
+
+      /** Previous filtered value */
+      int32_t prev;
+
+      /** Gauss Filter */
+      struct {
+        /** Window is stored twice, so it can always be read contiguously */
+        int32_t  buffer[PULSE_GAUSS_WINDOW_SIZE * 2];
+        uint32_t index;
+      } gauss;
+
+      /** Weighted Moving Average */
+      struct {
+        int32_t  buffer[PULSE_WMA_BUFFER_SIZE];
+        uint32_t index;
+
+        /** Running sum of samples in window */
+        int32_t sum;
+
+        /** Running weighted sum of samples in window */
+        int32_t weighted_sum;
+      } wma;
+    } peak;
+
+    /** Autocorrelation Engine */
+    struct {
+      /** Decimation accumulator & number of samples in it */
+      int32_t  acc;
+      uint32_t phase;
+
+      /** Previous decimated sample */
+      int32_t prev;
+
+      /** Decimated sample history is stored twice, so it can always be read contiguously */
+      int16_t  history[PULSE_ACF_HISTORY * 2];
       uint32_t index;
 
-      int32_t weights[PULSE_WMA_BUFFER_SIZE];
-      int32_t weights_sum;
-    } wma;
-  } filter;
+      /** Number of decimated samples since reset (saturates at PULSE_ACF_WARMUP) */
+      uint32_t count;
+
+      /** Autocorrelation at lag 0 (signal power) & at PULSE_ACF_MIN_LAG-1..PULSE_ACF_MAX_LAG+1 */
+      int32_t r0;
+      int32_t r[PULSE_ACF_LAGS];
+
+      /** Estimated beat interval (ms, Q8), 0 if there is no estimate */
+      uint32_t interval;
+    } acf;
+  };
 } pulse_t;
 
 /* Variables ================================================================ */
@@ -177,30 +472,179 @@ typedef struct {
  */
 error_t pulse_init(pulse_t * pulse, int32_t raw_threshold, int32_t dcf_init_shift);
 
+/**
+ * Replace engine, that was selected with PULSE_ENGINE. Engine context is reset
+ *
+ * @param pulse Pulse Detector Context
+ * @param engine Pulse detector engine
+ */
+error_t pulse_set_engine(pulse_t * pulse, const pulse_engine_t * engine);
+
 /**
  * Process single raw ADC sample
  *
  * @param pulse Pulse Detector Context
  * @param sample Raw ADC value
  * @return E_OK if heartbeat was detected, E_AGAIN if not, E_OUTOFBOUNDS if value
- *         didn't pass thresholds
+ *         is below raw threshold
  */
 error_t pulse_process_sample(pulse_t * pulse, int32_t sample);
 
 /**
- * Approximate BPM based on last PULSE_BEAT_APPROX_SAMPLES heartbeats
+ * Process a block of samples (whole MAX3010x FIFO batch)
+ *
+ * Runs all samples through the filter chain & selected engine in a single pass
+ *
+ * @param pulse Pulse Detector Context
+ * @param samples MAX3010x samples (only IR channel is used)
+ * @param size Number of samples
+ * @param beats Where to put detected beats (optional, can be NULL)
+ * @return E_OK if at least one heartbeat was detected, E_AGAIN if not
+ */
+error_t pulse_process_block(
+  pulse_t * pulse, const max3010x_sample_t * samples, size_t size, pulse_beats_t * beats
+);
+
+/**
+ * Advance time base by a number of samples, that were lost (e.g. on
+ * MAX3010x FIFO overflow), so intervals between beats stay correct
+ *
+ * @param pulse Pulse Detector Context
+ * @param count Number of lost samples
+ */
+error_t pulse_skip_samples(pulse_t * pulse, uint32_t count);
+
+/**
+ * Handle sensor settings change (LED current, ADC range). DC level jumps, so
+ * beat detection is blanked for a number of samples, while LPF & DC filter
+ * are re-seeded from raw samples - they start from the new level afterwards.
+ * Samples are still counted, so beat intervals stay correct
+ *
+ * @param pulse Pulse Detector Context
+ * @param samples Number of samples to blank
+ */
+error_t pulse_settle(pulse_t * pulse, uint32_t samples);
+
+/**
+ * Restart contact detection (e.g. after sensor was powered down), so contact
+ * is considered lost only after PULSE_NO_CONTACT_SAMPLES new samples below
+ * threshold
+ *
+ * @param pulse Pulse Detector Context
+ */
+error_t pulse_reset_contact(pulse_t * pulse);
+
+#if USE_PULSE_MOTION_CANCELLER
+/**
+ * Add motion reference from accelerometer sample, that was taken at the same
+ * time as PPG sample with given index (see pulse_t.sample_index). Index may be
+ * ahead of samples, that were processed so far - reference is kept, until PPG
+ * catches up. Every PPG sample gets reference interpolated between the ones
+ * around it (newest one is held, while there is nothing newer)
+ *
+ * @note References have to be added in order of index, ones with the same
+ *       index replace each other
+ * @note Magnitude is approximated with |x| + |y| + |z| (no square root)
+ *
+ * @param pulse Pulse Detector Context
+ * @param index PPG sample index, at which accelerometer sample was taken
+ * @param x Acceleration X (raw)
+ * @param y Acceleration Y (raw)
+ * @param z Acceleration Z (raw)
+ * @return E_INVAL if index is older than the last added one
+ */
+error_t pulse_add_motion_reference(pulse_t * pulse, uint32_t index, int16_t x, int16_t y, int16_t z);
+#endif
+
+/**
+ * Approximate BPM, using selected engine
  *
- * Uses an array of time differences from previous heartbeats:
+ * Peak detector uses median of last PULSE_BEAT_APPROX_SAMPLES heartbeats, as an
+ * array of time differences from previous heartbeats:
  * x[i] = HB_TS - x[i-1]
  * x - Approximation sample buffer
  * HB_TS - HeatBeat TimeStamp (current)
  *
+ * Autocorrelation engine uses estimated beat interval directly
+ *
  * @param pulse Pulse Detector Context
  * @param bpm Where to put approximated BPM
- * @return E_OK if approximation was successful, E_AGAIN - if buffer isn't full
+ * @return E_OK if approximation was successful, E_AGAIN - if value isn't stable yet
  */
 error_t pulse_approximate_bpm(pulse_t * pulse, uint32_t * bpm);
 
+/**
+ * Get long term average BPM (over ~2^PULSE_AVG_BPM_EMA_SHIFT heartbeats)
+ *
+ * @param pulse Pulse Detector Context
+ * @param bpm Where to put average BPM
+ * @return E_OK on success, E_AGAIN - if no heartbeat intervals were measured yet
+ */
+error_t pulse_get_avg_bpm(pulse_t * pulse, uint32_t * bpm);
+
+/**
+ * Check if sensor is in contact with skin (raw samples didn't stay below
+ * threshold for PULSE_NO_CONTACT_SAMPLES)
+ *
+ * @param pulse Pulse Detector Context
+ */
+bool pulse_has_contact(pulse_t * pulse);
+
+/**
+ * Get perfusion index (AC amplitude relative to DC baseline), which is used as
+ * a signal quality measure
+ *
+ * @param pulse Pulse Detector Context
+ * @param pi Where to put perfusion index (0.01%)
+ * @return E_OK on success, E_AGAIN - if there is no contact
+ */
+error_t pulse_get_perfusion_index(pulse_t * pulse, uint32_t * pi);
+
+#if USE_PULSE_HRV
+/**
+ * Get Heart Rate Variability metrics
+ *
+ * @note Autocorrelation engine doesn't provide beat timing, so there are no
+ *       metrics with it
+ *
+ * @param pulse Pulse Detector Context
+ * @param metrics Where to put HRV metrics
+ * @return E_OK on success, E_AGAIN - if there are not enough intervals yet
+ */
+error_t pulse_get_hrv(pulse_t * pulse, hrv_metrics_t * metrics);
+#endif
+
+#if USE_PULSE_RHYTHM
+/**
+ * Get irregular rhythm score
+ *
+ * @note Like HRV, it's only available with beat aligned engines
+ *
+ * @param pulse Pulse Detector Context
+ * @param score Where to put score (mean absolute successive difference, % of mean interval)
+ * @return E_OK on success, E_AGAIN - if there are not enough intervals yet
+ */
+error_t pulse_get_rhythm_score(pulse_t * pulse, uint32_t * score);
+
+/**
+ * Check if rhythm is irregular (score is above RHYTHM_IRREGULAR_THRESHOLD)
+ *
+ * @param pulse Pulse Detector Context
+ */
+bool pulse_is_rhythm_irregular(pulse_t * pulse);
+#endif
+
+#if USE_PULSE_RESP
+/**
+ * Get respiratory rate
+ *
+ * @param pulse Pulse Detector Context
+ * @param rate Where to put rate (breaths/min)
+ * @return E_OK on success, E_AGAIN - if there are not enough breaths yet
+ */
+error_t pulse_get_resp_rate(pulse_t * pulse, uint32_t * rate);
+#endif
+
 /**
  * Print approximated BPM
  *
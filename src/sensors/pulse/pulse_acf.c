@@ -0,0 +1,158 @@
+/** ========================================================================= *
+ *
+ * @file pulse_acf.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Autocorrelation Engine. Estimates beat interval from autocorrelation
+ *        of (decimated) filtered signal, which is kept up to date with each
+ *        sample, instead of being recomputed over a window
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/pulse/pulse_engine.h"
+
+/* Defines ================================================================== */
+/** Fractional bits of estimated lag & beat interval */
+#define PULSE_ACF_FRAC_BITS 8
+
+#if PULSE_ACF_MIN_LAG < 2
+#error "PULSE_ACF_MIN_LAG is too low, increase sample rate or lower decimation"
+#endif
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+/**
+ * Add decimated sample to history & update autocorrelation
+ *
+ * r[i] holds autocorrelation at lag PULSE_ACF_MIN_LAG-1+i, each one is an EMA
+ * of x[n] * x[n-lag], so it costs one multiply per tracked lag
+ */
+__STATIC_INLINE void acf_update(pulse_t * pulse, int32_t x) {
+  uint32_t index = pulse->acf.index;
+
+  x <<= PULSE_ACF_INPUT_SHIFT;
+  x = x >  PULSE_ACF_INPUT_MAX ?  PULSE_ACF_INPUT_MAX : x;
+  x = x < -PULSE_ACF_INPUT_MAX ? -PULSE_ACF_INPUT_MAX : x;
+
+  pulse->acf.history[index] = x;
+  pulse->acf.history[index + PULSE_ACF_HISTORY] = x;
+
+  index = index + 1 < PULSE_ACF_HISTORY ? index + 1 : 0;
+  pulse->acf.index = index;
+
+  // Whole history (from oldest to newest sample), sample at lag L is window[HISTORY-1-L]
+  const int16_t * window = &pulse->acf.history[index];
+  const int16_t * lagged = &window[PULSE_ACF_HISTORY - PULSE_ACF_MIN_LAG];
+  int32_t       * r      = pulse->acf.r;
+
+  pulse->acf.r0 += (x * x - pulse->acf.r0) >> PULSE_ACF_EMA_SHIFT;
+
+  for (int32_t i = 0; i < PULSE_ACF_LAGS; ++i) {
+    r[i] += (x * lagged[-i] - r[i]) >> PULSE_ACF_EMA_SHIFT;
+  }
+
+  if (pulse->acf.count < PULSE_ACF_WARMUP) {
+    pulse->acf.count++;
+  }
+}
+
+/**
+ * Find beat interval - first local maximum of autocorrelation, that is high
+ * enough relative to signal power. Runs once per block, so division is fine
+ */
+static void acf_estimate(pulse_t * pulse) {
+  const int32_t * r = pulse->acf.r;
+  int32_t threshold = pulse->acf.r0 >> PULSE_ACF_PEAK_SHIFT;
+
+  pulse->acf.interval = 0;
+
+  if (pulse->acf.count < PULSE_ACF_WARMUP || threshold <= 0) {
+    return;
+  }
+
+  for (uint32_t i = 1; i + 1 < PULSE_ACF_LAGS; ++i) {
+    if (r[i] <= threshold || r[i] < r[i - 1] || r[i] <= r[i + 1]) {
+      continue;
+    }
+
+    // Parabolic interpolation between neighbouring lags, offset is within +-0.5
+    int32_t den   = 2 * r[i] - r[i - 1] - r[i + 1];
+    int32_t delta = ((int64_t) (r[i + 1] - r[i - 1]) << (PULSE_ACF_FRAC_BITS - 1)) / den;
+    int32_t lag   = ((PULSE_ACF_MIN_LAG - 1 + i) << PULSE_ACF_FRAC_BITS) + delta;
+
+    pulse->acf.interval = lag * PULSE_ACF_DECIMATION * PULSE_SAMPLE_PERIOD_MS;
+    return;
+  }
+}
+
+static void acf_init(pulse_t * pulse) {
+  memset(&pulse->acf, 0, sizeof(pulse->acf));
+}
+
+static error_t acf_process_block(
+  pulse_t * pulse, const max3010x_sample_t * samples, size_t size, pulse_beats_t * beats
+) {
+  error_t err = E_AGAIN;
+
+  for (size_t i = 0; i < size; ++i) {
+    int32_t value = 0;
+
+    if (pulse_frontend(pulse, (int32_t) samples[i].ir, &value) == E_OK) {
+      pulse->acf.acc += value;
+
+      if (++pulse->acf.phase == PULSE_ACF_DECIMATION) {
+        int32_t x = pulse->acf.acc >> PULSE_ACF_DECIMATION_SHIFT;
+
+        // First difference suppresses baseline wander, which biases the peak towards shorter lags
+        acf_update(pulse, x - pulse->acf.prev);
+
+        pulse->acf.prev  = x;
+        pulse->acf.acc   = 0;
+        pulse->acf.phase = 0;
+      }
+
+      /* Beats are spaced by estimated interval, so LED, beat counter & average
+       * BPM keep working. Their phase isn't aligned with actual pulse peaks */
+      uint32_t elapsed = (pulse->sample_index - pulse->detect.last_beat_index) * PULSE_SAMPLE_PERIOD_MS;
+
+      if (pulse->acf.interval && (elapsed << PULSE_ACF_FRAC_BITS) >= pulse->acf.interval) {
+        pulse_beat(pulse);
+        pulse_beats_add(beats, i);
+        err = E_OK;
+      }
+    }
+
+    pulse->sample_index++;
+  }
+
+  acf_estimate(pulse);
+
+  return err;
+}
+
+static error_t acf_get_bpm(pulse_t * pulse, uint32_t * bpm) {
+  if (!pulse->acf.interval) {
+    return E_AGAIN;
+  }
+
+  pulse->approx.bpm = pulse_interval_to_bpm(pulse->acf.interval, PULSE_ACF_FRAC_BITS);
+
+  *bpm = pulse->approx.bpm;
+
+  return E_OK;
+}
+
+/* Shared functions ========================================================= */
+const pulse_engine_t pulse_engine_acf = {
+  .name          = "acf",
+  .beat_aligned  = false,
+  .init          = acf_init,
+  .process_block = acf_process_block,
+  .get_bpm       = acf_get_bpm,
+};
@@ -0,0 +1,196 @@
+/** ========================================================================= *
+ *
+ * @file pulse_engine.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Pulse Detector Engine interface. Engine turns samples, that were
+ *        passed through common front end (contact check, LPF, DC filter,
+ *        motion canceller), into heartbeats & BPM
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "sensors/pulse/pulse.h"
+
+/* Defines ================================================================== */
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Pulse Detector Engine operations
+ */
+struct pulse_engine {
+  /** Engine name */
+  const char * name;
+
+  /** Beats are aligned with pulse peaks, so their intervals can be used for HRV */
+  bool beat_aligned;
+
+  /**
+   * Reset engine context. Called on init & when contact is lost
+   *
+   * @param pulse Pulse Detector Context
+   */
+  void (*init)(pulse_t * pulse);
+
+  /**
+   * Process a block of raw samples
+   *
+   * Each sample has to be passed through pulse_frontend first, engine has to
+   * increment pulse->sample_index after each sample & call pulse_beat on
+   * each detected heartbeat
+   *
+   * @param pulse Pulse Detector Context
+   * @param samples MAX3010x samples (only IR channel is used)
+   * @param size Number of samples
+   * @param beats Where to put detected beats (optional, count is reset by caller)
+   * @return E_OK if at least one heartbeat was detected, E_AGAIN if not
+   */
+  error_t (*process_block)(
+    pulse_t * pulse, const max3010x_sample_t * samples, size_t size, pulse_beats_t * beats
+  );
+
+  /**
+   * Get approximated BPM
+   *
+   * @param pulse Pulse Detector Context
+   * @param bpm Where to put approximated BPM
+   * @return E_OK on success, E_AGAIN - if value isn't stable yet
+   */
+  error_t (*get_bpm)(pulse_t * pulse, uint32_t * bpm);
+};
+
+/* Variables ================================================================ */
+/**
+ * Peak Detector Engine. Gauss & WMA filters, followed by slope state machine
+ */
+extern const pulse_engine_t pulse_engine_peak;
+
+/**
+ * Autocorrelation Engine. Estimates beat interval from incrementally updated
+ * autocorrelation of decimated signal
+ */
+extern const pulse_engine_t pulse_engine_acf;
+
+/* Shared functions ========================================================= */
+/**
+ * Pass raw sample through common front end
+ *
+ * @param pulse Pulse Detector Context
+ * @param sample Raw ADC value
+ * @param value Where to put filtered (AC) value
+ * @return E_OK on success, E_OUTOFBOUNDS if sample is below raw threshold
+ */
+error_t pulse_frontend(pulse_t * pulse, int32_t sample, int32_t * value);
+
+/**
+ * Register heartbeat on current sample (updates counters, beat intervals &
+ * average BPM). Intervals, that are outliers relative to median, are rejected
+ *
+ * @param pulse Pulse Detector Context
+ */
+void pulse_beat(pulse_t * pulse);
+
+/**
+ * Get BPM from median of last PULSE_BEAT_APPROX_SAMPLES beat intervals
+ *
+ * @param pulse Pulse Detector Context
+ * @param bpm Where to put approximated BPM
+ * @return E_OK on success, E_AGAIN - if buffer isn't full
+ */
+error_t pulse_beats_get_bpm(pulse_t * pulse, uint32_t * bpm);
+
+/**
+ * Convert beat interval to BPM (without division)
+ *
+ * @param interval Beat interval (ms) in fixed point
+ * @param frac_bits Number of fractional bits in interval
+ */
+uint32_t pulse_interval_to_bpm(uint32_t interval, uint32_t frac_bits);
+
+/**
+ * Add beat to a list of beats detected in a block
+ *
+ * @param beats Beats detected in a block (optional, can be NULL)
+ * @param position Index of sample in block
+ */
+__STATIC_INLINE void pulse_beats_add(pulse_beats_t * beats, size_t position) {
+  if (beats && beats->count < PULSE_BLOCK_MAX_BEATS) {
+    beats->position[beats->count++] = position;
+  }
+}
+
+/**
+ * Put sample into FIR window, that is stored twice, so whole window can
+ * always be read contiguously
+ *
+ * @param buffer Window buffer (2 * size)
+ * @param index Index of the oldest sample, advanced
+ * @param size Window size
+ * @param value New sample
+ * @return Whole window (from oldest to newest sample)
+ */
+__STATIC_INLINE const int32_t * pulse_fir_push(int32_t * buffer, uint32_t * index, uint32_t size, int32_t value) {
+  uint32_t i = *index;
+
+  buffer[i]        = value;
+  buffer[i + size] = value;
+
+  i = i + 1 < size ? i + 1 : 0;
+  *index = i;
+
+  return &buffer[i];
+}
+
+/**
+ * Symmetric FIR (odd size). Kernel is folded - one multiply per pair of taps.
+ * With constant size loop is unrolled, when inlined
+ *
+ * @param kernel Kernel
+ * @param window Window (from oldest to newest sample)
+ * @param size Kernel & window size
+ * @return Accumulator (not normalized)
+ */
+__STATIC_INLINE int32_t pulse_fir_symmetric(const int32_t * kernel, const int32_t * window, uint32_t size) {
+  uint32_t half = size / 2;
+  int32_t  acc  = kernel[half] * window[half];
+
+  for (uint32_t i = 0; i < half; ++i) {
+    acc += kernel[i] * (window[i] + window[size - 1 - i]);
+  }
+
+  return acc;
+}
+
+#if USE_PULSE_BENCH
+/**
+ * Run value through peak engine Weighted Moving Average (for 'pulse bench')
+ *
+ * @param pulse Pulse Detector Context
+ * @param value Filter input
+ * @return Filter output
+ */
+int32_t pulse_peak_bench_wma(pulse_t * pulse, int32_t value);
+
+#if USE_PULSE_MOTION_CANCELLER
+/**
+ * Run value through Motion Canceller at current sample index, with reference
+ * resampled from pulse_add_motion_reference (for 'pulse bench')
+ *
+ * @param pulse Pulse Detector Context
+ * @param value Filter input
+ * @return Filter output
+ */
+int32_t pulse_bench_motion_canceller(pulse_t * pulse, int32_t value);
+#endif
+#endif
+
+#ifdef __cplusplus
+}
+#endif
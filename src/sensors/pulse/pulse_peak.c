@@ -0,0 +1,214 @@
+/** ========================================================================= *
+ *
+ * @file pulse_peak.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Peak Detector Engine. Smooths signal with Gauss & WMA filters and
+ *        detects heartbeats with a slope state machine
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/pulse/pulse_engine.h"
+#include "log/log.h"
+#include "tty/ansi.h"
+
+/* Defines ================================================================== */
+#define LOG_TAG pulse
+
+#if !(PULSE_GAUSS_WINDOW_SIZE & 1)
+#error "PULSE_GAUSS_WINDOW_SIZE must be odd"
+#endif
+
+/** Mask for wrapping Weighted Moving Average buffer index */
+#define PULSE_WMA_INDEX_MASK (PULSE_WMA_BUFFER_SIZE - 1)
+
+#if PULSE_WMA_BUFFER_SIZE & PULSE_WMA_INDEX_MASK
+#error "PULSE_WMA_BUFFER_SIZE must be a power of 2"
+#endif
+
+/**
+ * Reciprocal of PULSE_WMA_WEIGHTS_SUM in Q32, rounded up
+ *
+ * (x * PULSE_WMA_RECIPROCAL) >> 32 is equal to x / PULSE_WMA_WEIGHTS_SUM for
+ * every |x| < 2^32 / PULSE_WMA_WEIGHTS_SUM (|x| < ~8.6M for 32 sample window),
+ * outside of that range result may be 1 greater (by magnitude)
+ */
+#define PULSE_WMA_RECIPROCAL \
+  ((uint32_t) (((1ULL << 32) + PULSE_WMA_WEIGHTS_SUM - 1) / PULSE_WMA_WEIGHTS_SUM))
+
+/* Macros =================================================================== */
+/**
+ * Normalize Gauss filter accumulator by PULSE_GAUSS_FACTOR
+ *
+ * @note Shift rounds towards negative infinity, so for negative values result
+ *       can differ by 1 from division
+ */
+#if (PULSE_GAUSS_FACTOR & (PULSE_GAUSS_FACTOR - 1)) == 0
+#define PULSE_GAUSS_NORMALIZE(__acc) ((__acc) >> __builtin_ctz(PULSE_GAUSS_FACTOR))
+#else
+#define PULSE_GAUSS_NORMALIZE(__acc) ((__acc) / PULSE_GAUSS_FACTOR)
+#endif
+
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/** Gauss filter kernel */
+static const int32_t gauss_kernel[PULSE_GAUSS_WINDOW_SIZE] = PULSE_GAUSS_COEFFICIENTS;
+
+/* Private functions ======================================================== */
+__STATIC_INLINE int32_t gauss_filter(pulse_t * pulse, int32_t value) {
+  const int32_t * window = pulse_fir_push(
+    pulse->peak.gauss.buffer, &pulse->peak.gauss.index, PULSE_GAUSS_WINDOW_SIZE, value
+  );
+
+  return PULSE_GAUSS_NORMALIZE(pulse_fir_symmetric(gauss_kernel, window, PULSE_GAUSS_WINDOW_SIZE));
+}
+
+__STATIC_INLINE int32_t weighted_moving_average(pulse_t * pulse, int32_t value) {
+  // Sample that leaves the window (oldest one, with weight of BUFFER_SIZE-1)
+  int32_t oldest = pulse->peak.wma.buffer[pulse->peak.wma.index];
+
+  pulse->peak.wma.buffer[pulse->peak.wma.index] = value;
+  pulse->peak.wma.index = (pulse->peak.wma.index + 1) & PULSE_WMA_INDEX_MASK;
+
+  /* Every sample ages by 1 (weighted sum grows by sum of samples), new sample
+   * comes in with weight 0 and oldest leaves with weight of BUFFER_SIZE */
+  pulse->peak.wma.weighted_sum += pulse->peak.wma.sum - oldest * PULSE_WMA_BUFFER_SIZE;
+  pulse->peak.wma.sum          += value - oldest;
+
+  // Divide by weights sum (truncating towards zero), using reciprocal
+  int32_t  wsum = pulse->peak.wma.weighted_sum;
+  uint32_t wma  = ((uint64_t) (wsum < 0 ? -wsum : wsum) * PULSE_WMA_RECIPROCAL) >> 32;
+
+  return wsum < 0 ? -(int32_t) wma : (int32_t) wma;
+}
+
+/**
+ * Runs single sample through the front end, smoothing filters & beat detector
+ *
+ * @param pulse Pulse Detector Context
+ * @param sample Raw ADC value
+ * @return E_OK if heartbeat was detected, E_AGAIN if not, E_OUTOFBOUNDS if value
+ *         didn't pass thresholds
+ */
+__STATIC_INLINE error_t peak_process(pulse_t * pulse, int32_t sample) {
+  int32_t dcf_res = 0;
+
+  error_t err = pulse_frontend(pulse, sample, &dcf_res);
+
+  if (err != E_OK) {
+    pulse->sample_index++;
+    return err;
+  }
+
+  err = E_AGAIN;
+
+  int32_t gauss_res = gauss_filter(pulse, dcf_res);
+  int32_t filtered  = weighted_moving_average(pulse, gauss_res);
+
+#if 0
+  uint32_t bpm = 0;
+  uint32_t avg_bpm = 0;
+  pulse_approximate_bpm(pulse, &bpm);
+  pulse_get_avg_bpm(pulse, &avg_bpm);
+
+  log_printf("\r" ANSI_ERASE_LINE "raw=%d f=%d (bpm=%d/%d total=%d)",
+    sample, filtered,
+    pulse->approx.bpm,
+    avg_bpm,
+    pulse->total.beats
+  );
+#endif
+
+  if (filtered > PULSE_FILTERED_MAX_THRESHOLD) {
+    err = E_OUTOFBOUNDS;
+    goto exit;
+  }
+
+  switch (pulse->peak.state) {
+    case PULSE_DETECT_STATE_IDLE: {
+      if (filtered > PULSE_FILTERED_MIN_THRESHOLD && filtered > pulse->peak.prev) {
+        pulse->peak.state = PULSE_DETECT_STATE_SLOPE_UP;
+      }
+      break;
+    }
+
+    case PULSE_DETECT_STATE_SLOPE_UP: {
+      if (filtered < pulse->peak.prev) {
+        pulse->peak.state = PULSE_DETECT_STATE_SLOPE_PEAK;
+      }
+      break;
+    }
+
+    case PULSE_DETECT_STATE_SLOPE_PEAK: {
+      if (filtered < pulse->peak.prev) {
+        pulse_beat(pulse);
+        pulse->peak.state = PULSE_DETECT_STATE_COOLDOWN;
+        err = E_OK;
+      } else {
+        pulse->peak.state = PULSE_DETECT_STATE_SLOPE_UP;
+      }
+      break;
+    }
+
+    case PULSE_DETECT_STATE_COOLDOWN: {
+      if (pulse->sample_index - pulse->detect.last_beat_index >= PULSE_MIN_BEAT_SAMPLES) {
+        pulse->peak.state = PULSE_DETECT_STATE_IDLE;
+      }
+      break;
+    }
+
+    default: {
+      break;
+    }
+  }
+
+exit:
+#if 0
+  log_printf("ir=%d f=%d gauss=%d wma=%d pulse=%d\r\n",
+    sample, dcf_res, gauss_res, filtered, err == E_OK ? 300 : 0
+  );
+#endif
+
+  pulse->peak.prev = filtered;
+  pulse->sample_index++;
+
+  return err;
+}
+
+static void peak_init(pulse_t * pulse) {
+  memset(&pulse->peak, 0, sizeof(pulse->peak));
+}
+
+static error_t peak_process_block(
+  pulse_t * pulse, const max3010x_sample_t * samples, size_t size, pulse_beats_t * beats
+) {
+  error_t err = E_AGAIN;
+
+  for (size_t i = 0; i < size; ++i) {
+    if (peak_process(pulse, (int32_t) samples[i].ir) == E_OK) {
+      pulse_beats_add(beats, i);
+      err = E_OK;
+    }
+  }
+
+  return err;
+}
+
+/* Shared functions ========================================================= */
+#if USE_PULSE_BENCH
+int32_t pulse_peak_bench_wma(pulse_t * pulse, int32_t value) {
+  return weighted_moving_average(pulse, value);
+}
+#endif
+
+const pulse_engine_t pulse_engine_peak = {
+  .name          = "peak",
+  .beat_aligned  = true,
+  .init          = peak_init,
+  .process_block = peak_process_block,
+  .get_bpm       = pulse_beats_get_bpm,
+};
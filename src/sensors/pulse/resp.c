@@ -0,0 +1,115 @@
+/** ========================================================================= *
+ *
+ * @file resp.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/pulse/resp.h"
+#include "error/assertion.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+/** Mask for wrapping window index */
+#define RESP_WINDOW_MASK (RESP_WINDOW - 1)
+
+#if RESP_MIN_BREATHS < 2 || RESP_MIN_BREATHS > RESP_BREATHS
+#error "RESP_MIN_BREATHS must be within [2, RESP_BREATHS]"
+#endif
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+__STATIC_INLINE uint32_t resp_last_breath(resp_t * resp) {
+  return resp->breaths[(resp->breath_index + RESP_BREATHS - 1) % RESP_BREATHS];
+}
+
+static void resp_add_breath(resp_t * resp) {
+  if (resp->breath_count) {
+    uint32_t interval = resp->tick - resp_last_breath(resp);
+
+    if (interval < RESP_MIN_INTERVAL) {
+      return;
+    }
+
+    if (interval > RESP_MAX_INTERVAL) {
+      resp->breath_count = 0;
+    }
+  }
+
+  resp->breaths[resp->breath_index] = resp->tick;
+  resp->breath_index = (resp->breath_index + 1) % RESP_BREATHS;
+
+  if (resp->breath_count < RESP_BREATHS) {
+    resp->breath_count++;
+  }
+}
+
+/* Shared functions ========================================================= */
+error_t resp_init(resp_t * resp, uint32_t sample_rate) {
+  ASSERT_RETURN(resp, E_NULL);
+  ASSERT_RETURN(sample_rate >= RESP_SAMPLE_RATE_HZ, E_INVAL);
+
+  memset(resp, 0, sizeof(resp_t));
+
+  resp->sample_rate = sample_rate;
+  resp->decimation  = sample_rate / RESP_SAMPLE_RATE_HZ;
+
+  return E_OK;
+}
+
+void resp_update(resp_t * resp, int32_t value) {
+  uint32_t index = resp->index;
+
+  resp->sum += value - resp->window[index];
+  resp->window[index] = value;
+  resp->index = (index + 1) & RESP_WINDOW_MASK;
+  resp->tick++;
+
+  if (resp->count < RESP_WINDOW) {
+    resp->count++;
+    return;
+  }
+
+  // Window is centered on its middle sample, so detrending adds no phase shift
+  int32_t center = resp->window[(index - RESP_WINDOW / 2) & RESP_WINDOW_MASK];
+  int32_t x      = center - (resp->sum >> RESP_WINDOW_SHIFT);
+  int32_t abs    = x < 0 ? -x : x;
+
+  // Steps (LED current change, sensor pressure) would inflate amplitude for a while, so they are clipped
+  if (resp->amp && abs > resp->amp << 2) {
+    abs = resp->amp << 2;
+  }
+
+  resp->amp += (abs - resp->amp) >> RESP_AMP_EMA_SHIFT;
+
+  int32_t hysteresis = resp->amp >> 1;
+
+  if (!resp->above && x > hysteresis) {
+    resp->above = true;
+    resp_add_breath(resp);
+  } else if (resp->above && x < -hysteresis) {
+    resp->above = false;
+  }
+}
+
+error_t resp_get_rate(resp_t * resp, uint32_t * rate) {
+  ASSERT_RETURN(resp && rate, E_NULL);
+
+  if (resp->breath_count < RESP_MIN_BREATHS || resp->tick - resp_last_breath(resp) > RESP_MAX_INTERVAL) {
+    return E_AGAIN;
+  }
+
+  uint32_t first = resp->breaths[(resp->breath_index + RESP_BREATHS - resp->breath_count) % RESP_BREATHS];
+  uint32_t span  = (resp_last_breath(resp) - first) * resp->decimation;
+
+  // Span is in input samples, so rate doesn't depend on rounding of decimation
+  *rate = ((resp->breath_count - 1) * 60 * resp->sample_rate + span / 2) / span;
+
+  return E_OK;
+}
@@ -0,0 +1,152 @@
+/** ========================================================================= *
+ *
+ * @file resp.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Respiratory rate. Breathing modulates PPG baseline, which is already
+ *        tracked by DC filter. Baseline is decimated by summation, detrended
+ *        with centered moving average & breaths are counted as zero crossings
+ *        (with hysteresis relative to signal amplitude)
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "error/error.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * Rate of decimated baseline (Hz). If input rate isn't a multiple of it,
+ * actual rate is slightly higher (rate is still calculated with actual one)
+ *
+ * @note Baseline is summed (not averaged) over decimation, so its range times
+ *       RESP_WINDOW times decimation must fit into int32_t
+ */
+#define RESP_SAMPLE_RATE_HZ 4
+
+/**
+ * Detrend window (decimated samples), ~8s. Slow drift (LED current steps,
+ * pressure on the sensor) is removed with it, breathing (>= 6/min) is kept
+ *
+ * @note Must be a power of 2, mean is taken with a shift
+ */
+#define RESP_WINDOW_SHIFT 5
+#define RESP_WINDOW       (1 << RESP_WINDOW_SHIFT)
+
+/**
+ * Amplitude (mean absolute value of detrended signal) smoothing
+ * (EMA, alpha = 1/2^SHIFT). Hysteresis is half of amplitude
+ */
+#define RESP_AMP_EMA_SHIFT 4
+
+/**
+ * Number of breaths (upward crossings), rate is averaged over
+ */
+#define RESP_BREATHS 8
+
+/**
+ * Number of breaths, before rate is reported
+ */
+#define RESP_MIN_BREATHS 4
+
+/**
+ * Breath interval range (decimated samples). Shorter one is noise (pulse
+ * leaking through baseline), after longer one breath history is restarted
+ * & no rate is reported, until there are RESP_MIN_BREATHS again
+ */
+#define RESP_MIN_INTERVAL (RESP_SAMPLE_RATE_HZ * 3 / 2) // 40/min
+#define RESP_MAX_INTERVAL (RESP_SAMPLE_RATE_HZ * 15)    // 4/min
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Respiratory rate context
+ */
+typedef struct {
+  /** Input sample rate (Hz) & input samples per decimated sample */
+  uint32_t sample_rate;
+  uint32_t decimation;
+
+  /** Decimation phase & accumulator */
+  uint32_t phase;
+  int32_t  acc;
+
+  /** Decimated baseline history, for detrending */
+  int32_t  window[RESP_WINDOW];
+  uint32_t index;
+  uint32_t count;
+  int32_t  sum;
+
+  /** Detrended signal amplitude */
+  int32_t amp;
+
+  /** Detrended signal is above upper hysteresis threshold */
+  bool above;
+
+  /** Decimated sample counter */
+  uint32_t tick;
+
+  /** Ticks of last breaths */
+  uint32_t breaths[RESP_BREATHS];
+  uint32_t breath_index;
+  uint32_t breath_count;
+} resp_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize (reset) respiratory rate context
+ *
+ * @param resp Respiratory rate context
+ * @param sample_rate Rate of baseline samples (Hz), at least RESP_SAMPLE_RATE_HZ
+ */
+error_t resp_init(resp_t * resp, uint32_t sample_rate);
+
+/**
+ * Process decimated baseline sample
+ *
+ * @note Called by resp_add_sample
+ *
+ * @param resp Respiratory rate context
+ * @param value Decimated baseline sample (sum over decimation)
+ */
+void resp_update(resp_t * resp, int32_t value);
+
+/**
+ * Get respiratory rate
+ *
+ * @param resp Respiratory rate context
+ * @param rate Where to put rate (breaths/min)
+ * @return E_OK on success, E_AGAIN - if there are not enough breaths yet (or
+ *         there was no breath for RESP_MAX_INTERVAL)
+ */
+error_t resp_get_rate(resp_t * resp, uint32_t * rate);
+
+/**
+ * Add baseline sample. Called for each input sample, so it only accumulates
+ *
+ * @param resp Respiratory rate context
+ * @param value Baseline sample
+ */
+__STATIC_INLINE void resp_add_sample(resp_t * resp, int32_t value) {
+  resp->acc += value;
+
+  if (++resp->phase == resp->decimation) {
+    resp_update(resp, resp->acc);
+
+    resp->acc   = 0;
+    resp->phase = 0;
+  }
+}
+
+#ifdef __cplusplus
+}
+#endif
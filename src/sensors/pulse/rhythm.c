@@ -0,0 +1,126 @@
+/** ========================================================================= *
+ *
+ * @file rhythm.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/pulse/rhythm.h"
+#include "error/assertion.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+/** Mask for wrapping window index */
+#define RHYTHM_INDEX_MASK (RHYTHM_WINDOW - 1)
+
+#if RHYTHM_WINDOW & RHYTHM_INDEX_MASK
+#error "RHYTHM_WINDOW must be a power of 2"
+#endif
+
+#if RHYTHM_WINDOW > 32
+#error "RHYTHM_WINDOW can't exceed 32"
+#endif
+
+/** Turning point is known for every interval in window, except first & last */
+#define RHYTHM_TURNS (RHYTHM_WINDOW - 2)
+#define RHYTHM_TURNS_MASK ((1UL << RHYTHM_TURNS) - 1)
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+__STATIC_INLINE uint32_t rhythm_absdiff(uint32_t a, uint32_t b) {
+  return a > b ? a - b : b - a;
+}
+
+/**
+ * Update score & state, once window is full. Divisions are by constants or
+ * once per beat, so they are fine here
+ */
+static void rhythm_update(rhythm_t * rhythm) {
+  // Mean absolute successive difference (WINDOW-1 differences) relative to mean interval
+  rhythm->score = (rhythm->diff_sum * RHYTHM_WINDOW * 100) / ((RHYTHM_WINDOW - 1) * rhythm->sum);
+  rhythm->tpr   = __builtin_popcount(rhythm->turns & RHYTHM_TURNS_MASK) * 100 / RHYTHM_TURNS;
+
+  if (!rhythm->irregular) {
+    rhythm->irregular =
+      rhythm->score >= RHYTHM_IRREGULAR_THRESHOLD &&
+      rhythm->tpr   >= RHYTHM_TPR_MIN &&
+      rhythm->tpr   <= RHYTHM_TPR_MAX;
+  } else if (rhythm->score < RHYTHM_REGULAR_THRESHOLD) {
+    rhythm->irregular = false;
+  }
+}
+
+/* Shared functions ========================================================= */
+error_t rhythm_init(rhythm_t * rhythm) {
+  ASSERT_RETURN(rhythm, E_NULL);
+
+  memset(rhythm, 0, sizeof(rhythm_t));
+
+  return E_OK;
+}
+
+error_t rhythm_add_interval(rhythm_t * rhythm, uint32_t interval) {
+  ASSERT_RETURN(rhythm, E_NULL);
+  ASSERT_RETURN(interval, E_INVAL);
+
+  uint32_t index = rhythm->index;
+
+  if (rhythm->count == RHYTHM_WINDOW) {
+    // Oldest interval & its difference with the next one leave the window
+    uint32_t oldest = rhythm->intervals[index];
+    uint32_t next   = rhythm->intervals[(index + 1) & RHYTHM_INDEX_MASK];
+
+    rhythm->sum      -= oldest;
+    rhythm->diff_sum -= rhythm_absdiff(next, oldest);
+  } else {
+    rhythm->count++;
+  }
+
+  if (rhythm->count > 1) {
+    uint32_t prev = rhythm->intervals[(index - 1) & RHYTHM_INDEX_MASK];
+
+    rhythm->diff_sum += rhythm_absdiff(interval, prev);
+
+    // Previous interval is a turning point, if it's a local min or max
+    if (rhythm->count > 2) {
+      uint32_t before = rhythm->intervals[(index - 2) & RHYTHM_INDEX_MASK];
+      bool     turn   = (prev > before && prev > interval) || (prev < before && prev < interval);
+
+      rhythm->turns = (rhythm->turns << 1) | turn;
+    }
+  }
+
+  rhythm->intervals[index] = interval;
+  rhythm->sum  += interval;
+  rhythm->index = (index + 1) & RHYTHM_INDEX_MASK;
+
+  if (rhythm->count == RHYTHM_WINDOW) {
+    rhythm_update(rhythm);
+  }
+
+  return E_OK;
+}
+
+error_t rhythm_get_score(rhythm_t * rhythm, uint32_t * score) {
+  ASSERT_RETURN(rhythm && score, E_NULL);
+
+  if (rhythm->count < RHYTHM_WINDOW) {
+    return E_AGAIN;
+  }
+
+  *score = rhythm->score;
+
+  return E_OK;
+}
+
+bool rhythm_is_irregular(rhythm_t * rhythm) {
+  ASSERT_RETURN(rhythm, false);
+
+  return rhythm->irregular;
+}
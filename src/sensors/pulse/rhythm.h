@@ -0,0 +1,119 @@
+/** ========================================================================= *
+ *
+ * @file rhythm.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Irregular rhythm detector. Scores beat (RR) intervals over a sliding
+ *        window with normalized mean absolute successive difference, gated by
+ *        turning point ratio (irregular rhythm is both large & random). Both
+ *        are updated with running sums, so each beat costs the same
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "error/error.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * Number of intervals in window
+ *
+ * @note Must be a power of 2 (index is wrapped with a mask) & not above 32
+ *       (turning points are kept as a bit mask)
+ */
+#define RHYTHM_WINDOW 32
+
+/**
+ * Score (mean absolute successive difference, % of mean interval), above
+ * which rhythm is irregular. Regular (sinus) rhythm stays below ~5%
+ */
+#ifndef RHYTHM_IRREGULAR_THRESHOLD
+#define RHYTHM_IRREGULAR_THRESHOLD 10
+#endif
+
+/**
+ * Score, below which rhythm is regular again (hysteresis)
+ */
+#define RHYTHM_REGULAR_THRESHOLD (RHYTHM_IRREGULAR_THRESHOLD * 3 / 4)
+
+/**
+ * Turning point ratio (%) band of a random sequence (expected 66%), slow
+ * trends (like respiratory arrhythmia) have it lower
+ */
+#define RHYTHM_TPR_MIN 50
+#define RHYTHM_TPR_MAX 85
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Irregular rhythm detector context
+ */
+typedef struct {
+  /** Intervals in window (ms) */
+  uint16_t intervals[RHYTHM_WINDOW];
+  uint32_t index;
+
+  /** Number of intervals in window */
+  uint32_t count;
+
+  /** Running sum of intervals in window */
+  uint32_t sum;
+
+  /** Running sum of absolute successive differences in window */
+  uint32_t diff_sum;
+
+  /** Turning points in window (bit per interval, newest is bit 0) */
+  uint32_t turns;
+
+  /** Last calculated score & turning point ratio (%) */
+  uint32_t score;
+  uint32_t tpr;
+
+  /** Rhythm is irregular */
+  bool irregular;
+} rhythm_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize (reset) irregular rhythm detector
+ *
+ * @param rhythm Irregular rhythm detector context
+ */
+error_t rhythm_init(rhythm_t * rhythm);
+
+/**
+ * Add beat interval
+ *
+ * @param rhythm Irregular rhythm detector context
+ * @param interval Beat interval (ms)
+ */
+error_t rhythm_add_interval(rhythm_t * rhythm, uint32_t interval);
+
+/**
+ * Get irregularity score
+ *
+ * @param rhythm Irregular rhythm detector context
+ * @param score Where to put score (mean absolute successive difference, % of mean interval)
+ * @return E_OK on success, E_AGAIN - if window isn't full yet
+ */
+error_t rhythm_get_score(rhythm_t * rhythm, uint32_t * score);
+
+/**
+ * Check if rhythm is irregular
+ *
+ * @param rhythm Irregular rhythm detector context
+ */
+bool rhythm_is_irregular(rhythm_t * rhythm);
+
+#ifdef __cplusplus
+}
+#endif
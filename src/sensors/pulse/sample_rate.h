@@ -0,0 +1,78 @@
+/** ========================================================================= *
+ *
+ * @file sample_rate.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Pulse sensor sample rate. Filter windows & EMA time constants are
+ *        given in ms and converted to samples (or shifts) with helpers below,
+ *        so they stay the same at any rate. Peak engine Gauss kernel & its
+ *        threshold window are selected by rate (see pulse.h)
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+/* Defines ================================================================== */
+/**
+ * Rate of samples, that are processed (Hz). Samples are timestamped by their
+ * position in the sample stream, so it must match output rate of MAX3010x
+ * (sample rate divided by averaging)
+ */
+#ifndef PULSE_SAMPLE_RATE_HZ
+#define PULSE_SAMPLE_RATE_HZ 100
+#endif
+
+#if 1000 % PULSE_SAMPLE_RATE_HZ
+#error "PULSE_SAMPLE_RATE_HZ must be a divisor of 1000"
+#endif
+
+/**
+ * Time between two consecutive samples (ms)
+ */
+#define PULSE_SAMPLE_PERIOD_MS (1000 / PULSE_SAMPLE_RATE_HZ)
+
+/* Macros =================================================================== */
+/**
+ * Number of samples in a time interval
+ *
+ * @param __ms Time interval (ms)
+ */
+#define PULSE_MS_TO_SAMPLES(__ms) ((__ms) / PULSE_SAMPLE_PERIOD_MS)
+
+/**
+ * Integer log2 (rounded down) of a constant expression, up to 2^10. Usable
+ * in preprocessor conditions
+ */
+#define PULSE_LOG2(__x)  \
+  ((__x) >= 1024 ? 10 :  \
+   (__x) >= 512  ? 9  :  \
+   (__x) >= 256  ? 8  :  \
+   (__x) >= 128  ? 7  :  \
+   (__x) >= 64   ? 6  :  \
+   (__x) >= 32   ? 5  :  \
+   (__x) >= 16   ? 4  :  \
+   (__x) >= 8    ? 3  :  \
+   (__x) >= 4    ? 2  :  \
+   (__x) >= 2    ? 1  : 0)
+
+/**
+ * EMA shift (alpha = 1/2^SHIFT), with time constant closest to (not above)
+ * a time interval
+ *
+ * @param __ms Time constant (ms)
+ */
+#define PULSE_MS_TO_SHIFT(__ms) PULSE_LOG2(PULSE_MS_TO_SAMPLES(__ms))
+
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+
+#ifdef __cplusplus
+}
+#endif
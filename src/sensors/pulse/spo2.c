@@ -0,0 +1,146 @@
+/** ========================================================================= *
+ *
+ * @file spo2.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/pulse/spo2.h"
+#include "error/assertion.h"
+#include <stdbool.h>
+#include <string.h>
+
+/* Defines ================================================================== */
+/** Number of samples in a single measurement window */
+#define SPO2_WINDOW_SIZE (1 << SPO2_WINDOW_SHIFT)
+
+/** Max reported value (Q8) */
+#define SPO2_MAX_VALUE (100 << 8)
+
+/** R (Q8), at which calibrated value reaches 0 */
+#define SPO2_MAX_R ((SPO2_CALIBRATION_A << 8) / SPO2_CALIBRATION_B)
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+__STATIC_INLINE void spo2_channel_process(spo2_channel_t * ch, int32_t value) {
+  // Seed baseline with first sample, so it doesn't have to settle from 0
+  if (!ch->dc) {
+    ch->dc = value << 8;
+  }
+
+  int32_t ac = (value << 8) - ch->dc;
+  ch->dc += ac >> SPO2_DC_SHIFT;
+
+  ch->dc_sum += value;
+  ch->ac_sum += (ac < 0 ? -ac : ac) >> 8;
+}
+
+__STATIC_INLINE void spo2_window_clear(spo2_t * spo2) {
+  spo2->count = 0;
+  spo2->red.dc_sum = 0;
+  spo2->red.ac_sum = 0;
+  spo2->ir.dc_sum  = 0;
+  spo2->ir.ac_sum  = 0;
+}
+
+/**
+ * Calculate SpO2 from completed window
+ *
+ * @return true if value was updated
+ */
+static bool spo2_window_complete(spo2_t * spo2) {
+  // AC sums are taken over same window, so there is no need to average them
+  uint32_t ac_red = spo2->red.ac_sum;
+  uint32_t ac_ir  = spo2->ir.ac_sum;
+  uint32_t dc_red = spo2->red.dc_sum >> SPO2_WINDOW_SHIFT;
+  uint32_t dc_ir  = spo2->ir.dc_sum >> SPO2_WINDOW_SHIFT;
+
+  if (!ac_ir || !dc_red) {
+    return false;
+  }
+
+  // R = (AC_red / DC_red) / (AC_ir / DC_ir), in Q8
+  uint64_t num = ((uint64_t) ac_red * dc_ir) << 8;
+  uint64_t den = (uint64_t) ac_ir * dc_red;
+  uint64_t r   = num / den;
+
+  // R is clamped before multiplication (value is 0 above it anyway), so it can't overflow
+  r = r < SPO2_MAX_R ? r : SPO2_MAX_R;
+
+  int32_t value = (SPO2_CALIBRATION_A << 8) - SPO2_CALIBRATION_B * (int32_t) r;
+  value = value < SPO2_MAX_VALUE ? value : SPO2_MAX_VALUE;
+
+  if (spo2->value) {
+    spo2->value += (value - spo2->value) >> SPO2_SMOOTH_SHIFT;
+  } else {
+    spo2->value = value;
+  }
+
+  return true;
+}
+
+/* Shared functions ========================================================= */
+error_t spo2_init(spo2_t * spo2, uint32_t raw_threshold) {
+  ASSERT_RETURN(spo2, E_NULL);
+
+  memset(spo2, 0, sizeof(spo2_t));
+
+  spo2->raw_threshold = raw_threshold;
+
+  return E_OK;
+}
+
+error_t spo2_process_block(spo2_t * spo2, const max3010x_sample_t * samples, size_t size) {
+  ASSERT_RETURN(spo2 && samples, E_NULL);
+
+  bool updated = false;
+
+  for (size_t i = 0; i < size; ++i) {
+    // No contact - start over, when finger is back
+    if (samples[i].ir < spo2->raw_threshold) {
+      spo2_window_clear(spo2);
+      spo2->red.dc = 0;
+      spo2->ir.dc  = 0;
+      spo2->value  = 0;
+      continue;
+    }
+
+    spo2_channel_process(&spo2->red, (int32_t) samples[i].red);
+    spo2_channel_process(&spo2->ir, (int32_t) samples[i].ir);
+
+    if (++spo2->count == SPO2_WINDOW_SIZE) {
+      updated |= spo2_window_complete(spo2);
+      spo2_window_clear(spo2);
+    }
+  }
+
+  return updated ? E_OK : E_AGAIN;
+}
+
+error_t spo2_window_reset(spo2_t * spo2) {
+  ASSERT_RETURN(spo2, E_NULL);
+
+  spo2_window_clear(spo2);
+  spo2->red.dc = 0;
+  spo2->ir.dc  = 0;
+
+  return E_OK;
+}
+
+error_t spo2_get(spo2_t * spo2, uint8_t * value) {
+  ASSERT_RETURN(spo2 && value, E_NULL);
+
+  if (!spo2->value) {
+    return E_AGAIN;
+  }
+
+  *value = (spo2->value + (1 << 7)) >> 8;
+
+  return E_OK;
+}
@@ -0,0 +1,126 @@
+/** ========================================================================= *
+ *
+ * @file spo2.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief SpO2 (Blood Oxygen Saturation) Estimator. Calculates ratio of
+ *        ratios of red & IR channels, using integer math only
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "max3010x/max3010x.h"
+#include "error/error.h"
+#include "sensors/pulse/sample_rate.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * Number of samples in a single measurement window (2^SHIFT)
+ * ~2.5s (256 samples @ 100Hz), which covers at least 2 heartbeats
+ */
+#define SPO2_WINDOW_SHIFT PULSE_MS_TO_SHIFT(2560)
+
+/**
+ * DC baseline smoothing (EMA, alpha = 1/2^SHIFT)
+ * Time constant must be well above heartbeat period (~1.3s)
+ */
+#define SPO2_DC_SHIFT PULSE_MS_TO_SHIFT(1280)
+
+/**
+ * Reported value smoothing across windows (EMA, alpha = 1/2^SHIFT)
+ */
+#define SPO2_SMOOTH_SHIFT 2
+
+/**
+ * Empirical calibration: SpO2 = A - B * R
+ */
+#define SPO2_CALIBRATION_A 110
+#define SPO2_CALIBRATION_B 25
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Single channel (red or IR) context
+ */
+typedef struct {
+  /** DC baseline (Q8) */
+  int32_t dc;
+
+  /** Sum of raw samples in window */
+  uint32_t dc_sum;
+
+  /** Sum of absolute AC component in window */
+  uint32_t ac_sum;
+} spo2_channel_t;
+
+/**
+ * SpO2 estimator context
+ */
+typedef struct {
+  /** Threshold that raw IR value has to surpass (no contact otherwise) */
+  uint32_t raw_threshold;
+
+  /** Number of samples in current window */
+  uint32_t count;
+
+  /** Channels */
+  spo2_channel_t red;
+  spo2_channel_t ir;
+
+  /** Last calculated value (%, Q8), 0 if no value yet */
+  int32_t value;
+} spo2_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initialize SpO2 estimator
+ *
+ * @param spo2 SpO2 estimator context
+ * @param raw_threshold Threshold that raw IR value has to surpass
+ */
+error_t spo2_init(spo2_t * spo2, uint32_t raw_threshold);
+
+/**
+ * Process a block of samples (whole MAX3010x FIFO batch)
+ *
+ * @note Per sample cost is 2 x (subtract, shift, 2 adds, abs), ~40 cycles on
+ *       Cortex-M0+. Single 64 bit division is done once per window
+ *
+ * @param spo2 SpO2 estimator context
+ * @param samples MAX3010x samples (both red & IR channels are used)
+ * @param size Number of samples
+ * @return E_OK if at least one window was completed, E_AGAIN if not
+ */
+error_t spo2_process_block(spo2_t * spo2, const max3010x_sample_t * samples, size_t size);
+
+/**
+ * Drop current window & DC baselines (e.g. after LED current or ADC range
+ * change), so samples taken at old & new settings aren't mixed. Last value is
+ * kept & next window is smoothed into it
+ *
+ * @param spo2 SpO2 estimator context
+ */
+error_t spo2_window_reset(spo2_t * spo2);
+
+/**
+ * Get last calculated SpO2 value
+ *
+ * @param spo2 SpO2 estimator context
+ * @param value Where to put SpO2 (%)
+ * @return E_OK on success, E_AGAIN - if no window was completed yet
+ */
+error_t spo2_get(spo2_t * spo2, uint8_t * value);
+
+#ifdef __cplusplus
+}
+#endif
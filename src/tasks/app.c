@@ -46,8 +46,11 @@ void app_task_fn(__UNUSED void * ctx) {
 
       if (timeout_is_expired(&device.app.status_send_timeout)) {
         app_send_status(&device.app);
-        timeout_start(&device.app.status_send_timeout, NET_STATUS_SEND_PERIOD);
+        timeout_start(&device.app.status_send_timeout, app_get_status_period(&device.app));
       }
+
+      // Capture upload is the lowest priority, so it goes last
+      app_capture_process(&device.app);
     }
 
     os_yield();
@@ -0,0 +1,40 @@
+/** ========================================================================= *
+ *
+ * @file isqrt.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "util/isqrt.h"
+
+/* Defines ================================================================== */
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+/* Shared functions ========================================================= */
+uint32_t isqrt(uint32_t value) {
+  uint32_t res = 0;
+  uint32_t bit = 1UL << 30;
+
+  while (bit > value) {
+    bit >>= 2;
+  }
+
+  while (bit) {
+    if (value >= res + bit) {
+      value -= res + bit;
+      res = (res >> 1) + bit;
+    } else {
+      res >>= 1;
+    }
+
+    bit >>= 2;
+  }
+
+  return res;
+}
@@ -0,0 +1,36 @@
+/** ========================================================================= *
+ *
+ * @file isqrt.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Integer square root, shared by detectors (no FPU, no HW divider)
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Integer square root (rounded down), bit by bit - no multiplication. It's a
+ * loop of up to 16 iterations, so it's kept off full rate sample paths
+ *
+ * @param value Value
+ * @return floor(sqrt(value))
+ */
+uint32_t isqrt(uint32_t value);
+
+#ifdef __cplusplus
+}
+#endif
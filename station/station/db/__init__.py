@@ -2,6 +2,7 @@ from station.utils import logger
 from station.config import CONFIG_DB_FILE_PATH
 from werkzeug.security import generate_password_hash
 from peewee import *
+from playhouse.migrate import SqliteMigrator, migrate
 import datetime
 
 
@@ -33,6 +34,14 @@ class Status(BaseModel):
     flags   = IntegerField()
     bpm     = IntegerField()
     avg_bpm = IntegerField()
+    spo2    = IntegerField(default=0)
+    rmssd   = IntegerField(default=0)
+    sdnn    = IntegerField(default=0)
+    pnn50   = IntegerField(default=0)
+
+    resp_rate = IntegerField(default=0)
+    activity  = IntegerField(default=0)
+    posture   = IntegerField(default=0)
 
 
 class Location(BaseModel):
@@ -50,11 +59,44 @@ class Alert(BaseModel):
     timestamp = DateTimeField(default=datetime.datetime.now)
 
     trigger = IntegerField()
+    value   = IntegerField(default=0)
+
+
+class Capture(BaseModel):
+    # Single block of a black box capture, blocks of a capture share 'capture' id
+    device    = ForeignKeyField(Device, backref='captures')
+    timestamp = DateTimeField(default=datetime.datetime.now)
+
+    capture       = IntegerField()
+    trigger       = IntegerField()
+    channel       = IntegerField()
+    rate          = IntegerField()
+    index         = IntegerField()
+    count         = IntegerField()
+    trigger_frame = IntegerField()
+    base          = IntegerField()
+    shift         = IntegerField()
+    deltas        = BlobField()
+
+
+def migrate_columns(models: list):
+    # Add columns, that were introduced after the database was created
+    migrator = SqliteMigrator(conn)
+
+    for model in models:
+        table = model._meta.table_name
+        columns = [column.name for column in conn.get_columns(table)]
+
+        for field in model._meta.sorted_fields:
+            if field.column_name not in columns:
+                logger.info(f"Adding column '{field.column_name}' to '{table}'")
+                migrate(migrator.add_column(table, field.column_name, field))
 
 
 def init():
     conn.connect()
-    conn.create_tables([User, Device, Status, Location, Alert])
+    conn.create_tables([User, Device, Status, Location, Alert, Capture])
+    migrate_columns([Status, Alert])
 
     # Unconditionally create 'admin' user
     if not User.select().where(User.username == 'admin').exists():
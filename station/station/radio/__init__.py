@@ -3,7 +3,10 @@ from .types import (
     TransportType,
     ResetReason,
     StatusFlags,
-    AlertTrigger
+    AlertTrigger,
+    Activity,
+    Posture,
+    CaptureChannel
 )
 
 from .header import Header
@@ -17,7 +20,8 @@ from .payload import (
     RegistrationDataPayload,
     StatusPayload,
     LocationPayload,
-    AlertPayload
+    AlertPayload,
+    CapturePayload
 )
 
 from .net import Network
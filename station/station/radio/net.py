@@ -167,6 +167,13 @@ class Network:
                 flags=packet.payload.flags,
                 bpm=packet.payload.bpm,
                 avg_bpm=packet.payload.avg_bpm,
+                spo2=packet.payload.spo2,
+                rmssd=packet.payload.rmssd,
+                sdnn=packet.payload.sdnn,
+                pnn50=packet.payload.pnn50,
+                resp_rate=packet.payload.resp_rate,
+                activity=packet.payload.activity,
+                posture=packet.payload.posture,
                 device=dev
             ).save()
 
@@ -212,6 +219,7 @@ class Network:
             dev = db.Device.get_by_id(packet.header.origin)
             db.Alert.create(
                 trigger=packet.payload.trigger.value,
+                value=packet.payload.value,
                 device=dev
             ).save()
 
@@ -222,6 +230,45 @@ class Network:
             logger.error(f'Failed to save ALERT data from 0x{packet.header.origin:X}: {e}')
 
 
+    def __handle_capture(self, packet: Packet):
+        # Check packet's target to correspond to station's node MAC
+        if packet.header.target != config.CONFIG_STATION_MAC:
+            logger.warning(f'CAPTURE addressed to another node (0x{packet.header.target:X}), ignoring...')
+            return
+
+        try:
+            dev     = db.Device.get_by_id(packet.header.origin)
+            payload = packet.payload
+
+            # Block may be retransmitted (lost CONFIRM), so it replaces the previous copy
+            db.Capture.delete().where(
+                (db.Capture.device  == dev)                   &
+                (db.Capture.capture == payload.id)            &
+                (db.Capture.channel == payload.channel.value) &
+                (db.Capture.index   == payload.index)
+            ).execute()
+
+            db.Capture.create(
+                capture=payload.id,
+                trigger=payload.trigger.value,
+                channel=payload.channel.value,
+                rate=payload.rate,
+                index=payload.index,
+                count=payload.count,
+                trigger_frame=payload.trigger_frame,
+                base=payload.base,
+                shift=payload.shift,
+                deltas=bytes(d & 0xFF for d in payload.deltas),
+                device=dev
+            ).save()
+
+            self.__send_confirm(packet.header.origin, packet.key)
+
+            logger.info(f'Received CAPTURE from 0x{packet.header.origin:X}: {payload}')
+        except Exception as e:
+            logger.error(f'Failed to save CAPTURE data from 0x{packet.header.origin:X}: {e}')
+
+
     def __handle_packet(self, packet: Packet):
         match packet.header.command:
             case Command.PING:
@@ -234,6 +281,8 @@ class Network:
                 self.__handle_location(packet)
             case Command.ALERT:
                 self.__handle_alert(packet)
+            case Command.CAPTURE:
+                self.__handle_capture(packet)
             case _:
                 logger.warning(f'Unexpected command: {packet.header.command.name} ({packet.header.command.value}) from 0x{packet.header.origin:X}')
                 # TODO: Send reject?
@@ -4,6 +4,7 @@ from station.radio.types import (
     Command,
     ResetReason,
     AlertTrigger,
+    CaptureChannel,
 )
 
 from abc import ABC, abstractmethod
@@ -145,7 +146,23 @@ class RegistrationDataPayload(Payload):
 class StatusPayload(Payload):
     FORMAT = '>BBBbBB'
 
-    def __init__(self, flags: int, reset_reason: ResetReason | int, reset_count: int, cpu_temp: int, bpm: int, avg_bpm: int):
+    # Fields appended to the payload by newer firmware (name, format)
+    # Older devices send shorter payload, missing fields keep their defaults.
+    # Fields unknown to this station are ignored. Stations before EXT_FIELDS
+    # unpack fixed size & reject longer payload, so update station first
+    EXT_FIELDS = (
+        ('spo2', 'B'),
+        ('rmssd', 'B'),
+        ('sdnn', 'B'),
+        ('pnn50', 'B'),
+        ('resp_rate', 'B'),
+        ('activity', 'B'),
+        ('posture', 'B'),
+    )
+
+    def __init__(self, flags: int, reset_reason: ResetReason | int, reset_count: int, cpu_temp: int, bpm: int, avg_bpm: int,
+                 spo2: int = 0, rmssd: int = 0, sdnn: int = 0, pnn50: int = 0,
+                 resp_rate: int = 0, activity: int = 0, posture: int = 0):
         assert_raise(validate_enum(ResetReason, reset_reason), ValueError(f'Invalid reset reason {reset_reason}'))
 
         self.flags        = flags
@@ -154,9 +171,16 @@ class StatusPayload(Payload):
         self.cpu_temp     = cpu_temp
         self.bpm          = bpm
         self.avg_bpm      = avg_bpm
+        self.spo2         = spo2
+        self.rmssd        = rmssd
+        self.sdnn         = sdnn
+        self.pnn50        = pnn50
+        self.resp_rate    = resp_rate
+        self.activity     = activity
+        self.posture      = posture
 
     def __str__(self):
-        return f'flags={self.flags} reset=({self.reset_reason.name} {self.reset_count}) cpu={self.cpu_temp} bpm=({self.bpm} {self.avg_bpm})'
+        return f'flags={self.flags} reset=({self.reset_reason.name} {self.reset_count}) cpu={self.cpu_temp} bpm=({self.bpm} {self.avg_bpm}) spo2={self.spo2} hrv=({self.rmssd} {self.sdnn} {self.pnn50}) resp={self.resp_rate} act={self.activity} posture={self.posture}'
 
     def __eq__(self, other):
         return (
@@ -166,18 +190,43 @@ class StatusPayload(Payload):
             self.reset_count  == other.reset_count  and
             self.cpu_temp     == other.cpu_temp     and
             self.bpm          == other.bpm          and
-            self.avg_bpm      == other.avg_bpm
+            self.avg_bpm      == other.avg_bpm      and
+            self.spo2         == other.spo2         and
+            self.rmssd        == other.rmssd        and
+            self.sdnn         == other.sdnn         and
+            self.pnn50        == other.pnn50        and
+            self.resp_rate    == other.resp_rate    and
+            self.activity     == other.activity     and
+            self.posture      == other.posture
         )
 
+    @classmethod
+    def get_full_format(cls) -> str:
+        return cls.FORMAT + ''.join(fmt for _, fmt in cls.EXT_FIELDS)
+
     def get_size(self) -> int:
-        return struct.calcsize(self.FORMAT)
+        return struct.calcsize(self.get_full_format())
 
     def to_bytes(self) -> bytes:
-        return struct.pack(self.FORMAT, self.flags, self.reset_reason.value, self.reset_count, self.cpu_temp, self.bpm, self.avg_bpm)
+        return struct.pack(
+            self.get_full_format(),
+            self.flags, self.reset_reason.value, self.reset_count, self.cpu_temp, self.bpm, self.avg_bpm,
+            *[getattr(self, name) for name, _ in self.EXT_FIELDS]
+        )
 
     @classmethod
     def from_bytes(cls, data: bytes):
-        return cls(*struct.unpack(cls.FORMAT, data))
+        offset = struct.calcsize(cls.FORMAT)
+        fields = {}
+
+        for name, fmt in cls.EXT_FIELDS:
+            size = struct.calcsize('>' + fmt)
+            if len(data) < offset + size:
+                break
+            fields[name], = struct.unpack('>' + fmt, data[offset:offset + size])
+            offset += size
+
+        return cls(*struct.unpack(cls.FORMAT, data[:struct.calcsize(cls.FORMAT)]), **fields)
 
 
 class LocationPayload(Payload):
@@ -229,29 +278,111 @@ class LocationPayload(Payload):
 class AlertPayload(Payload):
     FORMAT = '>B'
 
-    def __init__(self, trigger: AlertTrigger | int):
+    # Trigger specific value (FALL: peak impact, 0.1g), appended by newer firmware
+    VALUE_FORMAT = '>B'
+
+    def __init__(self, trigger: AlertTrigger | int, value: int = 0):
         assert_raise(validate_enum(AlertTrigger, trigger), ValueError(f'Invalid alert trigger {trigger}'))
 
         self.trigger = trigger if type(trigger) is AlertTrigger else AlertTrigger(trigger)
+        self.value   = value
 
     def __str__(self):
-        return f'trigger={self.trigger.name}'
+        return f'trigger={self.trigger.name} value={self.value}'
 
     def __eq__(self, other):
         return (
-            type(other) is AlertPayload and
-            self.trigger.value == other.trigger.value
+            type(other) is AlertPayload               and
+            self.trigger.value == other.trigger.value and
+            self.value         == other.value
         )
 
     def get_size(self) -> int:
-        return struct.calcsize(self.FORMAT)
+        return struct.calcsize(self.FORMAT) + struct.calcsize(self.VALUE_FORMAT)
 
     def to_bytes(self) -> bytes:
-        return struct.pack(self.FORMAT, self.trigger.value)
+        return struct.pack(self.FORMAT, self.trigger.value) + struct.pack(self.VALUE_FORMAT, self.value)
 
     @classmethod
     def from_bytes(cls, data: bytes):
-        return cls(*struct.unpack(cls.FORMAT, data))
+        sz = struct.calcsize(cls.FORMAT)
+        value = 0
+
+        # Older devices send trigger only
+        if len(data) >= sz + struct.calcsize(cls.VALUE_FORMAT):
+            value, = struct.unpack(cls.VALUE_FORMAT, data[sz:sz + struct.calcsize(cls.VALUE_FORMAT)])
+
+        return cls(*struct.unpack(cls.FORMAT, data[:sz]), value=value)
+
+
+class CapturePayload(Payload):
+    # id, trigger, channel, rate, index, count, trigger frame, base, shift
+    FORMAT = '>BBBBBBHhB'
+    DELTAS = 31
+
+    def __init__(self, id: int, trigger: AlertTrigger | int, channel: CaptureChannel | int, rate: int, index: int,
+                 count: int, trigger_frame: int, base: int, shift: int, deltas: list[int]):
+        assert_raise(validate_enum(AlertTrigger, trigger), ValueError(f'Invalid alert trigger {trigger}'))
+        assert_raise(validate_enum(CaptureChannel, channel), ValueError(f'Invalid capture channel {channel}'))
+        assert_raise(len(deltas) == self.DELTAS, ValueError(f'Invalid number of deltas {len(deltas)}'))
+
+        self.id            = id
+        self.trigger       = trigger if type(trigger) is AlertTrigger else AlertTrigger(trigger)
+        self.channel       = channel if type(channel) is CaptureChannel else CaptureChannel(channel)
+        self.rate          = rate
+        self.index         = index
+        self.count         = count
+        self.trigger_frame = trigger_frame
+        self.base          = base
+        self.shift         = shift
+        self.deltas        = list(deltas)
+
+    def __str__(self):
+        return f'id={self.id} trigger={self.trigger.name} channel={self.channel.name} block={self.index}/{self.count}'
+
+    def __eq__(self, other):
+        return (
+            type(other) is CapturePayload               and
+            self.id            == other.id              and
+            self.trigger       == other.trigger         and
+            self.channel       == other.channel         and
+            self.rate          == other.rate            and
+            self.index         == other.index           and
+            self.count         == other.count           and
+            self.trigger_frame == other.trigger_frame   and
+            self.base          == other.base            and
+            self.shift         == other.shift           and
+            self.deltas        == other.deltas
+        )
+
+    @staticmethod
+    def decode(base: int, shift: int, deltas: list[int]) -> list[int]:
+        # Frame i is base + sum(delta[0..i-1] << shift)
+        frames = [base]
+        for delta in deltas:
+            frames.append(frames[-1] + (delta << shift))
+        return frames
+
+    def get_frames(self) -> list[int]:
+        return self.decode(self.base, self.shift, self.deltas)
+
+    def get_size(self) -> int:
+        return struct.calcsize(self.FORMAT) + self.DELTAS
+
+    def to_bytes(self) -> bytes:
+        return struct.pack(
+            self.FORMAT,
+            self.id, self.trigger.value, self.channel.value, self.rate, self.index, self.count,
+            self.trigger_frame, self.base, self.shift
+        ) + struct.pack(f'>{self.DELTAS}b', *self.deltas)
+
+    @classmethod
+    def from_bytes(cls, data: bytes):
+        sz = struct.calcsize(cls.FORMAT)
+        return cls(
+            *struct.unpack(cls.FORMAT, data[:sz]),
+            list(struct.unpack(f'>{cls.DELTAS}b', data[sz:sz + cls.DELTAS]))
+        )
 
 
 # Register payload classes for serialization/deserialization to each command
@@ -263,3 +394,4 @@ Payload.register_handler(Command.REGISTRATION_DATA, RegistrationDataPayload)
 Payload.register_handler(Command.STATUS,            StatusPayload)
 Payload.register_handler(Command.LOCATION,          LocationPayload)
 Payload.register_handler(Command.ALERT,             AlertPayload)
+Payload.register_handler(Command.CAPTURE,           CapturePayload)
@@ -14,6 +14,7 @@ class Command(Enum):
     STATUS            = 5
     LOCATION          = 6
     ALERT             = 7
+    CAPTURE           = 8
 
 
 class TransportType(Enum):
@@ -25,6 +26,30 @@ class TransportType(Enum):
 class AlertTrigger(Enum):
     PULSE_THRESHOLD = 1
     SUDDEN_MOVEMENT = 2
+    IRREGULAR_RHYTHM = 3
+    FALL = 4
+    PRONE_STILL = 5
+
+
+class Activity(Enum):
+    UNKNOWN = 0
+    REST    = 1
+    WALK    = 2
+    RUN     = 3
+    VEHICLE = 4
+
+
+class Posture(Enum):
+    UNKNOWN = 0
+    UPRIGHT = 1
+    PRONE   = 2
+    SUPINE  = 3
+    SIDE    = 4
+
+
+class CaptureChannel(Enum):
+    ACCEL = 0
+    PPG   = 1
 
 
 class ResetReason(Enum):
@@ -41,4 +66,6 @@ class StatusFlags:
     PULSE_SENSOR_FAILURE = (1 << 0)
     ACCEL_SENSOR_FAILURE = (1 << 1)
     GPS_FAILURE          = (1 << 2)
+    PULSE_NO_CONTACT     = (1 << 3)
+    PULSE_LOW_SIGNAL     = (1 << 4)
 
@@ -1,6 +1,6 @@
 from flask import Flask, render_template, send_from_directory, request, redirect, url_for, session, flash, jsonify, g
 from werkzeug.security import generate_password_hash, check_password_hash
-from station.radio import StatusFlags, AlertTrigger
+from station.radio import StatusFlags, AlertTrigger, Activity, Posture, CaptureChannel, CapturePayload
 from station.utils import parse_int
 from station import db, config
 import datetime
@@ -28,6 +28,9 @@ def get_device_status(device: int) -> (str, str):
                 trigger_msg = f'TRIGGER={recent_alert.trigger}'
                 if recent_alert.trigger == AlertTrigger.PULSE_THRESHOLD.value: trigger_msg = 'Pulse Alert'
                 if recent_alert.trigger == AlertTrigger.SUDDEN_MOVEMENT.value: trigger_msg = 'Sudden Movement Detected'
+                if recent_alert.trigger == AlertTrigger.IRREGULAR_RHYTHM.value: trigger_msg = 'Irregular Rhythm Detected'
+                if recent_alert.trigger == AlertTrigger.FALL.value: trigger_msg = f'Fall Detected ({recent_alert.value / 10:.1f} g)'
+                if recent_alert.trigger == AlertTrigger.PRONE_STILL.value: trigger_msg = f'Lying Prone, No Movement ({recent_alert.value} s)'
                 return 'CRITICAL', f'Alert: {trigger_msg}'
 
         # 2. Check latest status report
@@ -55,6 +58,8 @@ def get_device_status(device: int) -> (str, str):
             return 'WARNING', f'GPS Failure ({latest_status.bpm} BPM)'
 
         # 5. Check pulse
+        if latest_status.flags & StatusFlags.PULSE_NO_CONTACT:
+            return 'WARNING', 'No Sensor Contact'
         if latest_status.bpm == 0:
             return 'CRITICAL', 'No Pulse Detected'
         if latest_status.bpm < 40 or latest_status.bpm > 190:
@@ -62,6 +67,10 @@ def get_device_status(device: int) -> (str, str):
         if latest_status.bpm > 150:
             return 'WARNING', f'High Pulse ({latest_status.bpm} BPM)'
 
+        # 6. Check SpO2 (0 - not measured)
+        if latest_status.spo2 and latest_status.spo2 < 90:
+            return 'WARNING', f'Low SpO2 ({latest_status.spo2}%)'
+
         # If all checks pass:
         return 'OK', f'Nominal ({latest_status.bpm} BPM)'
 
@@ -177,10 +186,28 @@ def device_detail(device_mac):
             if log.flags & StatusFlags.PULSE_SENSOR_FAILURE: flags_list.append('PULSE FAIL')
             if log.flags & StatusFlags.ACCEL_SENSOR_FAILURE: flags_list.append('ACCEL FAIL')
             if log.flags & StatusFlags.GPS_FAILURE:          flags_list.append('GPS FAIL')
+            if log.flags & StatusFlags.PULSE_NO_CONTACT:     flags_list.append('NO CONTACT')
+            if log.flags & StatusFlags.PULSE_LOW_SIGNAL:     flags_list.append('LOW SIGNAL')
+
+            activity_text = '--'
+
+            if log.activity == Activity.REST.value:    activity_text = 'Rest'
+            if log.activity == Activity.WALK.value:    activity_text = 'Walk'
+            if log.activity == Activity.RUN.value:     activity_text = 'Run'
+            if log.activity == Activity.VEHICLE.value: activity_text = 'Vehicle'
+
+            posture_text = '--'
+
+            if log.posture == Posture.UPRIGHT.value: posture_text = 'Upright'
+            if log.posture == Posture.PRONE.value:   posture_text = 'Prone'
+            if log.posture == Posture.SUPINE.value:  posture_text = 'Supine'
+            if log.posture == Posture.SIDE.value:    posture_text = 'On Side'
 
             status_logs.append({
                 'log': log,
-                'flags_text': ', '.join(flags_list) or 'OK'
+                'flags_text': ', '.join(flags_list) or 'OK',
+                'activity_text': activity_text,
+                'posture_text': posture_text
             })
 
         alert_logs = []
@@ -189,6 +216,9 @@ def device_detail(device_mac):
 
             if log.trigger == AlertTrigger.PULSE_THRESHOLD.value: trigger_text = 'Pulse Threshold'
             if log.trigger == AlertTrigger.SUDDEN_MOVEMENT.value: trigger_text = 'Sudden Movement'
+            if log.trigger == AlertTrigger.IRREGULAR_RHYTHM.value: trigger_text = 'Irregular Rhythm'
+            if log.trigger == AlertTrigger.FALL.value: trigger_text = f'Fall (peak {log.value / 10:.1f} g)'
+            if log.trigger == AlertTrigger.PRONE_STILL.value: trigger_text = f'Prone, No Movement ({log.value} s)'
 
             alert_logs.append({
                 'log': log,
@@ -279,7 +309,7 @@ def api_latest_pulse(device_mac):
     try:
         device = db.Device.get(db.Device.mac == device_mac)
         latest_status = (
-            db.Status.select(db.Status.bpm, db.Status.avg_bpm, db.Status.timestamp)
+            db.Status.select(db.Status.bpm, db.Status.avg_bpm, db.Status.spo2, db.Status.timestamp)
              .where(db.Status.device == device)
              .order_by(db.Status.timestamp.desc())
              .get()
@@ -288,6 +318,7 @@ def api_latest_pulse(device_mac):
         return jsonify({
             'bpm': latest_status.bpm,
             'avg_bpm': latest_status.avg_bpm,
+            'spo2': latest_status.spo2,
             'timestamp': latest_status.timestamp.isoformat()
         })
 
@@ -295,6 +326,83 @@ def api_latest_pulse(device_mac):
         return jsonify({'error': 'no data'}), 404
 
 
+@app.route('/api/device/<int:device_mac>/hrv')
+def api_device_hrv(device_mac):
+    try:
+        device = db.Device.get(db.Device.mac == device_mac)
+
+        # Last hour of reports, that carry HRV (0 - not available yet)
+        query = (
+            db.Status.select(db.Status.rmssd, db.Status.sdnn, db.Status.pnn50, db.Status.timestamp)
+             .where((db.Status.device == device) & (db.Status.sdnn > 0))
+             .order_by(db.Status.timestamp.desc())
+             .limit(720)
+        )
+
+        hrv = []
+        for status in reversed(list(query)):
+            hrv.append({
+                'rmssd': status.rmssd,
+                'sdnn':  status.sdnn,
+                'pnn50': status.pnn50,
+                'ts':    status.timestamp.isoformat()
+            })
+        return jsonify(hrv)
+
+    except Exception:
+        return jsonify({'error': 'device not found'}), 404
+
+
+@app.route('/api/device/<int:device_mac>/capture')
+def api_device_capture(device_mac):
+    try:
+        device = db.Device.get(db.Device.mac == device_mac)
+
+        latest = (
+            db.Capture.select()
+             .where(db.Capture.device == device)
+             .order_by(db.Capture.timestamp.desc())
+             .get()
+        )
+
+        # Capture id wraps around, so blocks are taken from the latest upload only
+        query = (
+            db.Capture.select()
+             .where(
+                (db.Capture.device == device) &
+                (db.Capture.capture == latest.capture) &
+                (db.Capture.timestamp > latest.timestamp - datetime.timedelta(minutes=10))
+             )
+             .order_by(db.Capture.channel, db.Capture.index)
+        )
+
+        channels = {}
+        for block in query:
+            channel = channels.setdefault(CaptureChannel(block.channel).name.lower(), {
+                'rate':    block.rate,
+                'trigger': block.trigger_frame,
+                'count':   block.count,
+                'frames':  []
+            })
+
+            # Missing blocks would shift frames after them, so capture is cut at the first gap
+            if len(channel['frames']) != block.index * (CapturePayload.DELTAS + 1):
+                continue
+
+            deltas = [d - 256 if d > 127 else d for d in bytes(block.deltas)]
+            channel['frames'] += CapturePayload.decode(block.base, block.shift, deltas)
+
+        return jsonify({
+            'id':       latest.capture,
+            'trigger':  AlertTrigger(latest.trigger).name,
+            'ts':       latest.timestamp.isoformat(),
+            'channels': channels
+        })
+
+    except Exception:
+        return jsonify({'error': 'no data'}), 404
+
+
 @app.route('/debug/add_user', methods=['POST'])
 def debug_add_user():
     try:
@@ -331,6 +439,7 @@ def debug_add_status():
             device=device,
             bpm=int(request.form['bpm']),
             avg_bpm=int(request.form['avg_bpm']),
+            spo2=int(request.form.get('spo2') or 0),
             flags=int(request.form['flags'])
         ).save()
         flash(f'Debug: Added Status for MAC {device_mac}')
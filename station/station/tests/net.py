@@ -1,5 +1,6 @@
 from station.radio.packet import Packet
-from station.radio.types import Command, TransportType, ResetReason, AlertTrigger
+from station.radio.payload import StatusPayload, AlertPayload, CapturePayload
+from station.radio.types import Command, TransportType, ResetReason, AlertTrigger, Activity, Posture, CaptureChannel
 from station.radio import Network, create_driver
 from station.config import CONFIG_RADIO_KEY, CONFIG_RADIO_DEFAULT_KEY, CONFIG_DB_FILE_PATH, CONFIG_STATION_MAC
 from station import db
@@ -133,7 +134,14 @@ class RadioPacketTestCase(unittest.TestCase):
             reset_count=8,
             cpu_temp=5,
             bpm=0x42,
-            avg_bpm=0x69
+            avg_bpm=0x69,
+            spo2=97,
+            rmssd=42,
+            sdnn=55,
+            pnn50=18,
+            resp_rate=14,
+            activity=Activity.WALK.value,
+            posture=Posture.PRONE.value
         )
 
         packet_encrypted = packet.to_bytes()
@@ -141,6 +149,27 @@ class RadioPacketTestCase(unittest.TestCase):
         self.assertEqual(packet, packet_decrypted)
 
 
+    def test_deserialize_status_legacy_size(self):
+        payload = StatusPayload.from_bytes(bytes([0, ResetReason.WDG.value, 8, 5, 0x42, 0x69]))
+
+        self.assertEqual(payload.bpm, 0x42)
+        self.assertEqual(payload.avg_bpm, 0x69)
+        self.assertEqual(payload.spo2, 0)
+        self.assertEqual(payload.rmssd, 0)
+
+
+    def test_deserialize_status_without_hrv(self):
+        payload = StatusPayload.from_bytes(bytes([0, ResetReason.WDG.value, 8, 5, 0x42, 0x69, 97]))
+
+        self.assertEqual(payload.spo2, 97)
+        self.assertEqual(payload.rmssd, 0)
+        self.assertEqual(payload.sdnn, 0)
+        self.assertEqual(payload.pnn50, 0)
+        self.assertEqual(payload.resp_rate, 0)
+        self.assertEqual(payload.activity, Activity.UNKNOWN.value)
+        self.assertEqual(payload.posture, Posture.UNKNOWN.value)
+
+
     def test_serialize_deserialize_location(self):
         # Latitude:  N 4943.97313
         # Longitude: E 02340.25276
@@ -171,7 +200,8 @@ class RadioPacketTestCase(unittest.TestCase):
             target=0xDA1BA10B,
             key=CONFIG_RADIO_DEFAULT_KEY,
             # Payload
-            trigger=AlertTrigger.PULSE_THRESHOLD
+            trigger=AlertTrigger.FALL,
+            value=46
         )
 
         packet_encrypted = packet.to_bytes()
@@ -179,6 +209,45 @@ class RadioPacketTestCase(unittest.TestCase):
         self.assertEqual(packet, packet_decrypted)
 
 
+    def test_deserialize_alert_legacy_size(self):
+        payload = AlertPayload.from_bytes(bytes([AlertTrigger.SUDDEN_MOVEMENT.value]))
+
+        self.assertEqual(payload.trigger, AlertTrigger.SUDDEN_MOVEMENT)
+        self.assertEqual(payload.value, 0)
+
+
+    def test_serialize_deserialize_capture(self):
+        packet = Packet.create(
+            command=Command.CAPTURE,
+            transport=TransportType.UNICAST,
+            origin=0xEBAC0C42,
+            target=0xDA1BA10B,
+            key=CONFIG_RADIO_DEFAULT_KEY,
+            # Payload
+            id=3,
+            trigger=AlertTrigger.FALL,
+            channel=CaptureChannel.ACCEL,
+            rate=25,
+            index=5,
+            count=9,
+            trigger_frame=180,
+            base=-1024,
+            shift=2,
+            deltas=[(-1) ** i * i for i in range(31)]
+        )
+
+        packet_encrypted = packet.to_bytes()
+        packet_decrypted = Packet.from_bytes(packet_encrypted, CONFIG_RADIO_DEFAULT_KEY)
+        self.assertEqual(packet, packet_decrypted)
+
+
+    def test_capture_decode(self):
+        frames = CapturePayload.decode(100, 1, [1, -2, 127, -128] + [0] * 27)
+
+        self.assertEqual(len(frames), 32)
+        self.assertEqual(frames[:5], [100, 102, 98, 352, 96])
+
+
 
 class RadioNetworkTestCase(unittest.TestCase):
     def setUp(self):
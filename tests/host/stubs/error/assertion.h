@@ -0,0 +1,21 @@
+/** ========================================================================= *
+ *
+ * @file assertion.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Host build shim for SDK assertions
+ *
+ *  ========================================================================= */
+#pragma once
+
+/* Includes ================================================================= */
+#include "error/error.h"
+
+/* Macros =================================================================== */
+#define ASSERT_RETURN(__cond, __ret)                                          \
+  do {                                                                        \
+    if (!(__cond)) {                                                          \
+      return __ret;                                                           \
+    }                                                                         \
+  } while (0)
@@ -0,0 +1,56 @@
+/** ========================================================================= *
+ *
+ * @file error.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Host build shim for SDK error codes (only what sources under test use)
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Defines ================================================================== */
+#ifndef __STATIC_INLINE
+#define __STATIC_INLINE static inline
+#endif
+
+/* Macros =================================================================== */
+#define ERROR_CHECK_RETURN(__expr)                                            \
+  do {                                                                        \
+    error_t __err = (__expr);                                                 \
+    if (__err != E_OK) {                                                      \
+      return __err;                                                           \
+    }                                                                         \
+  } while (0)
+
+/* Enums ==================================================================== */
+typedef enum {
+  E_OK = 0,
+  E_FAILED,
+  E_NULL,
+  E_AGAIN,
+  E_OUTOFBOUNDS,
+  E_INVAL,
+  E_EMPTY,
+  E_UNDERFLOW,
+  E_OVERFLOW,
+  E_CORRUPT,
+  E_TIMEOUT,
+  E_NOMEM,
+  E_BUSY,
+  E_NOTIMPL,
+} error_t;
+
+#ifdef __cplusplus
+}
+#endif
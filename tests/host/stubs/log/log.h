@@ -0,0 +1,18 @@
+/** ========================================================================= *
+ *
+ * @file log.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Host build shim for SDK log, module logs are dropped, so test
+ *        output only has test results
+ *
+ *  ========================================================================= */
+#pragma once
+
+/* Macros =================================================================== */
+#define log_printf(...) ((void) 0)
+#define log_debug(...)  ((void) 0)
+#define log_info(...)   ((void) 0)
+#define log_warn(...)   ((void) 0)
+#define log_error(...)  ((void) 0)
@@ -0,0 +1,19 @@
+/** ========================================================================= *
+ *
+ * @file max3010x.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Host build shim for SDK MAX3010x driver (sample type only)
+ *
+ *  ========================================================================= */
+#pragma once
+
+/* Includes ================================================================= */
+#include <stdint.h>
+
+/* Types ==================================================================== */
+typedef struct {
+  uint32_t ir;
+  uint32_t red;
+} max3010x_sample_t;
@@ -0,0 +1,16 @@
+/** ========================================================================= *
+ *
+ * @file time.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Host build shim for SDK time (sources under test don't read the clock)
+ *
+ *  ========================================================================= */
+#pragma once
+
+/* Includes ================================================================= */
+#include <stdint.h>
+
+/* Types ==================================================================== */
+typedef uint32_t milliseconds_t;
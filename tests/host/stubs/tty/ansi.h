@@ -0,0 +1,14 @@
+/** ========================================================================= *
+ *
+ * @file ansi.h
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Host build shim for SDK ANSI escape sequences
+ *
+ *  ========================================================================= */
+#pragma once
+
+/* Macros =================================================================== */
+#define ANSI_ERASE_LINE            ""
+#define ANSI_CURSOR_MOVE_UP(__n)   ""
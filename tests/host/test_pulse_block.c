@@ -0,0 +1,587 @@
+/** ========================================================================= *
+ *
+ * @file test_pulse_block.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Pulse pipeline checks on a fixed synthetic PPG trace:
+ *        1. Frozen reference - trace is run through a copy of the original
+ *           per-sample pipeline (LPF, DC, Gauss, WMA & slope detector, as it
+ *           was before block processing) & through pulse_process_block. Beats
+ *           & BPM are compared with the differences, that were made on purpose
+ *           (see run_reference)
+ *        2. Batching - pulse_process_sample (block of 1) & pulse_process_block
+ *           in FIFO batches of varying size have to detect beats on the same
+ *           samples & end up in the same detector state
+ *
+ * @note Only peak engine is checked - autocorrelation engine re-estimates
+ *       interval once per block by design, so its output depends on batching
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/pulse/pulse.h"
+#include "sensors/pulse/pulse_engine.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Defines ================================================================== */
+/** Trace length (2 minutes) */
+#define TRACE_SAMPLES (120 * PULSE_SAMPLE_RATE_HZ)
+
+/** Raw threshold & DC filter init shift, as used by app */
+#define TRACE_RAW_THRESHOLD 20000
+#define TRACE_DCF_SHIFT     500
+
+/** Trace levels (raw ADC) */
+#define TRACE_DC        30000
+#define TRACE_AMPLITUDE 1400
+#define TRACE_RESP      200
+#define TRACE_NOISE     20
+
+/** Contact is lost for 2s in the middle of the trace */
+#define TRACE_GAP_START (60 * PULSE_SAMPLE_RATE_HZ)
+#define TRACE_GAP_END   (62 * PULSE_SAMPLE_RATE_HZ)
+
+/** Heart rate steps (see trace_build) */
+#define TRACE_STEPS        4
+#define TRACE_STEP_SAMPLES (TRACE_SAMPLES / TRACE_STEPS)
+
+/** Largest FIFO batch */
+#define TRACE_MAX_BLOCK 32
+
+/**
+ * Frozen reference pipeline config, as it was (fixed 100Hz constants). Time
+ * of each sample is taken from a fake runtime, that ticks with sample period
+ * (best case for the original wall clock timing)
+ */
+#if PULSE_SAMPLE_RATE_HZ != 100
+#error "Frozen reference is the original 100Hz pipeline"
+#endif
+
+#define REF_SAMPLE_PERIOD_MS    10
+#define REF_TIME_BASE           1000
+#define REF_APPROX_SAMPLES      32
+#define REF_LPF_ALPHA           16
+#define REF_GAUSS_WINDOW_SIZE   5
+#define REF_GAUSS_FACTOR        256
+#define REF_WMA_BUFFER_SIZE     32
+#define REF_FILTERED_MIN        210
+#define REF_FILTERED_MAX        260
+#define REF_MIN_BEAT_TIME_DELTA 250
+#define REF_MAX_BEAT_TIME_DELTA 1200
+
+/**
+ * Beat position difference (samples, block path minus reference). Centred
+ * Gauss kernel delays signal by 2 samples, original one (heaviest weight on
+ * the newest sample) by ~1.6, so beats are found on the same or next sample
+ */
+#define REF_MIN_OFFSET 0
+#define REF_MAX_OFFSET 1
+
+/**
+ * Beats of either path without a match. Filtered peaks, that end up right
+ * at PULSE_FILTERED_MIN/MAX_THRESHOLD, may fall either way with different
+ * kernels (e.g. during DC filter warm-up, when peaks are clipped above the
+ * window & slope is only caught on the way down)
+ */
+#define REF_MAX_UNMATCHED 2
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Frozen reference detector context (original pulse_t)
+ */
+typedef struct {
+  milliseconds_t last_process_timestamp;
+
+  struct {
+    enum {
+      REF_STATE_IDLE = 0,
+      REF_STATE_SLOPE_UP,
+      REF_STATE_SLOPE_PEAK,
+      REF_STATE_COOLDOWN,
+    } state;
+    uint32_t       prev;
+    uint32_t       raw_threshold;
+    milliseconds_t last_beat_timestamp;
+  } detect;
+
+  struct {
+    uint32_t beats[REF_APPROX_SAMPLES];
+    uint32_t index;
+  } approx;
+
+  struct {
+    struct {
+      int32_t y;
+    } lpf;
+    struct {
+      int32_t baseline;
+    } dc;
+    struct {
+      int32_t  buffer[REF_GAUSS_WINDOW_SIZE];
+      uint32_t index;
+    } gauss;
+    struct {
+      int32_t  buffer[REF_WMA_BUFFER_SIZE];
+      uint32_t index;
+      int32_t  weights[REF_WMA_BUFFER_SIZE];
+      int32_t  weights_sum;
+    } wma;
+  } filter;
+} ref_pulse_t;
+
+/* Variables ================================================================ */
+static max3010x_sample_t trace[TRACE_SAMPLES];
+
+/** Original Gauss kernel */
+static const int32_t ref_gauss_coefficients[REF_GAUSS_WINDOW_SIZE] = {16, 64, 96, 64, 16};
+
+/** Fake runtime of the reference pipeline (ms) */
+static milliseconds_t ref_now;
+
+static ref_pulse_t ctx_ref;
+static uint32_t    beats_ref[TRACE_SAMPLES];
+
+/** Beat sample indexes, as detected by each path */
+static uint32_t beats_sample[TRACE_SAMPLES];
+static uint32_t beats_block[TRACE_SAMPLES];
+
+/** Contexts are large, so they are static */
+static pulse_t ctx_sample;
+static pulse_t ctx_block;
+
+static uint32_t rng = 1;
+
+/* Private functions ======================================================== */
+static uint32_t rand_next(uint32_t range) {
+  rng = rng * 1103515245 + 12345;
+  return (rng >> 16) % range;
+}
+
+/**
+ * Build trace: beats with fast rise & slow decay (heart rate steps through
+ * 60, 72, 90 & 120 BPM), slow respiration triangle & uniform noise
+ */
+static void trace_build(void) {
+  static const uint32_t bpm[] = {60, 72, 90, 120};
+
+  uint32_t phase = 0; // Beat phase (Q16)
+
+  for (uint32_t n = 0; n < TRACE_SAMPLES; ++n) {
+    if (n >= TRACE_GAP_START && n < TRACE_GAP_END) {
+      trace[n].ir = TRACE_RAW_THRESHOLD / 2;
+      continue;
+    }
+
+    phase += (bpm[n * 4 / TRACE_SAMPLES] << 16) / (60 * PULSE_SAMPLE_RATE_HZ);
+    phase &= 0xFFFF;
+
+    // Rise over 25% of beat, decay over the rest
+    int32_t pulse = phase < 0x4000
+      ? (int32_t) (phase * TRACE_AMPLITUDE / 0x4000)
+      : (int32_t) ((0x10000 - phase) * TRACE_AMPLITUDE / 0xC000);
+
+    // Respiration (0.25Hz triangle)
+    uint32_t resp_phase = n % (4 * PULSE_SAMPLE_RATE_HZ);
+    int32_t  resp       = resp_phase < 2 * PULSE_SAMPLE_RATE_HZ
+      ? (int32_t) resp_phase * TRACE_RESP / (2 * PULSE_SAMPLE_RATE_HZ)
+      : (int32_t) (4 * PULSE_SAMPLE_RATE_HZ - resp_phase) * TRACE_RESP / (2 * PULSE_SAMPLE_RATE_HZ);
+
+    int32_t noise = (int32_t) rand_next(2 * TRACE_NOISE + 1) - TRACE_NOISE;
+
+    trace[n].ir  = TRACE_DC + pulse + resp + noise;
+    trace[n].red = trace[n].ir;
+  }
+}
+
+/* Frozen reference (original per-sample pipeline, logs dropped) */
+static int32_t ref_low_pass_filter(ref_pulse_t * pulse, int32_t value) {
+  pulse->filter.lpf.y = pulse->filter.lpf.y + ((REF_LPF_ALPHA * ((value << 8) - pulse->filter.lpf.y)) >> 8);
+  return pulse->filter.lpf.y >> 8;
+}
+
+static int32_t ref_dc_filter(ref_pulse_t * pulse, int32_t value) {
+  int32_t filtered = value - pulse->filter.dc.baseline;
+
+  pulse->filter.dc.baseline += (value - pulse->filter.dc.baseline) >> 8;
+
+  return filtered;
+}
+
+static int32_t ref_gauss_filter(ref_pulse_t * pulse, int32_t value) {
+  int32_t acc = 0;
+  int32_t idx = 0;
+
+  pulse->filter.gauss.buffer[pulse->filter.gauss.index] = value;
+
+  for (int32_t i = -2; i <= 2; ++i) {
+    uint32_t buf_idx = (pulse->filter.gauss.index + i + REF_GAUSS_WINDOW_SIZE) % REF_GAUSS_WINDOW_SIZE;
+    acc += pulse->filter.gauss.buffer[buf_idx] * ref_gauss_coefficients[idx++];
+  }
+
+  pulse->filter.gauss.index = (pulse->filter.gauss.index + 1) % REF_GAUSS_WINDOW_SIZE;
+
+  return acc / REF_GAUSS_FACTOR;
+}
+
+static int32_t ref_weighted_moving_average(ref_pulse_t * pulse, int32_t value) {
+  pulse->filter.wma.buffer[pulse->filter.wma.index] = value;
+  pulse->filter.wma.index = (pulse->filter.wma.index + 1) % REF_WMA_BUFFER_SIZE;
+
+  int32_t wma       = 0;
+  int32_t wma_index = pulse->filter.wma.index;
+  for (uint32_t i = 0; i < REF_WMA_BUFFER_SIZE; ++i) {
+    wma += pulse->filter.wma.buffer[wma_index] * pulse->filter.wma.weights[i];
+
+    wma_index = (wma_index + 1) % REF_WMA_BUFFER_SIZE;
+  }
+  wma /= pulse->filter.wma.weights_sum;
+
+  return wma;
+}
+
+static void ref_pulse_detected(ref_pulse_t * pulse) {
+  if (!pulse->detect.last_beat_timestamp) {
+    pulse->detect.last_beat_timestamp = pulse->last_process_timestamp;
+  }
+
+  uint32_t dt = ref_now - pulse->detect.last_beat_timestamp;
+
+  pulse->approx.beats[pulse->approx.index] = dt < REF_MAX_BEAT_TIME_DELTA ? dt : REF_MAX_BEAT_TIME_DELTA;
+  pulse->approx.index = (pulse->approx.index + 1) % REF_APPROX_SAMPLES;
+
+  pulse->detect.last_beat_timestamp = ref_now;
+}
+
+static void ref_pulse_init(ref_pulse_t * pulse, int32_t raw_threshold, int32_t dcf_init_shift) {
+  memset(pulse, 0, sizeof(ref_pulse_t));
+
+  pulse->detect.raw_threshold = raw_threshold;
+  pulse->filter.dc.baseline   = raw_threshold - dcf_init_shift;
+
+  for (int32_t w = 0; w < REF_WMA_BUFFER_SIZE; ++w) {
+    pulse->filter.wma.weights[REF_WMA_BUFFER_SIZE - w - 1] = w;
+    pulse->filter.wma.weights_sum += w;
+  }
+}
+
+static error_t ref_pulse_process_sample(ref_pulse_t * pulse, int32_t sample) {
+  error_t err      = E_AGAIN;
+  int32_t filtered = 0;
+
+  if (!pulse->last_process_timestamp) {
+    pulse->last_process_timestamp = ref_now - 300;
+  }
+
+  // Raw threshold is unsigned there, as it was
+  if (sample < (int32_t) pulse->detect.raw_threshold) {
+    err = E_OUTOFBOUNDS;
+    goto exit;
+  }
+
+  int32_t lpf_res   = ref_low_pass_filter(pulse, sample);
+  int32_t dcf_res   = ref_dc_filter(pulse, lpf_res);
+  int32_t gauss_res = ref_gauss_filter(pulse, dcf_res);
+  filtered          = ref_weighted_moving_average(pulse, gauss_res);
+
+  if (filtered > REF_FILTERED_MAX) {
+    err = E_OUTOFBOUNDS;
+    goto exit;
+  }
+
+  // Signed filtered value is compared with unsigned previous one, as it was
+  switch (pulse->detect.state) {
+    case REF_STATE_IDLE: {
+      if (filtered > REF_FILTERED_MIN && (uint32_t) filtered > pulse->detect.prev) {
+        pulse->detect.state = REF_STATE_SLOPE_UP;
+      }
+      break;
+    }
+
+    case REF_STATE_SLOPE_UP: {
+      if ((uint32_t) filtered < pulse->detect.prev) {
+        pulse->detect.state = REF_STATE_SLOPE_PEAK;
+      }
+      break;
+    }
+
+    case REF_STATE_SLOPE_PEAK: {
+      if ((uint32_t) filtered < pulse->detect.prev) {
+        ref_pulse_detected(pulse);
+        pulse->detect.state = REF_STATE_COOLDOWN;
+        err = E_OK;
+      } else {
+        pulse->detect.state = REF_STATE_SLOPE_UP;
+      }
+      break;
+    }
+
+    case REF_STATE_COOLDOWN: {
+      // Always true - cooldown lasted a single sample
+      if (ref_now + REF_MIN_BEAT_TIME_DELTA > pulse->detect.last_beat_timestamp) {
+        pulse->detect.state = REF_STATE_IDLE;
+      }
+      break;
+    }
+
+    default: {
+      break;
+    }
+  }
+
+exit:
+  // Out of bounds raw sample stored stale filtered value there, it's 0 here
+  pulse->detect.prev = filtered;
+  pulse->last_process_timestamp = ref_now;
+
+  return err;
+}
+
+static uint32_t ref_pulse_approximate_bpm(ref_pulse_t * pulse) {
+  uint32_t avg_beat_time = 0;
+  uint32_t beat_count    = 0;
+
+  for (uint32_t i = 0; i < REF_APPROX_SAMPLES; ++i) {
+    if (pulse->approx.beats[i]) {
+      avg_beat_time += pulse->approx.beats[i];
+      beat_count++;
+    }
+  }
+
+  if (!beat_count) {
+    return 0;
+  }
+
+  avg_beat_time /= beat_count;
+
+  return 60 * (1000000 / avg_beat_time) / 1000;
+}
+
+/**
+ * Count beats of one path, that have no beat of the other one at
+ * [offset_min, offset_max] samples from them. Both lists are ascending
+ */
+static uint32_t beats_unmatched(
+  const uint32_t * beats, uint32_t count, const uint32_t * other, uint32_t other_count,
+  int32_t offset_min, int32_t offset_max
+) {
+  uint32_t unmatched = 0;
+  uint32_t j         = 0;
+
+  for (uint32_t i = 0; i < count; ++i) {
+    while (j < other_count && (int32_t) (other[j] - beats[i]) < offset_min) {
+      j++;
+    }
+
+    if (j == other_count || (int32_t) (other[j] - beats[i]) > offset_max) {
+      unmatched++;
+    }
+  }
+
+  return unmatched;
+}
+
+/**
+ * Run trace through frozen reference & block path & compare them. Expected
+ * differences (on purpose):
+ *  - Beat position: REF_MIN_OFFSET..REF_MAX_OFFSET samples (centred Gauss)
+ *  - First step (60 BPM): block path reports no BPM - median needs a full
+ *    approximation buffer (32 intervals, there are 29). Original averaged
+ *    whatever there was, including a bogus first interval of one sample
+ *  - Steady steps (72 & 90 BPM): BPM within 1
+ *  - Last step (120 BPM): some filtered peaks fall out of fixed amplitude
+ *    window, so both paths miss beats. Doubled intervals drag average of
+ *    the original down, median is closer to the true rate
+ *  - Original cooldown ended after one sample, block path waits for
+ *    PULSE_MIN_BEAT_SAMPLES (trace has no double peaks, so beats agree)
+ *
+ * @return Number of failed checks
+ */
+static int run_reference(void) {
+  static const uint32_t bpm_true[TRACE_STEPS] = {60, 72, 90, 120};
+
+  uint32_t count_ref   = 0;
+  uint32_t count_block = 0;
+  int      failed      = 0;
+
+  ref_pulse_init(&ctx_ref, TRACE_RAW_THRESHOLD, TRACE_DCF_SHIFT);
+  pulse_init(&ctx_block, TRACE_RAW_THRESHOLD, TRACE_DCF_SHIFT);
+  pulse_set_engine(&ctx_block, &pulse_engine_peak);
+
+  for (uint32_t step = 0; step < TRACE_STEPS; ++step) {
+    uint32_t end = (step + 1) * TRACE_STEP_SAMPLES;
+
+    for (uint32_t n = step * TRACE_STEP_SAMPLES; n < end; ++n) {
+      ref_now = REF_TIME_BASE + n * REF_SAMPLE_PERIOD_MS;
+
+      if (ref_pulse_process_sample(&ctx_ref, (int32_t) trace[n].ir) == E_OK) {
+        beats_ref[count_ref++] = n;
+      }
+    }
+
+    for (uint32_t n = step * TRACE_STEP_SAMPLES; n < end;) {
+      size_t size = end - n < TRACE_MAX_BLOCK ? end - n : TRACE_MAX_BLOCK;
+
+      pulse_beats_t beats = {0};
+      pulse_process_block(&ctx_block, &trace[n], size, &beats);
+
+      for (uint8_t i = 0; i < beats.count; ++i) {
+        beats_block[count_block++] = n + beats.position[i];
+      }
+
+      n += size;
+    }
+
+    uint32_t bpm_ref   = ref_pulse_approximate_bpm(&ctx_ref);
+    uint32_t bpm_block = 0;
+    error_t  err       = pulse_approximate_bpm(&ctx_block, &bpm_block);
+
+    printf("reference: %u BPM step, bpm reference=%u block=%u (%d)\n",
+      bpm_true[step], bpm_ref, bpm_block, err
+    );
+
+    uint32_t dist_ref   = bpm_ref > bpm_true[step] ? bpm_ref - bpm_true[step] : bpm_true[step] - bpm_ref;
+    uint32_t dist_block = bpm_block > bpm_true[step] ? bpm_block - bpm_true[step] : bpm_true[step] - bpm_block;
+
+    bool ok = false;
+
+    switch (step) {
+      case 0:
+        ok = err == E_AGAIN;
+        break;
+      case TRACE_STEPS - 1:
+        ok = err == E_OK && dist_block < dist_ref;
+        break;
+      default:
+        ok = err == E_OK && (bpm_ref > bpm_block ? bpm_ref - bpm_block : bpm_block - bpm_ref) <= 1;
+        break;
+    }
+
+    if (!ok) {
+      printf("reference: unexpected bpm difference on %u BPM step\n", bpm_true[step]);
+      failed++;
+    }
+  }
+
+  uint32_t unmatched_ref   = beats_unmatched(beats_ref, count_ref, beats_block, count_block, REF_MIN_OFFSET, REF_MAX_OFFSET);
+  uint32_t unmatched_block = beats_unmatched(beats_block, count_block, beats_ref, count_ref, -REF_MAX_OFFSET, -REF_MIN_OFFSET);
+
+  printf("reference: beats reference=%u block=%u, unmatched reference=%u block=%u\n",
+    count_ref, count_block, unmatched_ref, unmatched_block
+  );
+
+  if (unmatched_ref > REF_MAX_UNMATCHED || unmatched_block > REF_MAX_UNMATCHED) {
+    printf("reference: beats differ\n");
+    failed++;
+  }
+
+  if (count_ref < 100) {
+    printf("reference: too few beats detected\n");
+    failed++;
+  }
+
+  return failed;
+}
+
+/**
+ * Run trace through pulse_process_sample & pulse_process_block in batches
+ * of varying size & compare them. Per-sample call is a block of one, so this
+ * shows, that results don't depend on FIFO batch size
+ *
+ * @return Number of failed checks
+ */
+static int run_batching(void) {
+  const pulse_engine_t * engine = &pulse_engine_peak;
+
+  uint32_t count_sample = 0;
+  uint32_t count_block  = 0;
+  int      failed       = 0;
+
+  pulse_init(&ctx_sample, TRACE_RAW_THRESHOLD, TRACE_DCF_SHIFT);
+  pulse_init(&ctx_block, TRACE_RAW_THRESHOLD, TRACE_DCF_SHIFT);
+  pulse_set_engine(&ctx_sample, engine);
+  pulse_set_engine(&ctx_block, engine);
+
+  for (uint32_t n = 0; n < TRACE_SAMPLES; ++n) {
+    if (pulse_process_sample(&ctx_sample, (int32_t) trace[n].ir) == E_OK) {
+      beats_sample[count_sample++] = n;
+    }
+  }
+
+  rng = 2;
+
+  for (uint32_t n = 0; n < TRACE_SAMPLES;) {
+    size_t size = 1 + rand_next(TRACE_MAX_BLOCK);
+
+    size = n + size > TRACE_SAMPLES ? TRACE_SAMPLES - n : size;
+
+    pulse_beats_t beats = {0};
+    error_t       err   = pulse_process_block(&ctx_block, &trace[n], size, &beats);
+
+    if ((err == E_OK) != (beats.count > 0)) {
+      printf("%s: block at %u returned %d with %u beats\n", engine->name, n, err, beats.count);
+      failed++;
+    }
+
+    for (uint8_t i = 0; i < beats.count; ++i) {
+      beats_block[count_block++] = n + beats.position[i];
+    }
+
+    n += size;
+  }
+
+  uint32_t bpm_sample = 0;
+  uint32_t bpm_block  = 0;
+
+  error_t err_sample = pulse_approximate_bpm(&ctx_sample, &bpm_sample);
+  error_t err_block  = pulse_approximate_bpm(&ctx_block, &bpm_block);
+
+  printf("%s: beats sample=%u block=%u, bpm sample=%u block=%u\n",
+    engine->name, count_sample, count_block, bpm_sample, bpm_block
+  );
+
+  if (count_sample != count_block || memcmp(beats_sample, beats_block, count_sample * sizeof(uint32_t))) {
+    printf("%s: beats differ\n", engine->name);
+    failed++;
+  }
+
+  if (err_sample != err_block || bpm_sample != bpm_block) {
+    printf("%s: bpm differs\n", engine->name);
+    failed++;
+  }
+
+  // Whole detector state (filters, engine, approximation buffer, HRV, ...)
+  if (memcmp(&ctx_sample, &ctx_block, sizeof(pulse_t))) {
+    printf("%s: final state differs\n", engine->name);
+    failed++;
+  }
+
+  // Trace has to exercise detection, otherwise equivalence is meaningless
+  if (count_sample < 100) {
+    printf("%s: too few beats detected\n", engine->name);
+    failed++;
+  }
+
+  if (err_sample != E_OK) {
+    printf("%s: no bpm estimate\n", engine->name);
+    failed++;
+  }
+
+  return failed;
+}
+
+/* Shared functions ========================================================= */
+int main(void) {
+  trace_build();
+
+  int failed = run_reference();
+
+  failed += run_batching();
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+/** ========================================================================= *
+ *
+ * @file test_pulse_brady.c
+ * @date 17-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Bradycardia check on a synthetic PPG trace (45, 42 & 36 BPM). Slow
+ *        beat intervals have to be accepted, so BPM is estimated & low heart
+ *        rate alert (as app checks it) fires once rate drops below threshold
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "sensors/pulse/pulse.h"
+#include "sensors/pulse/pulse_engine.h"
+#include <stdio.h>
+
+/* Defines ================================================================== */
+/** Heart rate steps & their length (75s each) */
+#define TRACE_STEPS        3
+#define TRACE_STEP_SAMPLES (75 * PULSE_SAMPLE_RATE_HZ)
+#define TRACE_SAMPLES      (TRACE_STEPS * TRACE_STEP_SAMPLES)
+
+/** Raw threshold & DC filter init shift, as used by app */
+#define TRACE_RAW_THRESHOLD 20000
+#define TRACE_DCF_SHIFT     500
+
+/** Trace levels (raw ADC) */
+#define TRACE_DC        30000
+#define TRACE_AMPLITUDE 1400
+#define TRACE_RESP      200
+#define TRACE_NOISE     20
+
+/** FIFO batch, as app reads it */
+#define TRACE_BLOCK 32
+
+/** Low heart rate alert threshold, as in app.h */
+#define ALERT_MIN_BPM 40
+
+/** Max difference of estimated BPM at the end of each step */
+#define BPM_TOLERANCE 2
+
+/* Variables ================================================================ */
+static max3010x_sample_t trace[TRACE_SAMPLES];
+
+/** Heart rate of each step */
+static const uint32_t trace_bpm[TRACE_STEPS] = {45, 42, 36};
+
+/** Context is large, so it's static */
+static pulse_t ctx;
+
+static uint32_t rng = 1;
+
+/* Private functions ======================================================== */
+static uint32_t rand_next(uint32_t range) {
+  rng = rng * 1103515245 + 12345;
+  return (rng >> 16) % range;
+}
+
+/**
+ * Build trace: beats with fast rise & slow decay, slow respiration triangle
+ * & uniform noise
+ */
+static void trace_build(void) {
+  uint32_t phase = 0; // Beat phase (Q16)
+
+  for (uint32_t n = 0; n < TRACE_SAMPLES; ++n) {
+    phase += (trace_bpm[n / TRACE_STEP_SAMPLES] << 16) / (60 * PULSE_SAMPLE_RATE_HZ);
+    phase &= 0xFFFF;
+
+    // Rise over 25% of beat, decay over the rest
+    int32_t pulse = phase < 0x4000
+      ? (int32_t) (phase * TRACE_AMPLITUDE / 0x4000)
+      : (int32_t) ((0x10000 - phase) * TRACE_AMPLITUDE / 0xC000);
+
+    // Respiration (0.25Hz triangle)
+    uint32_t resp_phase = n % (4 * PULSE_SAMPLE_RATE_HZ);
+    int32_t  resp       = resp_phase < 2 * PULSE_SAMPLE_RATE_HZ
+      ? (int32_t) resp_phase * TRACE_RESP / (2 * PULSE_SAMPLE_RATE_HZ)
+      : (int32_t) (4 * PULSE_SAMPLE_RATE_HZ - resp_phase) * TRACE_RESP / (2 * PULSE_SAMPLE_RATE_HZ);
+
+    int32_t noise = (int32_t) rand_next(2 * TRACE_NOISE + 1) - TRACE_NOISE;
+
+    trace[n].ir  = TRACE_DC + pulse + resp + noise;
+    trace[n].red = trace[n].ir;
+  }
+}
+
+/* Shared functions ========================================================= */
+int main(void) {
+  int failed = 0;
+
+  trace_build();
+
+  pulse_init(&ctx, TRACE_RAW_THRESHOLD, TRACE_DCF_SHIFT);
+  pulse_set_engine(&ctx, &pulse_engine_peak);
+
+  for (uint32_t step = 0; step < TRACE_STEPS; ++step) {
+    uint32_t alerts = 0;
+    uint32_t bpm    = 0;
+    error_t  err    = E_AGAIN;
+
+    uint32_t end = (step + 1) * TRACE_STEP_SAMPLES;
+
+    for (uint32_t n = step * TRACE_STEP_SAMPLES; n < end; n += TRACE_BLOCK) {
+      size_t size = end - n < TRACE_BLOCK ? end - n : TRACE_BLOCK;
+
+      // Alert is checked after each block with beats, as app does
+      if (pulse_process_block(&ctx, &trace[n], size, NULL) != E_OK) {
+        continue;
+      }
+
+      err = pulse_approximate_bpm(&ctx, &bpm);
+
+      if (err == E_OK && bpm < ALERT_MIN_BPM) {
+        alerts++;
+      }
+    }
+
+    printf("brady: %u BPM step, bpm=%u (%d), alerts=%u\n", trace_bpm[step], bpm, err, alerts);
+
+    uint32_t dist = bpm > trace_bpm[step] ? bpm - trace_bpm[step] : trace_bpm[step] - bpm;
+
+    if (err != E_OK || dist > BPM_TOLERANCE) {
+      printf("brady: bpm isn't estimated on %u BPM step\n", trace_bpm[step]);
+      failed++;
+    }
+
+    if ((trace_bpm[step] < ALERT_MIN_BPM) != (alerts > 0)) {
+      printf("brady: unexpected alerts on %u BPM step\n", trace_bpm[step]);
+      failed++;
+    }
+  }
+
+  printf("%s\n", failed ? "FAILED" : "PASSED");
+
+  return failed ? 1 : 0;
+}